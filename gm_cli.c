@@ -11,6 +11,78 @@
 **                                                             <Tom Free 付瑞彪>
 **           2021-06-17 -> 增加自动命令注册和静态注册选项
 **                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出通道链和管道过滤功能
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出重定向到文件功能
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 输入行改为间隙缓存，行长度和历史记录空间可运行时配置
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加括号粘贴模式和批量输出回调
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加非交互执行接口和二进制帧协议模式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加结构化输出接口，支持文本、JSON和CBOR格式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加幂等命令输出缓存
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加后台处理接口和基于时间轮的周期命令watch
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令查找哈希索引、运行时别名、参数引号和会话保存恢复
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加紧凑位宽和无缓存的精简格式化打印，初始化不再清空缓存
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内部跟踪环形缓存和trace命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 找不到命令时按BK树提示相近的命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加线程安全的后台日志接口，日志批量输出后重绘输入行
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出调度，回显优先于命令输出，Ctrl-C丢弃未发送的输出
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加会话录制，输入和终端输出带时间戳写入二进制记录
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令执行时间预算、协作式中止和wdog命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加批量并行执行，连续的可重入命令在线程池中执行
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加变量和set、unset命令，命令行编译为模板后按段展开
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加循环命令repeat和for，输出执行速率和命令耗时统计
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令插件，索引双份重建后切换，卸载时等待宽限期
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加共享内存控制通道，命令输出直接写入应答缓存
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内存命令md、mw和mcmp，查表格式化整行，大范围分块输出
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加call命令，按排序的符号表二分查找函数，调用并计时
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加中断中使用的gm_cli_log_str
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 修正光标在行中间时上翻历史残留行尾
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 启动输出和第一个提示符作为交互输出
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_stop，退出时关闭括号粘贴模式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 格式选项只对带EMIT标志的命令在末尾解析，嵌套超限报错
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 会话记录增加后台处理记录，回放按记录执行后台处理
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_peek_char判断Ctrl-C，执行状态改用原子操作
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 修复批量执行的命令不计预算、无法中止的问题，增加GM_CLI_CMD_EXPORT_EX_BUDGET
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 变量改为分割参数后按参数替换，变量值不会形成引号、管道或重定向
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 会话保存改由GM_CLI_SESSION_EN控制
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 超过预算的命令名复制保存，插件卸载后wdog不再访问已卸载的内存
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 输出缓存键以'\0'分隔参数，带空格的参数和多个参数不再使用同一缓存
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 精简格式化支持ll修饰，%p按uintptr_t输出，不支持的转换停止解析参数
+**                                                             <Tom Free 付瑞彪>
 **
 **              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
 **
@@ -18,10 +90,235 @@
 *******************************************************************************/
 
 #include "gm_cli.h"
+
+/* 共享内存控制通道使用的shm_open、syscall等在严格C99下不声明，在系统头文件之前打开 */
+#if GM_CLI_SHM_EN && !defined (_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "string.h"
 #include "stdio.h"
 #include "stdarg.h"
 #include "stdlib.h"
+#include "ctype.h"
+
+/* 输出重定向依赖POSIX文件接口，仅Linux下可用 */
+#if GM_CLI_REDIRECT_EN && defined (__linux__)
+#define GM_CLI_REDIRECT_SUPPORT     1
+#include "unistd.h"
+#include "fcntl.h"
+#else
+#define GM_CLI_REDIRECT_SUPPORT     0
+#endif
+
+/* 批量并行执行依赖POSIX线程和线程局部变量 */
+#if GM_CLI_BATCH_EN
+#if !defined (__GNUC__) && !defined (__clang__)
+#error "GM_CLI_BATCH_EN requires GCC or Clang with POSIX threads"
+#endif
+#if (GM_CLI_BATCH_THREAD_MAX < 1) || (GM_CLI_BATCH_WINDOW < 1)
+#error "GM_CLI_BATCH_THREAD_MAX and GM_CLI_BATCH_WINDOW must be at least 1"
+#endif
+#include "pthread.h"
+#endif  /* GM_CLI_BATCH_EN */
+
+/* 命令插件依赖dlopen、线程局部变量和编译器的原子操作 */
+#if GM_CLI_PLUGIN_EN
+#if !defined (__linux__) || (!defined (__GNUC__) && !defined (__clang__))
+#error "GM_CLI_PLUGIN_EN requires Linux and GCC or Clang"
+#endif
+#include "dlfcn.h"
+#include "sched.h"
+#endif  /* GM_CLI_PLUGIN_EN */
+
+/* 共享内存控制通道依赖POSIX共享内存、futex和编译器的原子操作 */
+#if GM_CLI_SHM_EN
+#if !defined (__linux__) || (!defined (__GNUC__) && !defined (__clang__))
+#error "GM_CLI_SHM_EN requires Linux and GCC or Clang"
+#endif
+#if (GM_CLI_SHM_SIZE & (GM_CLI_SHM_SIZE - 1)) || (GM_CLI_SHM_OUT_MAX + 16 > GM_CLI_SHM_SIZE / 2) || \
+    (GM_CLI_LINE_CHAR_MAX + 16 > GM_CLI_SHM_SIZE / 2)
+#error "GM_CLI_SHM_SIZE must be a power of 2 and hold two records of GM_CLI_SHM_OUT_MAX"
+#endif
+#include "gm_cli_shm.h"
+#endif  /* GM_CLI_SHM_EN */
+
+/* 内存命令的地址和长度使用能放下指针的整数，按固定宽度访问内存，精简格式化的%p
+ * 同样按能放下指针的整数输出 */
+#if GM_CLI_MEM_EN || (GM_CLI_PRINTF_BUF_MAX == 0)
+#include "stdint.h"
+#endif  /* GM_CLI_MEM_EN || (GM_CLI_PRINTF_BUF_MAX == 0) */
+
+#if GM_CLI_TRACE_EN || GM_CLI_LOOP_EN || GM_CLI_CALL_EN
+#include "stdint.h"
+
+/* 跟踪时间戳、循环命令和函数调用计时使用的计数器，未在配置中指定时按平台选择 */
+#ifndef GM_CLI_TRACE_CYCLES
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define GM_CLI_TRACE_CYCLES()       __builtin_ia32_rdtsc()
+#define GM_CLI_TRACE_CLOCK_NAME     "rdtsc"
+#elif defined (__GNUC__) && defined (__aarch64__)
+#define GM_CLI_TRACE_CYCLES()       gm_cli_trace_cntvct()
+#define GM_CLI_TRACE_CLOCK_NAME     "cntvct"
+static inline uint64_t gm_cli_trace_cntvct(void)
+{
+    uint64_t val;
+    __asm__ volatile ("mrs %0, cntvct_el0" : "=r" (val));
+    return val;
+}
+#else
+/* 没有周期计数器时使用时基回调，单位ms */
+#define GM_CLI_TRACE_CYCLES()       ((gm_cli_mgr.pf_tick != NULL) ? gm_cli_mgr.pf_tick() : 0)
+#define GM_CLI_TRACE_CLOCK_NAME     "ms"
+#endif
+#endif  /* GM_CLI_TRACE_CYCLES */
+#ifndef GM_CLI_TRACE_CLOCK_NAME
+#define GM_CLI_TRACE_CLOCK_NAME     "user"
+#endif
+#endif  /* GM_CLI_TRACE_EN || GM_CLI_LOOP_EN || GM_CLI_CALL_EN */
+
+#if GM_CLI_TRACE_EN
+#if ((GM_CLI_TRACE_NUM & (GM_CLI_TRACE_NUM - 1)) != 0)
+#error "GM_CLI_TRACE_NUM must be a power of 2"
+#endif
+
+/* 跟踪事件类型，放在事件号的高两位，都不置位为瞬时事件 */
+#define GM_CLI_TRACE_BEGIN          0x80u   /* 开始 */
+#define GM_CLI_TRACE_END            0x40u   /* 结束 */
+
+/* 跟踪事件号 */
+#define GM_CLI_TRACE_CHAR           0u      /* 处理一个输入字符，参数为字符 */
+#define GM_CLI_TRACE_ESC            1u      /* 功能码解码，参数为解码后的输入状态 */
+#define GM_CLI_TRACE_REDRAW         2u      /* 重绘输入行，参数为字符数 */
+#define GM_CLI_TRACE_HISTORY        3u      /* 翻查历史记录 */
+#define GM_CLI_TRACE_TAB            4u      /* Tab补全 */
+#define GM_CLI_TRACE_ENTER          5u      /* 回车处理，含命令执行 */
+#define GM_CLI_TRACE_LOOKUP         6u      /* 查找命令，结束参数为是否找到 */
+#define GM_CLI_TRACE_CMD            7u      /* 命令回调，开始参数为参数个数，结束参数为返回值 */
+#define GM_CLI_TRACE_POLL           8u      /* 后台处理 */
+#define GM_CLI_TRACE_OUT            9u      /* 终端输出，参数为字节数 */
+
+/* 添加跟踪事件 */
+#define GM_CLI_TRACE(id, arg)       gm_cli_trace_put((id), (unsigned int)(arg))
+
+/* 跟踪事件，8字节 */
+typedef struct
+{
+    uint32_t              ts;                            /* 时间戳，计数器的低32位 */
+    uint8_t               id;                            /* 事件号和类型 */
+    uint8_t               rsv;                           /* 保留 */
+    uint16_t              arg;                           /* 参数 */
+} gm_cli_trace_event_t;
+#else
+#define GM_CLI_TRACE(id, arg)       ((void)0)
+#endif  /* GM_CLI_TRACE_EN */
+
+#if GM_CLI_LOG_EN || GM_CLI_BUDGET_EN
+/* 原子操作，用于日志队列和执行中命令的状态，GCC和Clang使用内建函数，VC使用
+ * Interlocked函数，其他编译器在GM_CLI_LOG_LOCK和GM_CLI_LOG_UNLOCK之间操作 */
+#if defined (__GNUC__) || defined (__clang__)
+typedef unsigned int gm_cli_atomic_t;
+
+static inline unsigned int gm_cli_atomic_load(gm_cli_atomic_t* const p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void gm_cli_atomic_store(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    __atomic_store_n(p, val, __ATOMIC_RELEASE);
+}
+
+static inline int gm_cli_atomic_cas(gm_cli_atomic_t* const p, unsigned int exp, const unsigned int val)
+{
+    return __atomic_compare_exchange_n(p, &exp, val, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static inline unsigned int gm_cli_atomic_xchg(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    return __atomic_exchange_n(p, val, __ATOMIC_ACQ_REL);
+}
+#elif defined (_MSC_VER)
+#include "intrin.h"
+typedef volatile long gm_cli_atomic_t;
+
+static __inline unsigned int gm_cli_atomic_load(gm_cli_atomic_t* const p)
+{
+    return (unsigned int)_InterlockedCompareExchange(p, 0, 0);
+}
+
+static __inline void gm_cli_atomic_store(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    _InterlockedExchange(p, (long)val);
+}
+
+static __inline int gm_cli_atomic_cas(gm_cli_atomic_t* const p, unsigned int exp, const unsigned int val)
+{
+    return (unsigned int)_InterlockedCompareExchange(p, (long)val, (long)exp) == exp;
+}
+
+static __inline unsigned int gm_cli_atomic_xchg(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    return (unsigned int)_InterlockedExchange(p, (long)val);
+}
+#else
+typedef volatile unsigned int gm_cli_atomic_t;
+
+static unsigned int gm_cli_atomic_load(gm_cli_atomic_t* const p)
+{
+    return *p;
+}
+
+static void gm_cli_atomic_store(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    GM_CLI_LOG_LOCK();
+    *p = val;
+    GM_CLI_LOG_UNLOCK();
+}
+
+static int gm_cli_atomic_cas(gm_cli_atomic_t* const p, unsigned int exp, const unsigned int val)
+{
+    int ret = 0;
+
+    GM_CLI_LOG_LOCK();
+    if (*p == exp)
+    {
+        *p = val;
+        ret = 1;
+    }
+    GM_CLI_LOG_UNLOCK();
+    return ret;
+}
+
+static unsigned int gm_cli_atomic_xchg(gm_cli_atomic_t* const p, const unsigned int val)
+{
+    unsigned int old;
+
+    GM_CLI_LOG_LOCK();
+    old = *p;
+    *p = val;
+    GM_CLI_LOG_UNLOCK();
+    return old;
+}
+#endif  /* __GNUC__ */
+#endif  /* GM_CLI_LOG_EN || GM_CLI_BUDGET_EN */
+
+#if GM_CLI_LOG_EN
+#if ((GM_CLI_LOG_NUM & (GM_CLI_LOG_NUM - 1)) != 0) || (GM_CLI_LOG_NUM < 2)
+#error "GM_CLI_LOG_NUM must be a power of 2 and at least 2"
+#endif
+
+/* 日志队列槽，seq等于写入位置时可写，等于写入位置加1时可读 */
+typedef struct
+{
+    gm_cli_atomic_t       seq;                           /* 序号 */
+    unsigned int          len;                           /* 日志长度 */
+    char                  buf[GM_CLI_LOG_LINE_MAX];      /* 日志内容 */
+} gm_cli_log_slot_t;
+
+/* 初始化日志队列 */
+static void gm_cli_log_init(void);
+#endif  /* GM_CLI_LOG_EN */
 
 #if (GM_CLI_CC == GM_CLI_CC_VS)
 /* Microsoft VC/C++ 编译器没有找到段起始和终止的操作宏，需要特殊处理 */
@@ -58,47 +355,447 @@ static const gm_cli_cmd_t __gm_cli_cmd_end =
 };
 #endif  /* GM_CLI_CC == GM_CLI_CC_VS */
 
+/* 行缓存位置和历史记录信息的类型，紧凑位宽时行存储区不能超过GM_CLI_POS_MAX */
+#if GM_CLI_PACKED_EN
+typedef unsigned short gm_cli_pos_t;
+typedef unsigned char  gm_cli_cnt_t;
+#define GM_CLI_POS_MAX              0xFFFFu
+#if (GM_CLI_HISTORY_LINE_MAX > 255)
+#error "GM_CLI_HISTORY_LINE_MAX must be less than 256 when GM_CLI_PACKED_EN is set"
+#endif
+#else
+typedef unsigned int   gm_cli_pos_t;
+typedef unsigned int   gm_cli_cnt_t;
+#define GM_CLI_POS_MAX              0xFFFFFFFFu
+#endif  /* GM_CLI_PACKED_EN */
+
+#if GM_CLI_BUDGET_EN
+/* 命令中止原因 */
+#define GM_CLI_ABORT_NONE           0u      /* 不中止 */
+#define GM_CLI_ABORT_BUDGET         1u      /* 超过执行时间预算 */
+#define GM_CLI_ABORT_USER           2u      /* 被请求中止 */
+#endif  /* GM_CLI_BUDGET_EN */
+
 /* 输入状态定义 */
 typedef enum
 {
     GM_CLI_INPUT_WAIT_NORMAL,       /* 等待正常字符 */
     GM_CLI_INPUT_WAIT_SPEC_KEY,     /* 等待特殊字符 */
     GM_CLI_INPUT_WAIT_FUNC_KEY,     /* 等待功能字符 */
+    GM_CLI_INPUT_WAIT_FUNC_NUM,     /* 等待功能字符数字参数结束 */
 #if (GM_CLI_CC == GM_CLI_CC_VS) || (GM_CLI_CC == GM_CLI_CC_MINGW) || \
     ((GM_CLI_CC == GM_CLI_CC_ANY) && defined _MSC_VER)
     GM_CLI_INPUT_WAIT_FUNC_KEY1,    /* 等待功能字符1 */
 #endif
 } gm_cli_input_status_t;
 
+/* 输出通道，所有输出数据都经过输出通道链逐级传递，最末级为终端 */
+typedef struct _gm_cli_sink_t gm_cli_sink_t;
+/* 输出通道写入函数 */
+typedef void gm_cli_sink_write_cb_t(gm_cli_sink_t*, const char*, unsigned int);
+struct _gm_cli_sink_t
+{
+    gm_cli_sink_write_cb_t *write;                       /* 写入函数 */
+    gm_cli_sink_t          *next;                        /* 下一级输出通道 */
+};
+
+#if GM_CLI_BATCH_EN
+/* 批量执行任务状态 */
+#define GM_CLI_BATCH_READY          0u              /* 等待执行 */
+#define GM_CLI_BATCH_RUNNING        1u              /* 正在执行 */
+#define GM_CLI_BATCH_DONE           2u              /* 执行完成 */
+
+/* 批量执行任务，一条可重入命令 */
+typedef struct
+{
+    gm_cli_sink_t          sink;                         /* 输出捕获通道，必须放在首位 */
+    const gm_cli_cmd_t*    p_cmd;                        /* 命令 */
+    int                    argc;                         /* 参数个数 */
+    char*                  argv[GM_CLI_CMD_ARGS_NUM_MAX];/* 参数，指向脚本 */
+    int                    ret;                          /* 命令返回值 */
+    unsigned int           state;                        /* 任务状态 */
+    unsigned int           line;                         /* 脚本行号 */
+    unsigned int           out_len;                      /* 输出长度 */
+    unsigned int           out_trunc;                    /* 输出是否被截断 */
+#if GM_CLI_BUDGET_EN
+    unsigned long          run_start;                    /* 命令开始执行的时间 */
+    unsigned long          run_budget;                   /* 命令的执行时间预算，0为不限制 */
+    gm_cli_atomic_t        run_abort;                    /* 中止原因，GM_CLI_ABORT_XXX */
+#endif  /* GM_CLI_BUDGET_EN */
+    char                   out[GM_CLI_BATCH_OUT_MAX];    /* 输出缓存 */
+} gm_cli_batch_job_t;
+
+/* 当前线程执行的任务，工作线程执行命令时有效，输出写入任务的捕获通道，预算和中止
+ * 状态也属于任务，其他时候为NULL */
+static __thread gm_cli_batch_job_t* gm_cli_batch_job;
+#if GM_CLI_BUDGET_EN
+/* 是否有工作线程在执行批量任务 */
+static gm_cli_atomic_t gm_cli_batch_active;
+/* 批量执行中请求了中止，工作线程中的命令都中止，不再执行新的命令 */
+static gm_cli_atomic_t gm_cli_batch_abort;
+#endif  /* GM_CLI_BUDGET_EN */
+#endif  /* GM_CLI_BATCH_EN */
+
+#if GM_CLI_PLUGIN_EN
+/* 命令插件 */
+typedef struct
+{
+    void*                  handle;                       /* dlopen句柄，NULL为空闲 */
+    const gm_cli_cmd_t*    p_start;                      /* 命令起始 */
+    const gm_cli_cmd_t*    p_end;                        /* 命令结束，不含 */
+    unsigned int           active;                       /* 命令是否可见 */
+    char                   path[GM_CLI_PLUGIN_PATH_MAX]; /* 加载路径 */
+} gm_cli_plugin_t;
+#endif  /* GM_CLI_PLUGIN_EN */
+
+#if GM_CLI_OUT_SCHED_EN
+/* 输出类别，交互输出（回显、控制和提示符）直接发送，批量输出（命令输出）经缓存按速率发送 */
+#define GM_CLI_OUT_INTERACTIVE      0u
+#define GM_CLI_OUT_BULK             1u
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+#if GM_CLI_PIPE_EN
+/* 管道级 */
+typedef struct _gm_cli_pipe_stage_t gm_cli_pipe_stage_t;
+
+/* 管道过滤器定义 */
+typedef struct
+{
+    const char* name;                                    /* 过滤器名 */
+    /* 打开过滤器，返回：0 - 成功，-1 - 参数错误 */
+    int  (*open)(gm_cli_pipe_stage_t*, int, char*[]);
+    /* 处理一行数据，不含行尾换行符 */
+    void (*line)(gm_cli_pipe_stage_t*, const char*, unsigned int);
+    /* 关闭过滤器，输出剩余数据，可为NULL */
+    void (*close)(gm_cli_pipe_stage_t*);
+} gm_cli_filter_t;
+
+struct _gm_cli_pipe_stage_t
+{
+    gm_cli_sink_t          sink;                         /* 输出通道，必须放在首位 */
+    const gm_cli_filter_t *p_filter;                     /* 过滤器 */
+    const char*            p_arg;                        /* 过滤器参数 */
+    unsigned long          limit;                        /* 过滤器限制值 */
+    unsigned long          count;                        /* 过滤器计数 */
+    unsigned int           flags;                        /* 过滤器选项 */
+    unsigned int           buf_len;                      /* 行缓存数据长度 */
+    char                   buf[GM_CLI_PIPE_LINE_BUF_MAX];/* 行缓存 */
+};
+#endif  /* GM_CLI_PIPE_EN */
+
+#if GM_CLI_CACHE_EN
+/* 命令输出缓存 */
+typedef struct
+{
+    const gm_cli_cmd_t*   p_cmd;                         /* 所属命令，NULL为空闲 */
+    int                   valid;                         /* 缓存数据是否有效 */
+    int                   ret;                           /* 命令返回值 */
+    unsigned long         stamp;                         /* 命令执行时间 */
+#if GM_CLI_EMIT_EN
+    gm_cli_fmt_t          fmt;                           /* 会话输出格式 */
+#endif  /* GM_CLI_EMIT_EN */
+    unsigned int          key_len;                       /* 缓存键长度 */
+    unsigned int          len;                           /* 输出数据长度 */
+    char                  key[GM_CLI_CACHE_KEY_MAX];     /* 缓存键，各参数都以'\0'结束 */
+    char                  buf[GM_CLI_CACHE_BUF_SIZE];    /* 输出数据 */
+} gm_cli_cache_t;
+#endif  /* GM_CLI_CACHE_EN */
+
+#if GM_CLI_WATCH_EN
+/* 周期命令选项 */
+#define GM_CLI_WATCH_FLAG_FG        0x01u   /* 前台运行，任意按键停止 */
+#define GM_CLI_WATCH_FLAG_REDRAW    0x02u   /* 原位刷新，不滚动 */
+
+/* 时间轮每层槽数 */
+#define GM_CLI_WHEEL_SLOTS          (1ul << GM_CLI_WATCH_WHEEL_BITS)
+#define GM_CLI_WHEEL_MASK           (GM_CLI_WHEEL_SLOTS - 1)
+
+/* 周期命令，命令行只解析一次 */
+typedef struct _gm_cli_watch_t gm_cli_watch_t;
+struct _gm_cli_watch_t
+{
+    gm_cli_watch_t*       next;                          /* 同一槽内的下一个 */
+    gm_cli_watch_t**      pprev;                         /* 指向自己的指针地址 */
+    const gm_cli_cmd_t*   p_cmd;                         /* 命令，NULL为空闲 */
+    unsigned long         expire;                        /* 到期节拍 */
+    unsigned long         interval;                      /* 周期节拍数 */
+    unsigned long         runs;                          /* 已执行次数 */
+    unsigned int          lines;                         /* 上次输出的行数 */
+    unsigned int          flags;                         /* 选项 */
+    int                   argc;                          /* 参数个数 */
+    char*                 argv[GM_CLI_CMD_ARGS_NUM_MAX]; /* 参数 */
+    char                  line[GM_CLI_WATCH_LINE_MAX];   /* 参数存储 */
+};
+#endif  /* GM_CLI_WATCH_EN */
+
+#if GM_CLI_ALIAS_EN
+/* 运行时别名，名字、定义和解析好的参数依次存放在别名存储区中，解析好的参数格式为
+ * 命令数(1) + [参数个数(1) + [参数长度(1) + 参数 + '\0'] * 参数个数] * 命令数 */
+typedef struct
+{
+    gm_cli_cmd_t          cmd;                           /* 命令，必须放在首位 */
+    const unsigned char*  p_args;                        /* 解析好的参数 */
+    unsigned int          pos;                           /* 在存储区中的起始位置 */
+    unsigned int          len;                           /* 在存储区中的长度 */
+} gm_cli_alias_t;
+#endif  /* GM_CLI_ALIAS_EN */
+
+#if GM_CLI_VAR_EN
+#if ((GM_CLI_VAR_NUM & (GM_CLI_VAR_NUM - 1)) != 0) || (GM_CLI_VAR_NUM < 2)
+#error "GM_CLI_VAR_NUM must be a power of 2 and at least 2"
+#endif
+#if (GM_CLI_VAR_VALUE_MAX > 256)
+#error "GM_CLI_VAR_VALUE_MAX must not exceed 256"
+#endif
+
+/* 变量槽状态 */
+#define GM_CLI_VAR_EMPTY            0u      /* 空闲 */
+#define GM_CLI_VAR_USED             1u      /* 已使用 */
+#define GM_CLI_VAR_DELETED          2u      /* 已删除，查找时继续向后找 */
+
+/* 变量，哈希表开放寻址 */
+typedef struct
+{
+    unsigned char         state;                         /* 槽状态 */
+    unsigned char         len;                           /* 值长度 */
+    char                  name[GM_CLI_VAR_NAME_MAX];     /* 变量名 */
+    char                  value[GM_CLI_VAR_VALUE_MAX];   /* 变量值 */
+} gm_cli_var_t;
+
+/* 模板段为变量时len的取值 */
+#define GM_CLI_TMPL_VAR             0xFFFFu
+
+/* 模板段，原样复制源串中从pos开始的len个字符，pos相对第一个源串，len为GM_CLI_TMPL_VAR
+ * 时pos为变量槽序号 */
+typedef struct
+{
+    unsigned short        pos;                           /* 起始位置或变量槽序号 */
+    unsigned short        len;                           /* 长度 */
+} gm_cli_tmpl_seg_t;
+
+/* 模板，命令行或分割好的参数只扫描一次编译为段列表，展开时只按段复制，按参数编译时
+ * 各参数必须在同一块存储中依次存放，展开后每个参数以'\0'结束 */
+typedef struct
+{
+    char**                pp_src;                        /* 源串数组 */
+    unsigned int          src_num;                       /* 源串个数 */
+    unsigned int          args;                          /* 是否按参数编译 */
+    unsigned int          gen;                           /* 编译时的变量表版本 */
+    unsigned int          seg_num;                       /* 段数 */
+    gm_cli_tmpl_seg_t     seg[GM_CLI_VAR_SEG_MAX];       /* 段列表 */
+} gm_cli_tmpl_t;
+#endif  /* GM_CLI_VAR_EN */
+
 /* CLI管理器 */
 typedef struct
 {
-    char                  line[GM_CLI_LINE_CHAR_MAX];    /* 一行字符串存储 */
-    unsigned int          input_count;                   /* 输入的字符数量 */
-    unsigned int          input_cusor;                   /* 输入的光标位置 */
+    /* 一行字符串存储，采用间隙缓存，光标处即为间隙起始，光标前的字符存放在
+     * [0, input_cusor)，光标后的字符存放在[line_gap_end, line_size) */
+    char*                 line;
+    gm_cli_pos_t          line_size;                     /* 行缓存大小 */
+    gm_cli_pos_t          line_gap_end;                  /* 间隙结束位置 */
+    gm_cli_pos_t          input_count;                   /* 输入的字符数量 */
+    gm_cli_pos_t          input_cusor;                   /* 输入的光标位置 */
     gm_cli_input_status_t input_status;                  /* 当前输入的状态 */
     gm_cli_out_char_cb_t *pf_outchar;                    /* 输出字符回调函数 */
+    gm_cli_out_buf_cb_t  *pf_outbuf;                     /* 批量输出回调函数 */
+    gm_cli_tick_cb_t     *pf_tick;                       /* 时基回调函数 */
+    unsigned int          func_num;                      /* 功能字符数字参数 */
+#if GM_CLI_BRACKETED_PASTE_EN
+    int                   paste_mode;                    /* 是否处于粘贴模式 */
+    unsigned int          paste_match;                   /* 粘贴结束序列匹配长度 */
+    unsigned int          paste_echo_pos;                /* 粘贴内容未回显的起始位置 */
+    char                  paste_last_ch;                 /* 粘贴的上一个字符 */
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_BIN_EN
+    int                   bin_mode;                      /* 是否处于二进制帧模式 */
+    unsigned int          bin_match;                     /* 进入序列匹配长度 */
+    unsigned int          bin_rx_len;                    /* 已接收的帧长度，不含帧头 */
+    unsigned int          bin_rsp_len;                   /* 响应输出数据长度 */
+    unsigned int          bin_rsp_flags;                 /* 响应标志 */
+    gm_cli_sink_t         bin_sink;                      /* 响应输出捕获通道 */
+    /* 接收帧缓存：标志(1) + 序号(2) + 长度(2) + 命令行 + CRC(2)，多留一个'\0' */
+    unsigned char         bin_rx[GM_CLI_BIN_FRAME_MAX + 8];
+    char                  bin_rsp[GM_CLI_BIN_RSP_MAX];   /* 响应输出数据缓存 */
+#endif  /* GM_CLI_BIN_EN */
+#if GM_CLI_EMIT_EN
+    gm_cli_fmt_t          emit_fmt;                      /* 会话默认输出格式 */
+    gm_cli_fmt_t          emit_cur_fmt;                  /* 当前命令的输出格式 */
+    unsigned int          emit_depth;                    /* 当前嵌套层数 */
+    unsigned int          emit_array_mask;               /* 各层是否为数组 */
+    unsigned int          emit_item_mask;                /* 各层是否已有元素 */
+    unsigned int          emit_overflow;                 /* 超过最大层数未输出的容器数 */
+    int                   emit_err;                      /* 本次命令嵌套是否超过最大层数 */
+#endif  /* GM_CLI_EMIT_EN */
     const int*            p_cmd_start;                   /* 命令存储区起始指针 */
     const int*            p_cmd_end;                     /* 命令存储区结束指针 */
     const char*           p_cmd_notice;                  /* 命令提示符 */
+#if (GM_CLI_PRINTF_BUF_MAX > 0) && !GM_CLI_BATCH_EN
     /* 打印函数使用的字符串缓存 */
     char                  printf_str[GM_CLI_PRINTF_BUF_MAX];
-    /* 备份字符串，用于翻历史记录时保存当前 */
-    char                  backup_str[GM_CLI_LINE_CHAR_MAX];
-    char                  history_str[GM_CLI_HISTORY_LINE_MAX][GM_CLI_LINE_CHAR_MAX];
-    unsigned int          history_total;                 /* 历史总记录条数 */
-    unsigned int          history_index;                 /* 历史存储索引 */
-    unsigned int          history_inquire_index;         /* 历史查询索引 */
-    unsigned int          history_inquire_count;         /* 历史查询数量计数器 */
+#endif  /* (GM_CLI_PRINTF_BUF_MAX > 0) && !GM_CLI_BATCH_EN */
+    /* 备份字符串，用于翻历史记录时保存当前，大小和行缓存相同 */
+    char*                 backup_str;
+    /* 历史记录存储池，各条记录按实际长度首尾相接环形存放 */
+    char*                 history_pool;
+    gm_cli_pos_t          history_pool_size;             /* 历史记录存储池大小 */
+    gm_cli_pos_t          history_pool_pos;              /* 历史记录存储池写入位置 */
+    gm_cli_pos_t          history_pool_used;             /* 历史记录存储池已用大小 */
+    gm_cli_pos_t          history_pos[GM_CLI_HISTORY_LINE_MAX];  /* 各记录起始位置 */
+    gm_cli_pos_t          history_len[GM_CLI_HISTORY_LINE_MAX];  /* 各记录长度 */
+    gm_cli_cnt_t          history_total;                 /* 历史总记录条数 */
+    gm_cli_cnt_t          history_index;                 /* 历史存储索引 */
+    gm_cli_cnt_t          history_inquire_index;         /* 历史查询索引 */
+    gm_cli_cnt_t          history_inquire_count;         /* 历史查询数量计数器 */
+    gm_cli_sink_t         term_sink;                     /* 终端输出通道 */
+    gm_cli_sink_t        *p_sink;                        /* 当前输出通道 */
+#if GM_CLI_SESSION_EN
+    gm_cli_sink_t         session_sink;                  /* 会话保存通道 */
+    char*                 session_buf;                   /* 会话保存位置 */
+    unsigned int          session_size;                  /* 会话保存位置大小 */
+    unsigned int          session_len;                   /* 会话已保存长度 */
+    int                   session_overflow;              /* 会话保存空间是否不足 */
+#endif  /* GM_CLI_SESSION_EN */
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    int                   cmd_index_ok;                  /* 命令索引是否可用 */
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
+#if GM_CLI_ALIAS_EN
+    unsigned int          alias_used;                    /* 别名存储区已用大小 */
+    int                   alias_running;                 /* 是否正在执行别名 */
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_VAR_EN
+    unsigned int          var_num;                       /* 变量数 */
+    unsigned int          var_gen;                       /* 变量表版本，删除变量时增加 */
+#endif  /* GM_CLI_VAR_EN */
+#if GM_CLI_PIPE_EN
+    /* 管道各级过滤器，命令本身不占用 */
+    gm_cli_pipe_stage_t   pipe_stage[GM_CLI_PIPE_STAGE_MAX - 1];
+    char                  pipe_tail_buf[GM_CLI_PIPE_TAIL_BUF_MAX];
+    unsigned int          pipe_tail_pos;                 /* tail缓存写入位置 */
+    unsigned int          pipe_tail_len;                 /* tail缓存数据长度 */
+    int                   pipe_tail_used;                /* tail缓存是否被占用 */
+#endif  /* GM_CLI_PIPE_EN */
+#if GM_CLI_REDIRECT_SUPPORT
+    gm_cli_sink_t         file_sink;                     /* 文件输出通道 */
+    int                   file_fd;                       /* 重定向的文件 */
+    unsigned int          file_buf_len;                  /* 文件写缓存数据长度 */
+    int                   file_err;                      /* 文件写入是否出错 */
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+#if GM_CLI_CACHE_EN
+    gm_cli_sink_t         cache_sink;                    /* 输出缓存捕获通道 */
+    gm_cli_cache_t*       p_cache_fill;                  /* 正在写入的缓存 */
+    int                   cache_overflow;                /* 输出是否超过缓存大小 */
+    unsigned long         cache_hit;                     /* 缓存命中次数 */
+    unsigned long         cache_miss;                    /* 缓存未命中次数 */
+#endif  /* GM_CLI_CACHE_EN */
+#if GM_CLI_WATCH_EN
+    unsigned long         wheel_tick;                    /* 时间轮当前节拍 */
+    unsigned long         wheel_ms;                      /* 时间轮当前节拍对应时间 */
+    unsigned int          watch_num;                     /* 周期命令数量 */
+    unsigned int          watch_fg_num;                  /* 前台周期命令数量 */
+    unsigned int          watch_lines;                   /* 本次输出的行数 */
+    const gm_cli_watch_t* p_watch_last;                  /* 最后输出的周期命令 */
+    gm_cli_sink_t         watch_sink;                    /* 输出行数统计通道 */
+#endif  /* GM_CLI_WATCH_EN */
+#if GM_CLI_SUGGEST_EN
+    unsigned int          bk_num;                        /* BK树节点数 */
+    int                   bk_ok;                         /* BK树是否包含全部命令 */
+#endif  /* GM_CLI_SUGGEST_EN */
+#if GM_CLI_LOG_EN
+    gm_cli_atomic_t       log_tail;                      /* 日志写入位置，多个线程共用 */
+    gm_cli_atomic_t       log_dropped;                   /* 队列满丢弃的日志数 */
+    unsigned int          log_head;                      /* 日志读取位置，只由命令行线程使用 */
+#endif  /* GM_CLI_LOG_EN */
+#if GM_CLI_OUT_SCHED_EN
+    unsigned int          out_class;                     /* 当前输出类别 */
+    unsigned int          out_head;                      /* 批量输出读取位置 */
+    unsigned int          out_len;                       /* 批量输出数据长度 */
+    int                   out_prompt;                    /* 提示符推迟到批量输出发送完成后显示 */
+    int                   out_dirty;                     /* 推迟期间有交互输出 */
+#if (GM_CLI_OUT_BULK_RATE > 0)
+    unsigned long         out_credit;                    /* 可发送的字节数 */
+    unsigned long         out_stamp;                     /* 上次计算可发送字节数的时间 */
+#endif  /* GM_CLI_OUT_BULK_RATE */
+    char                  out_buf[GM_CLI_OUT_BULK_BUF_SIZE]; /* 批量输出缓存 */
+#if GM_CLI_MEM_EN
+    uintptr_t             mem_addr;                      /* md剩余部分的起始地址 */
+    uintptr_t             mem_left;                      /* md剩余部分的字节数 */
+    unsigned int          mem_width;                     /* md的访问宽度，0为没有剩余部分 */
+#endif  /* GM_CLI_MEM_EN */
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#if GM_CLI_BUDGET_EN
+    /* 执行标志和中止原因可能在其他线程或中断中读写，使用原子操作，命令、开始时间和
+     * 预算在设置执行标志之前写入，其他线程读到执行标志后才读取 */
+    gm_cli_atomic_t       run_active;                    /* 是否有命令在执行 */
+    gm_cli_atomic_t       run_abort;                     /* 中止原因，GM_CLI_ABORT_XXX */
+    const gm_cli_cmd_t*   p_run_cmd;                     /* 正在执行的命令 */
+    unsigned long         run_start;                     /* 命令开始执行的时间 */
+    unsigned long         run_budget;                    /* 命令的执行时间预算，0为不限制 */
+#if GM_CLI_BRACKETED_PASTE_EN
+    int                   peek_paste;                    /* 预解析的输入是否处于粘贴模式 */
+    unsigned int          peek_seq;                      /* 粘贴开始或结束序列已匹配的长度 */
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_BIN_EN
+    int                   peek_bin;                      /* 预解析的输入是否处于二进制帧模式 */
+    unsigned int          peek_bin_match;                /* 二进制帧模式序列已匹配的长度 */
+#endif  /* GM_CLI_BIN_EN */
+    unsigned long         wdog_overruns;                 /* 超过预算的次数 */
+    unsigned long         wdog_aborts;                   /* 被请求中止的次数 */
+    unsigned long         wdog_max_ms;                   /* 最长的执行时间 */
+    char                  wdog_last_name[GM_CLI_WDOG_NAME_MAX]; /* 最后超过预算的命令 */
+    unsigned long         wdog_last_ms;                  /* 最后一次超过预算的执行时间 */
+    unsigned long         wdog_last_budget;              /* 最后一次超过预算的预算 */
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_REC_EN
+    gm_cli_out_buf_cb_t  *pf_rec_write;                  /* 会话记录写入函数，NULL为未录制 */
+    unsigned long         rec_last;                      /* 上一条记录的时间 */
+    unsigned long         rec_stamp;                     /* 待写入记录的时间 */
+    unsigned int          rec_type;                      /* 待写入记录的类型 */
+    unsigned int          rec_len;                       /* 待写入记录的数据长度 */
+    int                   rec_dirty;                     /* 上一次后台处理记录后是否有新记录 */
+    char                  rec_buf[GM_CLI_REC_BUF_SIZE];  /* 待写入记录的数据 */
+#endif  /* GM_CLI_REC_EN */
+#if GM_CLI_CALL_EN
+    const gm_cli_sym_t*   p_sym_table;                   /* 函数符号表 */
+    unsigned int          sym_num;                       /* 函数符号数 */
+#endif  /* GM_CLI_CALL_EN */
+#if GM_CLI_TRACE_EN
+    unsigned int          trace_pos;                     /* 跟踪事件写入总数 */
+    int                   trace_on;                      /* 是否记录跟踪事件 */
+#endif  /* GM_CLI_TRACE_EN */
 } gm_cli_mgr_t;
 
+/* 终端输出通道写入 */
+static void gm_cli_term_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len);
+#if GM_CLI_OUT_SCHED_EN
+/* 从批量输出缓存发送数据到终端 */
+static unsigned int gm_cli_out_send(unsigned int max);
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+#if (GM_CLI_LINE_ARENA_SIZE < (GM_CLI_LINE_CHAR_MAX * 3))
+#error "GM_CLI_LINE_ARENA_SIZE must be at least 3 times of GM_CLI_LINE_CHAR_MAX"
+#endif
+
+/* 默认的行存储区，依次分配给行缓存、备份字符串和历史记录存储池 */
+static char gm_cli_line_arena[GM_CLI_LINE_ARENA_SIZE];
+
 /* CLI控制 */
 static gm_cli_mgr_t gm_cli_mgr =
 {
+    .line = &gm_cli_line_arena[0],
+    .line_size = GM_CLI_LINE_CHAR_MAX,
+    .line_gap_end = GM_CLI_LINE_CHAR_MAX,
+    .backup_str = &gm_cli_line_arena[GM_CLI_LINE_CHAR_MAX],
+    .history_pool = &gm_cli_line_arena[GM_CLI_LINE_CHAR_MAX * 2],
+    .history_pool_size = GM_CLI_LINE_ARENA_SIZE - GM_CLI_LINE_CHAR_MAX * 2,
+    .history_pool_pos = 0,
+    .history_pool_used = 0,
     .input_count = 0,
     .input_cusor = 0,
     .input_status = GM_CLI_INPUT_WAIT_NORMAL,
     .pf_outchar = NULL,
+    .pf_outbuf = NULL,
+    .pf_tick = NULL,
     .p_cmd_start = NULL,
     .p_cmd_end = NULL,
     .p_cmd_notice = GM_CLI_DEFAULT_CMD_PROMPT,
@@ -106,8 +803,151 @@ static gm_cli_mgr_t gm_cli_mgr =
     .history_index = 0,
     .history_inquire_index = 0,
     .history_inquire_count =0,
+    .term_sink = { gm_cli_term_sink_write, NULL },
+    .p_sink = &gm_cli_mgr.term_sink,
+};
+
+#if GM_CLI_TRACE_EN
+/* 跟踪事件环形缓存，写满后覆盖最早的事件 */
+static gm_cli_trace_event_t gm_cli_trace_ring[GM_CLI_TRACE_NUM];
+
+/* 跟踪事件名，按事件号排列 */
+static const char* const gm_cli_trace_name[] =
+{
+    "char", "esc", "redraw", "history", "tab", "enter", "lookup", "cmd", "poll", "out",
 };
 
+/* 记录一个跟踪事件 */
+static void gm_cli_trace_put(const unsigned int id, const unsigned int arg)
+{
+    gm_cli_trace_event_t* p_event;
+
+    if (!gm_cli_mgr.trace_on)
+    {
+        return;
+    }
+#if GM_CLI_BATCH_EN
+    /* 批量执行的工作线程中也会记录，各线程取得不同的位置 */
+    p_event = &gm_cli_trace_ring[__atomic_fetch_add(&gm_cli_mgr.trace_pos, 1, __ATOMIC_RELAXED) &
+                                 (GM_CLI_TRACE_NUM - 1)];
+#else
+    p_event = &gm_cli_trace_ring[gm_cli_mgr.trace_pos++ & (GM_CLI_TRACE_NUM - 1)];
+#endif  /* GM_CLI_BATCH_EN */
+    p_event->ts = (uint32_t)GM_CLI_TRACE_CYCLES();
+    p_event->id = (uint8_t)id;
+    p_event->rsv = 0;
+    p_event->arg = (uint16_t)arg;
+}
+#endif  /* GM_CLI_TRACE_EN */
+
+#if GM_CLI_PLUGIN_EN
+/* 已加载的插件 */
+static gm_cli_plugin_t gm_cli_plugin[GM_CLI_PLUGIN_NUM];
+
+/* 读侧计数，按阶段奇偶分两组，写侧切换阶段后等待旧阶段的读者全部退出 */
+static unsigned int gm_cli_rcu_readers[2];
+/* 当前阶段 */
+static unsigned int gm_cli_rcu_phase;
+/* 当前线程读侧临界区的嵌套层数和进入时的阶段 */
+static __thread unsigned int gm_cli_rcu_depth;
+static __thread unsigned int gm_cli_rcu_self;
+
+/* 进入读侧临界区，嵌套时只计最外层 */
+static void gm_cli_rcu_read_lock(void)
+{
+    unsigned int phase;
+
+    if (gm_cli_rcu_depth++ > 0)
+    {
+        return;
+    }
+    for (;;)
+    {
+        phase = __atomic_load_n(&gm_cli_rcu_phase, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&gm_cli_rcu_readers[phase & 1], 1, __ATOMIC_SEQ_CST);
+        /* 计数期间阶段被切换，写侧可能已经看过这一组，退出后重新进入 */
+        if (__atomic_load_n(&gm_cli_rcu_phase, __ATOMIC_SEQ_CST) == phase)
+        {
+            break;
+        }
+        __atomic_sub_fetch(&gm_cli_rcu_readers[phase & 1], 1, __ATOMIC_SEQ_CST);
+    }
+    gm_cli_rcu_self = phase;
+}
+
+/* 退出读侧临界区 */
+static void gm_cli_rcu_read_unlock(void)
+{
+    if (--gm_cli_rcu_depth > 0)
+    {
+        return;
+    }
+    __atomic_sub_fetch(&gm_cli_rcu_readers[gm_cli_rcu_self & 1], 1, __ATOMIC_RELEASE);
+}
+
+/* 等待宽限期，调用前已进入的读侧临界区全部退出，调用者在命令中调用时不等自己 */
+static void gm_cli_rcu_sync(void)
+{
+    unsigned int phase = __atomic_load_n(&gm_cli_rcu_phase, __ATOMIC_SEQ_CST);
+    unsigned int self;
+
+    __atomic_store_n(&gm_cli_rcu_phase, phase + 1, __ATOMIC_SEQ_CST);
+    self = ((gm_cli_rcu_depth > 0) && (((gm_cli_rcu_self ^ phase) & 1) == 0)) ? 1 : 0;
+    while (__atomic_load_n(&gm_cli_rcu_readers[phase & 1], __ATOMIC_ACQUIRE) > self)
+    {
+        sched_yield();
+    }
+}
+
+#define GM_CLI_RCU_READ_LOCK()      gm_cli_rcu_read_lock()
+#define GM_CLI_RCU_READ_UNLOCK()    gm_cli_rcu_read_unlock()
+
+/* 静态命令之后依次是可见插件的命令 */
+static const gm_cli_cmd_t* gm_cli_plugin_next_cmd(const gm_cli_cmd_t* const p_cmd)
+{
+    unsigned int i = 0;
+
+    if (((const int*)p_cmd >= gm_cli_mgr.p_cmd_start) && ((const int*)p_cmd < gm_cli_mgr.p_cmd_end))
+    {
+        if ((const int*)(p_cmd + 1) < gm_cli_mgr.p_cmd_end)
+        {
+            return p_cmd + 1;
+        }
+    }
+    else
+    {
+        for (; i < GM_CLI_PLUGIN_NUM; i++)
+        {
+            if ((p_cmd >= gm_cli_plugin[i].p_start) && (p_cmd < gm_cli_plugin[i].p_end))
+            {
+                break;
+            }
+        }
+        if (i == GM_CLI_PLUGIN_NUM)
+        {
+            return NULL;
+        }
+        if (p_cmd + 1 < gm_cli_plugin[i].p_end)
+        {
+            return p_cmd + 1;
+        }
+        i++;
+    }
+    for (; i < GM_CLI_PLUGIN_NUM; i++)
+    {
+        if (__atomic_load_n(&gm_cli_plugin[i].active, __ATOMIC_ACQUIRE) &&
+            (gm_cli_plugin[i].p_start < gm_cli_plugin[i].p_end))
+        {
+            return gm_cli_plugin[i].p_start;
+        }
+    }
+    return NULL;
+}
+#else
+#define GM_CLI_RCU_READ_LOCK()
+#define GM_CLI_RCU_READ_UNLOCK()
+#endif  /* GM_CLI_PLUGIN_EN */
+
 /* 读取下一个命令 */
 static const gm_cli_cmd_t* gm_cli_get_next_cmd(const int* const addr)
 {
@@ -122,6 +962,8 @@ static const gm_cli_cmd_t* gm_cli_get_next_cmd(const int* const addr)
         }
         ptr++;
     }
+#elif GM_CLI_PLUGIN_EN
+    return gm_cli_plugin_next_cmd((const gm_cli_cmd_t*)addr);
 #else   /* GM_CLI_CC == GM_CLI_CC_VS */
     const int *ptr = (const int*)((char*)addr + sizeof(gm_cli_cmd_t));
     if (ptr < gm_cli_mgr.p_cmd_end)
@@ -133,841 +975,7741 @@ static const gm_cli_cmd_t* gm_cli_get_next_cmd(const int* const addr)
     return NULL;
 }
 
-/* 搜索命令 */
-static const gm_cli_cmd_t* gm_cli_search_cmd(const char* const cmd_name)
-{
-    const gm_cli_cmd_t* p_ret = NULL;
-    const gm_cli_cmd_t* p_temp;
+#if GM_CLI_ALIAS_EN
+/* 运行时别名 */
+static gm_cli_alias_t gm_cli_alias[GM_CLI_ALIAS_NUM];
+/* 运行时别名存储区 */
+static char gm_cli_alias_arena[GM_CLI_ALIAS_ARENA_SIZE];
 
-    p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+/* 逐个查找运行时别名 */
+static const gm_cli_cmd_t* gm_cli_alias_find(const char* const name)
+{
+    unsigned int i;
 
-    while (p_temp != NULL)
+    for (i = 0; i < GM_CLI_ALIAS_NUM; i++)
     {
-        if (strcmp(p_temp->name, cmd_name) == 0)
+        if ((gm_cli_alias[i].cmd.name != NULL) && (strcmp(gm_cli_alias[i].cmd.name, name) == 0))
         {
-            p_ret = p_temp;
-            break;
+            return &gm_cli_alias[i].cmd;
         }
-        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
     }
-
-    return p_ret;
+    return NULL;
 }
+#endif  /* GM_CLI_ALIAS_EN */
 
-/* 初始化cli管理器 */
-void gm_cli_mgr_init(void)
-{
-#if (GM_CLI_CC == GM_CLI_CC_MDK_ARM)
-    extern const int gm_cli_cmd_section$$Base;
-    extern const int gm_cli_cmd_section$$Limit;
-    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_cmd_section$$Base;
-    gm_cli_mgr.p_cmd_end   = (const int*)&gm_cli_cmd_section$$Limit;
-#elif  (GM_CLI_CC == GM_CLI_CC_GCC_LINUX)
-    extern const gm_cli_cmd_t gm_cli_cmd_section_start;
-    extern const gm_cli_cmd_t gm_cli_cmd_section_end;
-    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_cmd_section_start;
-    gm_cli_mgr.p_cmd_end   = (const int*)&gm_cli_cmd_section_end;
-#elif ((GM_CLI_CC == GM_CLI_CC_IAR_ARM) || (GM_CLI_CC == GM_CLI_CC_IAR_STM8))
-    gm_cli_mgr.p_cmd_start = (const int*)__section_begin(".gm_cli_cmd_section");
-    gm_cli_mgr.p_cmd_end = (const int*)__section_end(".gm_cli_cmd_section");
-#elif (GM_CLI_CC == GM_CLI_CC_VS) || (GM_CLI_CC == GM_CLI_CC_MINGW)
-    unsigned int* ptr_begin, *ptr_end;
+#if GM_CLI_VAR_EN
+/* 变量哈希表 */
+static gm_cli_var_t gm_cli_var[GM_CLI_VAR_NUM];
 
-    /* 找寻起始位置 */
-    ptr_begin = (unsigned int*)&__gm_cli_cmd_begin;
-    ptr_begin += (sizeof(gm_cli_cmd_t) / sizeof(unsigned int));
-    while ((*ptr_begin) == 0) ptr_begin++;
+static int gm_cli_var_subst_args(const int argc, char* argv[], char* const buf,
+                                 unsigned int* const p_pos);
+#endif  /* GM_CLI_VAR_EN */
 
-    /* 找寻终止位置 */
-    ptr_end = (unsigned int *)&__gm_cli_cmd_end;
-    ptr_end--;
-    while ((*ptr_end) == 0) ptr_end--;
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+#if (GM_CLI_CMD_INDEX_SIZE & (GM_CLI_CMD_INDEX_SIZE - 1))
+#error "GM_CLI_CMD_INDEX_SIZE must be a power of 2"
+#endif
 
-    /* 判断是否合法 */
-    if (ptr_begin < ptr_end)
-    {
-        gm_cli_mgr.p_cmd_start = (const int*)(ptr_begin);
-        gm_cli_mgr.p_cmd_end   = (const int*)(ptr_end);
-    }
-    else
-    {
-        gm_cli_mgr.p_cmd_start = NULL;
-        gm_cli_mgr.p_cmd_end   = NULL;
-    }
-#elif (GM_CLI_CC == GM_CLI_CC_ANY)
-    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_static_cmds[0];
-    const gm_cli_cmd_t *ptr = &gm_cli_static_cmds[0];
-    while (ptr->name != NULL) ptr++;
-    gm_cli_mgr.p_cmd_end = (const int*)ptr;
+#if GM_CLI_PLUGIN_EN
+/* 命令查找哈希索引，开放寻址，删除的位置放入删除标记，共两份，重建时写入未发布的
+ * 一份，建好后原子切换，查找时先取当前索引的快照 */
+static const gm_cli_cmd_t* gm_cli_cmd_index_buf[2][GM_CLI_CMD_INDEX_SIZE];
+static const gm_cli_cmd_t** gm_cli_cmd_index = gm_cli_cmd_index_buf[0];
+#define GM_CLI_CMD_INDEX_LOAD()     __atomic_load_n(&gm_cli_cmd_index, __ATOMIC_ACQUIRE)
+#define GM_CLI_CMD_INDEX_OK()       __atomic_load_n(&gm_cli_mgr.cmd_index_ok, __ATOMIC_ACQUIRE)
+/* 删除标记 */
+#define GM_CLI_CMD_INDEX_DELETED    ((const gm_cli_cmd_t*)&gm_cli_cmd_index_buf[0][0])
 #else
-    gm_cli_mgr.p_cmd_start = NULL;
-    gm_cli_mgr.p_cmd_end = NULL;
-#endif
+/* 命令查找哈希索引，开放寻址，删除的位置放入删除标记 */
+static const gm_cli_cmd_t* gm_cli_cmd_index[GM_CLI_CMD_INDEX_SIZE];
+#define GM_CLI_CMD_INDEX_LOAD()     gm_cli_cmd_index
+#define GM_CLI_CMD_INDEX_OK()       gm_cli_mgr.cmd_index_ok
+/* 删除标记 */
+#define GM_CLI_CMD_INDEX_DELETED    ((const gm_cli_cmd_t*)&gm_cli_cmd_index[0])
+#endif  /* GM_CLI_PLUGIN_EN */
 
-    gm_cli_mgr.input_count = 0;
-    gm_cli_mgr.input_cusor = 0;
-    gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
-    gm_cli_mgr.pf_outchar = NULL;
-    gm_cli_mgr.p_cmd_notice = GM_CLI_DEFAULT_CMD_PROMPT;
+/* 命令名哈希，FNV-1a */
+static unsigned int gm_cli_cmd_hash(const char* str)
+{
+    unsigned long hash = 2166136261ul;
 
-    memset(gm_cli_mgr.line, 0, sizeof(gm_cli_mgr.line));
-    memset(gm_cli_mgr.printf_str, 0, sizeof(gm_cli_mgr.printf_str));
-    memset(gm_cli_mgr.backup_str, 0, sizeof(gm_cli_mgr.backup_str));
-    memset(gm_cli_mgr.history_str, 0, sizeof(gm_cli_mgr.history_str));
+    while (*str != '\0')
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619ul;
+    }
+    return (unsigned int)(hash & (GM_CLI_CMD_INDEX_SIZE - 1));
 }
 
-/* 设置输出字符回调函数 */
-void gm_cli_set_out_char_cb(gm_cli_out_char_cb_t *out_char_cb)
+/* 索引中查找命令 */
+static const gm_cli_cmd_t* gm_cli_cmd_index_find(const char* const name)
 {
-    if (out_char_cb != NULL)
+    const gm_cli_cmd_t* const* p_index = GM_CLI_CMD_INDEX_LOAD();
+    unsigned int i = gm_cli_cmd_hash(name), n;
+    const gm_cli_cmd_t* p_cmd;
+
+    for (n = 0; n < GM_CLI_CMD_INDEX_SIZE; n++)
     {
-        gm_cli_mgr.pf_outchar = out_char_cb;
+        p_cmd = p_index[i];
+        if (p_cmd == NULL)
+        {
+            break;
+        }
+        if ((p_cmd != GM_CLI_CMD_INDEX_DELETED) && (strcmp(p_cmd->name, name) == 0))
+        {
+            return p_cmd;
+        }
+        i = (i + 1) & (GM_CLI_CMD_INDEX_SIZE - 1);
     }
+    return NULL;
 }
 
-/* 设置命令提示符 */
-void gm_cli_set_cmd_prompt(const char* const p_notice)
+/* 命令加入索引，同名命令以先加入的为准，返回：0 - 成功，-1 - 索引已满 */
+static int gm_cli_cmd_index_add(const gm_cli_cmd_t** const p_index, const gm_cli_cmd_t* const p_cmd)
 {
-    if (p_notice != NULL)
+    unsigned int i = gm_cli_cmd_hash(p_cmd->name), n;
+    const gm_cli_cmd_t** pp_slot = NULL;
+
+    for (n = 0; n < GM_CLI_CMD_INDEX_SIZE; n++)
     {
-        gm_cli_mgr.p_cmd_notice = p_notice;
+        if (p_index[i] == NULL)
+        {
+            if (pp_slot == NULL)
+            {
+                pp_slot = &p_index[i];
+            }
+            break;
+        }
+        if (p_index[i] == GM_CLI_CMD_INDEX_DELETED)
+        {
+            if (pp_slot == NULL)
+            {
+                pp_slot = &p_index[i];
+            }
+        }
+        else if (strcmp(p_index[i]->name, p_cmd->name) == 0)
+        {
+            return 0;
+        }
+        i = (i + 1) & (GM_CLI_CMD_INDEX_SIZE - 1);
     }
-    else
+    if (pp_slot == NULL)
     {
-        gm_cli_mgr.p_cmd_notice = GM_CLI_DEFAULT_CMD_PROMPT;
+        return -1;
     }
+    *pp_slot = p_cmd;
+    return 0;
 }
 
-/* 启动命令行 */
-void gm_cli_start(void)
+#if GM_CLI_ALIAS_EN
+/* 命令从索引中删除 */
+static void gm_cli_cmd_index_del(const gm_cli_cmd_t* const p_cmd)
 {
-    gm_cli_put_str("\r\n");
-    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
-}
+    unsigned int i = gm_cli_cmd_hash(p_cmd->name), n;
 
-/* 打印字符 */
-void gm_cli_put_char(const char ch)
-{
-    if (gm_cli_mgr.pf_outchar != NULL)
+    for (n = 0; n < GM_CLI_CMD_INDEX_SIZE; n++)
     {
-        gm_cli_mgr.pf_outchar(ch);
+        if (gm_cli_cmd_index[i] == NULL)
+        {
+            break;
+        }
+        if (gm_cli_cmd_index[i] == p_cmd)
+        {
+            /* 后面没有冲突的命令时直接置空，否则放入删除标记 */
+            gm_cli_cmd_index[i] = (gm_cli_cmd_index[(i + 1) & (GM_CLI_CMD_INDEX_SIZE - 1)] == NULL) ?
+                                  NULL : GM_CLI_CMD_INDEX_DELETED;
+            break;
+        }
+        i = (i + 1) & (GM_CLI_CMD_INDEX_SIZE - 1);
     }
 }
+#endif  /* GM_CLI_ALIAS_EN */
 
-/* 打印字符串 */
-void gm_cli_put_str(const char* const str)
+/* 建立命令索引，含运行时别名，索引放不下时改为逐个查找 */
+static void gm_cli_cmd_index_build(void)
 {
-    const char* ptemp = str;
-    if (str == NULL)
+    const gm_cli_cmd_t* p_temp = (const gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+#if GM_CLI_PLUGIN_EN
+    /* 写入未发布的一份，先等还在查找这一份的读者退出 */
+    const gm_cli_cmd_t** p_index = gm_cli_cmd_index_buf[gm_cli_cmd_index == gm_cli_cmd_index_buf[0]];
+#else
+    const gm_cli_cmd_t** p_index = gm_cli_cmd_index;
+#endif  /* GM_CLI_PLUGIN_EN */
+    int ok = 1;
+#if GM_CLI_ALIAS_EN
+    unsigned int i;
+#endif  /* GM_CLI_ALIAS_EN */
+
+#if GM_CLI_PLUGIN_EN
+    gm_cli_rcu_sync();
+#endif  /* GM_CLI_PLUGIN_EN */
+    memset(p_index, 0, GM_CLI_CMD_INDEX_SIZE * sizeof(p_index[0]));
+    while (p_temp != NULL)
     {
-        return;
+        if (gm_cli_cmd_index_add(p_index, p_temp) != 0)
+        {
+            ok = 0;
+            break;
+        }
+        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
     }
-    if (gm_cli_mgr.pf_outchar != NULL)
+#if GM_CLI_ALIAS_EN
+    for (i = 0; ok && (i < GM_CLI_ALIAS_NUM); i++)
     {
-        while (*ptemp)
+        if ((gm_cli_alias[i].cmd.name != NULL) && (gm_cli_cmd_index_add(p_index, &gm_cli_alias[i].cmd) != 0))
         {
-            gm_cli_mgr.pf_outchar(*ptemp);
-            ptemp++;
+            ok = 0;
         }
     }
-}
-
-/* 通用打印函数，替代默认printf */
-void gm_cli_printf(const char* const fmt, ...)
-{
-    va_list ap;
-
-    va_start(ap, fmt);
-
-#if (GM_CLI_CC == GM_CLI_CC_VS) || ((GM_CLI_CC == GM_CLI_CC_ANY) && defined _MSC_VER)
-    vsprintf_s(gm_cli_mgr.printf_str, sizeof(gm_cli_mgr.printf_str), fmt, ap);
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_PLUGIN_EN
+    __atomic_store_n(&gm_cli_cmd_index, p_index, __ATOMIC_RELEASE);
+    __atomic_store_n(&gm_cli_mgr.cmd_index_ok, ok, __ATOMIC_RELEASE);
 #else
-    vsprintf(gm_cli_mgr.printf_str, fmt, ap);
-#endif
-    gm_cli_put_str(gm_cli_mgr.printf_str);
-
-    va_end(ap);
+    gm_cli_mgr.cmd_index_ok = ok;
+#endif  /* GM_CLI_PLUGIN_EN */
 }
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
 
-/* 上键处理 */
-static void gm_cli_parse_up_key(void)
+/* 搜索命令，含运行时别名 */
+static const gm_cli_cmd_t* gm_cli_search_cmd(const char* const cmd_name)
 {
-    unsigned int len;
+    const gm_cli_cmd_t* p_ret = NULL;
+    const gm_cli_cmd_t* p_temp;
 
-    if (gm_cli_mgr.history_total == 0)
+    GM_CLI_TRACE(GM_CLI_TRACE_LOOKUP | GM_CLI_TRACE_BEGIN, 0);
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    if (GM_CLI_CMD_INDEX_OK())
     {
-        /* 无记录 */
-        return;
+        p_ret = gm_cli_cmd_index_find(cmd_name);
+        GM_CLI_TRACE(GM_CLI_TRACE_LOOKUP | GM_CLI_TRACE_END, p_ret != NULL);
+        return p_ret;
     }
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
 
-    if (gm_cli_mgr.history_inquire_count == 0)
-    {
-        /* 从未上翻记录，备份当前输入 */
-        memcpy(gm_cli_mgr.backup_str, gm_cli_mgr.line, sizeof(gm_cli_mgr.line));
-        /* 搜索记录位置设置到当前记录处 */
-        gm_cli_mgr.history_inquire_index = gm_cli_mgr.history_index;
-    }
+    p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
 
-    /* 查看是否已经搜索完成 */
-    if (gm_cli_mgr.history_inquire_count < gm_cli_mgr.history_total)
+    while (p_temp != NULL)
     {
-        /* 搜索编号往前找一个记录编号 */
-        if (gm_cli_mgr.history_inquire_index == 0)
-        {
-            gm_cli_mgr.history_inquire_index = GM_CLI_HISTORY_LINE_MAX - 1;
-        }
-        else
-        {
-            gm_cli_mgr.history_inquire_index--;
-        }
-        /* 搜索数量加1 */
-        gm_cli_mgr.history_inquire_count++;
-        /* 光标之后的行数据清除掉 */
-        len = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
-        for (unsigned int i = 0; i < len; i++)
-        {
-            gm_cli_put_char(' ');
-        }
-        /* 清除所有的行数据 */
-        for (unsigned int i = 0; i < gm_cli_mgr.input_count; i++)
+        if (strcmp(p_temp->name, cmd_name) == 0)
         {
-            gm_cli_put_str("\b \b");
+            p_ret = p_temp;
+            break;
         }
+        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+    }
 
-        /* 导入历史输入 */
-        memcpy(gm_cli_mgr.line, gm_cli_mgr.history_str[gm_cli_mgr.history_inquire_index], sizeof(gm_cli_mgr.line));
-        gm_cli_mgr.input_count = (unsigned int)strlen(gm_cli_mgr.line);
-        gm_cli_mgr.input_cusor = gm_cli_mgr.input_count;
-        /* 显示历史记录 */
-        gm_cli_put_str(gm_cli_mgr.line);
+#if GM_CLI_ALIAS_EN
+    if (p_ret == NULL)
+    {
+        p_ret = gm_cli_alias_find(cmd_name);
     }
+#endif  /* GM_CLI_ALIAS_EN */
+
+    GM_CLI_TRACE(GM_CLI_TRACE_LOOKUP | GM_CLI_TRACE_END, p_ret != NULL);
+    return p_ret;
 }
 
-/* 下键处理 */
-static void gm_cli_parse_down_key(void)
+#if GM_CLI_SUGGEST_EN
+#if (GM_CLI_SUGGEST_NODE_NUM > 65535)
+#error "GM_CLI_SUGGEST_NODE_NUM must be less than 65536"
+#endif
+
+/* 参与提示的命令名最大长度，包括'\0'，更长的命令不提示 */
+#define GM_CLI_SUGGEST_NAME_MAX     32u
+/* BK树最大深度，超过时改为逐个比较 */
+#define GM_CLI_SUGGEST_DEPTH_MAX    32u
+
+/* BK树节点，子节点以链表存放，序号从1开始，0表示无 */
+typedef struct
 {
-    unsigned int len;
+    const gm_cli_cmd_t*   p_cmd;                         /* 命令 */
+    unsigned short        child;                         /* 第一个子节点 */
+    unsigned short        next;                          /* 下一个兄弟节点 */
+    unsigned char         dist;                          /* 到父节点的编辑距离 */
+} gm_cli_bk_node_t;
 
-    if ((gm_cli_mgr.history_total == 0) ||
-        (gm_cli_mgr.history_inquire_count == 0))
-    {
-        /* 无记录或无上翻 */
-        return;
-    }
+/* 命令名BK树，节点0为根 */
+static gm_cli_bk_node_t gm_cli_bk[GM_CLI_SUGGEST_NODE_NUM];
 
-    /* 查询数量减一 */
-    gm_cli_mgr.history_inquire_count--;
-    /* 删除当前行内容 */
-    len = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
-    for (unsigned int i = 0; i < len; i++)
-    {
-        gm_cli_put_char(' ');
-    }
-    for (unsigned int i = 0; i < gm_cli_mgr.input_count; i++)
+/* 编辑距离，超过bound时返回bound + 1 */
+static unsigned int gm_cli_edit_dist(const char* const a, const char* const b,
+                                     const unsigned int bound)
+{
+    unsigned char row[GM_CLI_SUGGEST_NAME_MAX];
+    unsigned int len_a = (unsigned int)strlen(a), len_b = (unsigned int)strlen(b);
+    unsigned int i, j, diag, up, min, val;
+
+    if ((len_a >= GM_CLI_SUGGEST_NAME_MAX) || (len_b >= GM_CLI_SUGGEST_NAME_MAX) ||
+        (((len_a > len_b) ? (len_a - len_b) : (len_b - len_a)) > bound))
     {
-        gm_cli_put_str("\b \b");
+        return bound + 1;
     }
 
-    if (gm_cli_mgr.history_inquire_count == 0)
+    for (j = 0; j <= len_b; j++)
     {
-        /* 恢复备份的输入 */
-        memcpy(gm_cli_mgr.line, gm_cli_mgr.backup_str, sizeof(gm_cli_mgr.line));
+        row[j] = (unsigned char)j;
     }
-    else
+    for (i = 1; i <= len_a; i++)
     {
-        /* 更新索引 */
-        gm_cli_mgr.history_inquire_index++;
-        gm_cli_mgr.history_inquire_index %= GM_CLI_HISTORY_LINE_MAX;
-        /* 取出历史 */
-        memcpy(gm_cli_mgr.line, gm_cli_mgr.history_str[gm_cli_mgr.history_inquire_index], sizeof(gm_cli_mgr.line));
+        diag = row[0];
+        row[0] = (unsigned char)i;
+        min = i;
+        for (j = 1; j <= len_b; j++)
+        {
+            up = row[j];
+            val = diag + (a[i - 1] != b[j - 1]);
+            if (up + 1 < val)
+            {
+                val = up + 1;
+            }
+            if ((unsigned int)row[j - 1] + 1 < val)
+            {
+                val = row[j - 1] + 1;
+            }
+            row[j] = (unsigned char)val;
+            diag = up;
+            if (val < min)
+            {
+                min = val;
+            }
+        }
+        /* 本行最小值已超过上限，后面只会更大 */
+        if (min > bound)
+        {
+            return bound + 1;
+        }
     }
 
-    /* 重新更新坐标 */
-    gm_cli_mgr.input_count = (unsigned int)strlen(gm_cli_mgr.line);
-    gm_cli_mgr.input_cusor = gm_cli_mgr.input_count;
-    /* 显示输入行 */
-    gm_cli_put_str(gm_cli_mgr.line);
+    return (row[len_b] > bound) ? (bound + 1) : row[len_b];
 }
 
-/* 左键处理 */
-static void gm_cli_parse_left_key(void)
+/* 命令加入BK树，重名的忽略，返回：0 - 成功，-1 - 节点不够或树太深 */
+static int gm_cli_bk_insert(const gm_cli_cmd_t* const p_cmd)
 {
-    if (gm_cli_mgr.input_cusor > 0)
-    {
-        gm_cli_put_char('\b');
-        gm_cli_mgr.input_cusor--;
-    }
-}
+    unsigned int cur = 0, depth = 1, dist, child;
 
-/* 右键处理 */
-static void gm_cli_parse_right_key(void)
-{
-    if ((gm_cli_mgr.input_count > 0) &&
-        (gm_cli_mgr.input_cusor < gm_cli_mgr.input_count))
+    if (strlen(p_cmd->name) >= GM_CLI_SUGGEST_NAME_MAX)
     {
-        gm_cli_put_char(gm_cli_mgr.line[gm_cli_mgr.input_cusor]);
-        gm_cli_mgr.input_cusor++;
+        return 0;
     }
-}
-
-/* 功能键处理返回：0 - 已处理的功能字符，-1 - 未处理的字符 */
-static int gm_cli_parse_func_key(const char ch)
-{
-    /* XSHELL终端，超级终端等功能码 */
-    if (ch == (char)0x1B)
+    if (gm_cli_mgr.bk_num == 0)
     {
-        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_SPEC_KEY;
+        gm_cli_bk[0].p_cmd = p_cmd;
+        gm_cli_bk[0].child = 0;
+        gm_cli_bk[0].next = 0;
+        gm_cli_bk[0].dist = 0;
+        gm_cli_mgr.bk_num = 1;
         return 0;
     }
-    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_SPEC_KEY)
-    {
-        if (ch == (char)0x5b)
-        {
-            gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_FUNC_KEY;
-            return 0;
-        }
 
-        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
-    }
-    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_FUNC_KEY)
+    while (1)
     {
-        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
-
-        if (ch == (char)0x41)      /* 上 */
+        dist = gm_cli_edit_dist(p_cmd->name, gm_cli_bk[cur].p_cmd->name, GM_CLI_SUGGEST_NAME_MAX);
+        if (dist == 0)
         {
-            gm_cli_parse_up_key();
             return 0;
         }
-        else if (ch == (char)0x42) /* 下 */
+        for (child = gm_cli_bk[cur].child; child != 0; child = gm_cli_bk[child - 1].next)
         {
-            gm_cli_parse_down_key();
-            return 0;
+            if (gm_cli_bk[child - 1].dist == dist)
+            {
+                break;
+            }
         }
-        else if (ch == (char)0x44) /* 左 */
+        if (child == 0)
         {
-            gm_cli_parse_left_key();
-            return 0;
+            break;
         }
-        else if (ch == (char)0x43) /* 右 */
+        cur = child - 1;
+        if (++depth >= GM_CLI_SUGGEST_DEPTH_MAX)
         {
-            gm_cli_parse_right_key();
-            return 0;
+            return -1;
         }
     }
 
-#if (GM_CLI_CC == GM_CLI_CC_VS) || (GM_CLI_CC == GM_CLI_CC_MINGW) || \
-    ((GM_CLI_CC == GM_CLI_CC_ANY) && defined _MSC_VER)
-    /* windows命令行功能码 */
+    if (gm_cli_mgr.bk_num >= GM_CLI_SUGGEST_NODE_NUM)
+    {
+        return -1;
+    }
+    child = gm_cli_mgr.bk_num++;
+    gm_cli_bk[child].p_cmd = p_cmd;
+    gm_cli_bk[child].child = 0;
+    gm_cli_bk[child].next = gm_cli_bk[cur].child;
+    gm_cli_bk[child].dist = (unsigned char)dist;
+    gm_cli_bk[cur].child = (unsigned short)(child + 1);
+    return 0;
+}
+
+/* 建立命令名BK树，放不下时改为逐个比较 */
+static void gm_cli_bk_build(void)
+{
+    const gm_cli_cmd_t* p_temp = (const gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+
+    gm_cli_mgr.bk_num = 0;
+    gm_cli_mgr.bk_ok = 1;
+    while (p_temp != NULL)
+    {
+        if (gm_cli_bk_insert(p_temp) != 0)
+        {
+            gm_cli_mgr.bk_ok = 0;
+            break;
+        }
+        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+    }
+}
+
+/* 提示结果按距离从小到大插入，距离相同的先找到的在前 */
+static void gm_cli_suggest_add(const gm_cli_cmd_t* p_list[], unsigned int dist_list[],
+                               const gm_cli_cmd_t* const p_cmd, const unsigned int dist)
+{
+    unsigned int i, j;
+
+    for (i = 0; i < GM_CLI_SUGGEST_NUM; i++)
+    {
+        if (p_list[i] == p_cmd)
+        {
+            return;
+        }
+        if ((p_list[i] == NULL) || (dist < dist_list[i]))
+        {
+            break;
+        }
+    }
+    if (i == GM_CLI_SUGGEST_NUM)
+    {
+        return;
+    }
+    for (j = GM_CLI_SUGGEST_NUM - 1; j > i; j--)
+    {
+        p_list[j] = p_list[j - 1];
+        dist_list[j] = dist_list[j - 1];
+    }
+    p_list[i] = p_cmd;
+    dist_list[i] = dist;
+}
+
+/* 查找和name编辑距离在bound以内的命令 */
+static void gm_cli_suggest_find(const char* const name, const unsigned int bound,
+                                const gm_cli_cmd_t* p_list[], unsigned int dist_list[])
+{
+    unsigned short stack[GM_CLI_SUGGEST_DEPTH_MAX * (GM_CLI_SUGGEST_DIST_MAX * 2 + 1)];
+    const gm_cli_cmd_t* p_temp;
+    unsigned int top = 0, node, dist, child, limit;
+
+    if (gm_cli_mgr.bk_ok && (gm_cli_mgr.bk_num > 0))
+    {
+        /* 三角不等式，只有到当前节点距离在[dist - bound, dist + bound]内的子树才可能命中 */
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            node = stack[--top];
+            /* 距离超过最远的子树加bound时不会有命中，不需要算出准确的距离 */
+            limit = 0;
+            for (child = gm_cli_bk[node].child; child != 0; child = gm_cli_bk[child - 1].next)
+            {
+                if (gm_cli_bk[child - 1].dist > limit)
+                {
+                    limit = gm_cli_bk[child - 1].dist;
+                }
+            }
+            dist = gm_cli_edit_dist(name, gm_cli_bk[node].p_cmd->name, limit + bound);
+            if (dist <= bound)
+            {
+                gm_cli_suggest_add(p_list, dist_list, gm_cli_bk[node].p_cmd, dist);
+            }
+            for (child = gm_cli_bk[node].child; child != 0; child = gm_cli_bk[child - 1].next)
+            {
+                if ((gm_cli_bk[child - 1].dist + bound >= dist) &&
+                    (gm_cli_bk[child - 1].dist <= dist + bound) &&
+                    (top < sizeof(stack) / sizeof(stack[0])))
+                {
+                    stack[top++] = (unsigned short)(child - 1);
+                }
+            }
+        }
+    }
+    else
+    {
+        p_temp = (const gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+        while (p_temp != NULL)
+        {
+            dist = gm_cli_edit_dist(name, p_temp->name, bound);
+            if (dist <= bound)
+            {
+                gm_cli_suggest_add(p_list, dist_list, p_temp, dist);
+            }
+            p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+        }
+    }
+
+#if GM_CLI_ALIAS_EN
+    /* 运行时别名数量少，逐个比较 */
+    for (node = 0; node < GM_CLI_ALIAS_NUM; node++)
+    {
+        if (gm_cli_alias[node].cmd.name != NULL)
+        {
+            dist = gm_cli_edit_dist(name, gm_cli_alias[node].cmd.name, bound);
+            if (dist <= bound)
+            {
+                gm_cli_suggest_add(p_list, dist_list, &gm_cli_alias[node].cmd, dist);
+            }
+        }
+    }
+#endif  /* GM_CLI_ALIAS_EN */
+}
+#endif  /* GM_CLI_SUGGEST_EN */
+
+/* 输出找不到命令的提示，使能命令提示时列出相近的命令 */
+static void gm_cli_put_not_found(const char* const name)
+{
+#if GM_CLI_SUGGEST_EN
+    const gm_cli_cmd_t* p_list[GM_CLI_SUGGEST_NUM];
+    unsigned int dist_list[GM_CLI_SUGGEST_NUM];
+    unsigned int i, len = (unsigned int)strlen(name);
+#endif  /* GM_CLI_SUGGEST_EN */
+
+    gm_cli_put_str("Not found command \"");
+    gm_cli_put_str(name);
+    gm_cli_put_str("\"\r\n");
+
+#if GM_CLI_SUGGEST_EN
+    if (len == 0)
+    {
+        return;
+    }
+    for (i = 0; i < GM_CLI_SUGGEST_NUM; i++)
+    {
+        p_list[i] = NULL;
+    }
+    /* 短的输入只允许差一个字符，否则几乎所有短命令都会命中 */
+    gm_cli_suggest_find(name, (len <= 3) ? 1 : GM_CLI_SUGGEST_DIST_MAX, p_list, dist_list);
+    if (p_list[0] == NULL)
+    {
+        return;
+    }
+    gm_cli_put_str("Did you mean: ");
+    for (i = 0; (i < GM_CLI_SUGGEST_NUM) && (p_list[i] != NULL); i++)
+    {
+        if (i > 0)
+        {
+            gm_cli_put_str(", ");
+        }
+        gm_cli_put_str(p_list[i]->name);
+    }
+    gm_cli_put_str("?\r\n");
+#endif  /* GM_CLI_SUGGEST_EN */
+}
+
+/* 初始化cli管理器 */
+void gm_cli_mgr_init(void)
+{
+#if (GM_CLI_CC == GM_CLI_CC_MDK_ARM)
+    extern const int gm_cli_cmd_section$$Base;
+    extern const int gm_cli_cmd_section$$Limit;
+    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_cmd_section$$Base;
+    gm_cli_mgr.p_cmd_end   = (const int*)&gm_cli_cmd_section$$Limit;
+#elif  (GM_CLI_CC == GM_CLI_CC_GCC_LINUX)
+    extern const gm_cli_cmd_t gm_cli_cmd_section_start;
+    extern const gm_cli_cmd_t gm_cli_cmd_section_end;
+    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_cmd_section_start;
+    gm_cli_mgr.p_cmd_end   = (const int*)&gm_cli_cmd_section_end;
+#elif ((GM_CLI_CC == GM_CLI_CC_IAR_ARM) || (GM_CLI_CC == GM_CLI_CC_IAR_STM8))
+    gm_cli_mgr.p_cmd_start = (const int*)__section_begin(".gm_cli_cmd_section");
+    gm_cli_mgr.p_cmd_end = (const int*)__section_end(".gm_cli_cmd_section");
+#elif (GM_CLI_CC == GM_CLI_CC_VS) || (GM_CLI_CC == GM_CLI_CC_MINGW)
+    unsigned int* ptr_begin, *ptr_end;
+
+    /* 找寻起始位置 */
+    ptr_begin = (unsigned int*)&__gm_cli_cmd_begin;
+    ptr_begin += (sizeof(gm_cli_cmd_t) / sizeof(unsigned int));
+    while ((*ptr_begin) == 0) ptr_begin++;
+
+    /* 找寻终止位置 */
+    ptr_end = (unsigned int *)&__gm_cli_cmd_end;
+    ptr_end--;
+    while ((*ptr_end) == 0) ptr_end--;
+
+    /* 判断是否合法 */
+    if (ptr_begin < ptr_end)
+    {
+        gm_cli_mgr.p_cmd_start = (const int*)(ptr_begin);
+        gm_cli_mgr.p_cmd_end   = (const int*)(ptr_end);
+    }
+    else
+    {
+        gm_cli_mgr.p_cmd_start = NULL;
+        gm_cli_mgr.p_cmd_end   = NULL;
+    }
+#elif (GM_CLI_CC == GM_CLI_CC_ANY)
+    gm_cli_mgr.p_cmd_start = (const int*)&gm_cli_static_cmds[0];
+    const gm_cli_cmd_t *ptr = &gm_cli_static_cmds[0];
+    while (ptr->name != NULL) ptr++;
+    gm_cli_mgr.p_cmd_end = (const int*)ptr;
+#else
+    gm_cli_mgr.p_cmd_start = NULL;
+    gm_cli_mgr.p_cmd_end = NULL;
+#endif
+
+#if GM_CLI_ALIAS_EN
+    memset(gm_cli_alias, 0, sizeof(gm_cli_alias));
+    gm_cli_mgr.alias_used = 0;
+    gm_cli_mgr.alias_running = 0;
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_VAR_EN
+    memset(gm_cli_var, 0, sizeof(gm_cli_var));
+    gm_cli_mgr.var_num = 0;
+    gm_cli_mgr.var_gen = 0;
+#endif  /* GM_CLI_VAR_EN */
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    gm_cli_cmd_index_build();
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
+#if GM_CLI_SUGGEST_EN
+    gm_cli_bk_build();
+#endif  /* GM_CLI_SUGGEST_EN */
+
+    gm_cli_mgr.input_count = 0;
+    gm_cli_mgr.input_cusor = 0;
+    gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+    gm_cli_mgr.pf_outchar = NULL;
+    gm_cli_mgr.pf_outbuf = NULL;
+#if GM_CLI_BRACKETED_PASTE_EN
+    gm_cli_mgr.paste_mode = 0;
+    gm_cli_mgr.paste_match = 0;
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_BIN_EN
+    gm_cli_mgr.bin_mode = 0;
+    gm_cli_mgr.bin_match = 0;
+#endif  /* GM_CLI_BIN_EN */
+#if GM_CLI_EMIT_EN
+    gm_cli_mgr.emit_fmt = GM_CLI_FMT_TEXT;
+    gm_cli_mgr.emit_cur_fmt = GM_CLI_FMT_TEXT;
+    gm_cli_mgr.emit_depth = 0;
+#endif  /* GM_CLI_EMIT_EN */
+#if GM_CLI_TRACE_EN
+    gm_cli_mgr.trace_pos = 0;
+    gm_cli_mgr.trace_on = 1;
+#endif  /* GM_CLI_TRACE_EN */
+#if GM_CLI_LOG_EN
+    gm_cli_log_init();
+#endif  /* GM_CLI_LOG_EN */
+#if GM_CLI_REC_EN
+    gm_cli_mgr.pf_rec_write = NULL;
+    gm_cli_mgr.rec_len = 0;
+#endif  /* GM_CLI_REC_EN */
+#if GM_CLI_BUDGET_EN
+    gm_cli_mgr.p_run_cmd = NULL;
+    gm_cli_atomic_store(&gm_cli_mgr.run_active, 0);
+    gm_cli_atomic_store(&gm_cli_mgr.run_abort, GM_CLI_ABORT_NONE);
+    gm_cli_mgr.wdog_overruns = 0;
+    gm_cli_mgr.wdog_aborts = 0;
+    gm_cli_mgr.wdog_max_ms = 0;
+    gm_cli_mgr.wdog_last_name[0] = '\0';
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_CALL_EN
+    gm_cli_mgr.p_sym_table = NULL;
+    gm_cli_mgr.sym_num = 0;
+#endif  /* GM_CLI_CALL_EN */
+#if GM_CLI_OUT_SCHED_EN
+    gm_cli_mgr.out_class = GM_CLI_OUT_BULK;
+    gm_cli_mgr.out_head = 0;
+    gm_cli_mgr.out_len = 0;
+    gm_cli_mgr.out_prompt = 0;
+    gm_cli_mgr.out_dirty = 0;
+#if GM_CLI_MEM_EN
+    gm_cli_mgr.mem_width = 0;
+#endif  /* GM_CLI_MEM_EN */
+#if (GM_CLI_OUT_BULK_RATE > 0)
+    gm_cli_mgr.out_credit = GM_CLI_OUT_BULK_CHUNK;
+    gm_cli_mgr.out_stamp = 0;
+#endif  /* GM_CLI_OUT_BULK_RATE */
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    gm_cli_mgr.p_cmd_notice = GM_CLI_DEFAULT_CMD_PROMPT;
+    gm_cli_mgr.term_sink.write = gm_cli_term_sink_write;
+    gm_cli_mgr.term_sink.next = NULL;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.term_sink;
+
+    gm_cli_set_line_arena(gm_cli_line_arena, sizeof(gm_cli_line_arena), GM_CLI_LINE_CHAR_MAX);
+}
+
+/* 设置行存储区 */
+int gm_cli_set_line_arena(char* const p_arena, const unsigned int arena_size,
+                          const unsigned int line_size)
+{
+    /* 行缓存至少能存放一个字符和'\0'，历史记录池至少能存放一整行 */
+    if ((p_arena == NULL) || (line_size < 2) || (arena_size / 3 < line_size) ||
+        (arena_size > GM_CLI_POS_MAX))
+    {
+        return -1;
+    }
+
+    gm_cli_mgr.line = p_arena;
+    gm_cli_mgr.line_size = line_size;
+    gm_cli_mgr.line_gap_end = line_size;
+    gm_cli_mgr.input_count = 0;
+    gm_cli_mgr.input_cusor = 0;
+    gm_cli_mgr.line[0] = '\0';
+    gm_cli_mgr.backup_str = p_arena + line_size;
+    gm_cli_mgr.backup_str[0] = '\0';
+    gm_cli_mgr.history_pool = p_arena + line_size * 2;
+    gm_cli_mgr.history_pool_size = arena_size - line_size * 2;
+    gm_cli_mgr.history_pool_pos = 0;
+    gm_cli_mgr.history_pool_used = 0;
+    gm_cli_mgr.history_total = 0;
+    gm_cli_mgr.history_index = 0;
+    gm_cli_mgr.history_inquire_index = 0;
+    gm_cli_mgr.history_inquire_count = 0;
+
+    return 0;
+}
+
+/* 设置输出字符回调函数 */
+void gm_cli_set_out_char_cb(gm_cli_out_char_cb_t *out_char_cb)
+{
+    if (out_char_cb != NULL)
+    {
+        gm_cli_mgr.pf_outchar = out_char_cb;
+    }
+}
+
+/* 设置批量输出回调函数 */
+void gm_cli_set_out_buf_cb(gm_cli_out_buf_cb_t *out_buf_cb)
+{
+    gm_cli_mgr.pf_outbuf = out_buf_cb;
+}
+
+/* 设置时基回调函数 */
+void gm_cli_set_tick_cb(gm_cli_tick_cb_t *tick_cb)
+{
+    gm_cli_mgr.pf_tick = tick_cb;
+}
+
+/* 设置命令提示符 */
+void gm_cli_set_cmd_prompt(const char* const p_notice)
+{
+    if (p_notice != NULL)
+    {
+        gm_cli_mgr.p_cmd_notice = p_notice;
+    }
+    else
+    {
+        gm_cli_mgr.p_cmd_notice = GM_CLI_DEFAULT_CMD_PROMPT;
+    }
+}
+
+/* 启动命令行 */
+void gm_cli_start(void)
+{
+#if GM_CLI_OUT_SCHED_EN
+    /* 启动输出和第一个提示符是交互输出，不排在批量输出后面，否则先按下的键的回显
+     * 会出现在提示符之前 */
+    unsigned int out_class = gm_cli_mgr.out_class;
+
+    gm_cli_mgr.out_class = GM_CLI_OUT_INTERACTIVE;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#if GM_CLI_BRACKETED_PASTE_EN
+    /* 开启终端的括号粘贴模式，粘贴内容前后会带有标记 */
+    gm_cli_put_str("\x1b[?2004h");
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+    gm_cli_put_str("\r\n");
+    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+#if GM_CLI_OUT_SCHED_EN
+    gm_cli_mgr.out_class = out_class;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+}
+
+/* 停止命令行 */
+void gm_cli_stop(void)
+{
+#if GM_CLI_OUT_SCHED_EN
+    unsigned int out_class = gm_cli_mgr.out_class;
+
+    /* 未发送的批量输出全部发送，提示符不再显示 */
+    gm_cli_out_send(gm_cli_mgr.out_len);
+    gm_cli_mgr.out_prompt = 0;
+    gm_cli_mgr.out_class = GM_CLI_OUT_INTERACTIVE;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#if GM_CLI_BRACKETED_PASTE_EN
+    /* 关闭终端的括号粘贴模式，否则退出后shell中粘贴的内容会带有标记 */
+    gm_cli_put_str("\x1b[?2004l");
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_OUT_SCHED_EN
+    gm_cli_mgr.out_class = out_class;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+}
+
+#if GM_CLI_REC_EN
+/* 会话记录格式：
+ * 文件头 "GMREC" + 版本(2) + 标志(1)，标志位0为1时时间单位为ms，为0时没有时基
+ * 记录   类型(1) + 距上一条记录的时间(变长) + 数据长度(变长) + 数据
+ * 类型0为输入，1为终端输出，2为结束，3为后台处理（没有数据），
+ * 变长整数每字节低7位有效，最高位为1表示后面还有 */
+#define GM_CLI_REC_IN               0u      /* 输入 */
+#define GM_CLI_REC_OUT              1u      /* 终端输出 */
+#define GM_CLI_REC_END              2u      /* 结束 */
+#define GM_CLI_REC_POLL             3u      /* 后台处理 */
+
+/* 编码变长整数，返回编码长度 */
+static unsigned int gm_cli_rec_varint(unsigned char* const p, unsigned long val)
+{
+    unsigned int n = 0;
+
+    while (val >= 0x80)
+    {
+        p[n++] = (unsigned char)(val | 0x80);
+        val >>= 7;
+    }
+    p[n++] = (unsigned char)val;
+    return n;
+}
+
+/* 写入待写入的记录 */
+static void gm_cli_rec_flush(void)
+{
+    unsigned char head[1 + 10 + 5];
+    unsigned int n;
+
+    head[0] = (unsigned char)gm_cli_mgr.rec_type;
+    n = 1 + gm_cli_rec_varint(&head[1], gm_cli_mgr.rec_stamp - gm_cli_mgr.rec_last);
+    n += gm_cli_rec_varint(&head[n], gm_cli_mgr.rec_len);
+    gm_cli_mgr.pf_rec_write((const char*)head, n);
+    if (gm_cli_mgr.rec_len > 0)
+    {
+        gm_cli_mgr.pf_rec_write(gm_cli_mgr.rec_buf, gm_cli_mgr.rec_len);
+    }
+    gm_cli_mgr.rec_last = gm_cli_mgr.rec_stamp;
+    gm_cli_mgr.rec_len = 0;
+}
+
+/* 记录数据，同一毫秒内同方向的数据合并为一条记录 */
+static void gm_cli_rec_put(const unsigned int type, const char* buf, unsigned int len)
+{
+    unsigned long now;
+    unsigned int n;
+
+    if (gm_cli_mgr.pf_rec_write == NULL)
+    {
+        return;
+    }
+    now = (gm_cli_mgr.pf_tick != NULL) ? gm_cli_mgr.pf_tick() : 0;
+    while (len > 0)
+    {
+        if ((gm_cli_mgr.rec_len > 0) &&
+            ((type != gm_cli_mgr.rec_type) || (now != gm_cli_mgr.rec_stamp) ||
+             (gm_cli_mgr.rec_len == GM_CLI_REC_BUF_SIZE)))
+        {
+            gm_cli_rec_flush();
+        }
+        gm_cli_mgr.rec_type = type;
+        gm_cli_mgr.rec_stamp = now;
+        n = GM_CLI_REC_BUF_SIZE - gm_cli_mgr.rec_len;
+        n = (n < len) ? n : len;
+        memcpy(&gm_cli_mgr.rec_buf[gm_cli_mgr.rec_len], buf, n);
+        gm_cli_mgr.rec_len += n;
+        buf += n;
+        len -= n;
+    }
+    gm_cli_mgr.rec_dirty = 1;
+}
+
+/* 记录一次后台处理，回放时在同一位置执行，前后都没有记录的后台处理不改变输出，不记录 */
+static void gm_cli_rec_poll(void)
+{
+    if ((gm_cli_mgr.pf_rec_write == NULL) || !gm_cli_mgr.rec_dirty)
+    {
+        return;
+    }
+    if (gm_cli_mgr.rec_len > 0)
+    {
+        gm_cli_rec_flush();
+    }
+    gm_cli_mgr.rec_type = GM_CLI_REC_POLL;
+    gm_cli_mgr.rec_stamp = (gm_cli_mgr.pf_tick != NULL) ? gm_cli_mgr.pf_tick() : 0;
+    gm_cli_rec_flush();
+    gm_cli_mgr.rec_dirty = 0;
+}
+
+/* 开始录制会话 */
+int gm_cli_rec_start(gm_cli_out_buf_cb_t* const write_cb)
+{
+    char head[7] = { 'G', 'M', 'R', 'E', 'C', 2, 0 };
+
+    if ((write_cb == NULL) || (gm_cli_mgr.pf_rec_write != NULL))
+    {
+        return -1;
+    }
+    head[6] = (gm_cli_mgr.pf_tick != NULL) ? 1 : 0;
+    write_cb(head, sizeof(head));
+    gm_cli_mgr.rec_last = (gm_cli_mgr.pf_tick != NULL) ? gm_cli_mgr.pf_tick() : 0;
+    gm_cli_mgr.rec_len = 0;
+    gm_cli_mgr.rec_dirty = 0;
+    gm_cli_mgr.pf_rec_write = write_cb;
+    return 0;
+}
+
+/* 停止录制会话 */
+void gm_cli_rec_stop(void)
+{
+    if (gm_cli_mgr.pf_rec_write == NULL)
+    {
+        return;
+    }
+    if (gm_cli_mgr.rec_len > 0)
+    {
+        gm_cli_rec_flush();
+    }
+    /* 结束记录带有会话总时长 */
+    gm_cli_mgr.rec_type = GM_CLI_REC_END;
+    gm_cli_mgr.rec_stamp = (gm_cli_mgr.pf_tick != NULL) ? gm_cli_mgr.pf_tick() : 0;
+    gm_cli_rec_flush();
+    gm_cli_mgr.pf_rec_write = NULL;
+}
+#endif  /* GM_CLI_REC_EN */
+
+/* 输出到终端 */
+static void gm_cli_term_out(const char* buf, unsigned int len)
+{
+#if GM_CLI_REC_EN
+    gm_cli_rec_put(GM_CLI_REC_OUT, buf, len);
+#endif  /* GM_CLI_REC_EN */
+    GM_CLI_TRACE(GM_CLI_TRACE_OUT | GM_CLI_TRACE_BEGIN, len);
+    if (gm_cli_mgr.pf_outbuf != NULL)
+    {
+        gm_cli_mgr.pf_outbuf(buf, len);
+    }
+    else if (gm_cli_mgr.pf_outchar != NULL)
+    {
+        while (len--)
+        {
+            gm_cli_mgr.pf_outchar(*buf++);
+        }
+    }
+    GM_CLI_TRACE(GM_CLI_TRACE_OUT | GM_CLI_TRACE_END, 0);
+}
+
+#if GM_CLI_OUT_SCHED_EN
+/* 从批量输出缓存发送最多max个字节到终端，返回实际发送的字节数 */
+static unsigned int gm_cli_out_send(unsigned int max)
+{
+    unsigned int n, sent = 0;
+
+    while ((max > 0) && (gm_cli_mgr.out_len > 0))
+    {
+        /* 缓存回绕时分两段发送 */
+        n = GM_CLI_OUT_BULK_BUF_SIZE - gm_cli_mgr.out_head;
+        n = (n < gm_cli_mgr.out_len) ? n : gm_cli_mgr.out_len;
+        n = (n < max) ? n : max;
+        gm_cli_term_out(&gm_cli_mgr.out_buf[gm_cli_mgr.out_head], n);
+        gm_cli_mgr.out_head += n;
+        if (gm_cli_mgr.out_head >= GM_CLI_OUT_BULK_BUF_SIZE)
+        {
+            gm_cli_mgr.out_head = 0;
+        }
+        gm_cli_mgr.out_len -= n;
+        max -= n;
+        sent += n;
+    }
+    return sent;
+}
+
+/* 放入批量输出缓存，缓存满时按终端速度同步发送最早的数据 */
+static void gm_cli_out_push(const char* buf, unsigned int len)
+{
+    unsigned int pos, n;
+
+    while (len > 0)
+    {
+        if (gm_cli_mgr.out_len == GM_CLI_OUT_BULK_BUF_SIZE)
+        {
+            gm_cli_out_send(GM_CLI_OUT_BULK_CHUNK);
+        }
+        pos = gm_cli_mgr.out_head + gm_cli_mgr.out_len;
+        if (pos >= GM_CLI_OUT_BULK_BUF_SIZE)
+        {
+            pos -= GM_CLI_OUT_BULK_BUF_SIZE;
+        }
+        /* 取空闲空间、到缓存末尾的空间和剩余数据中最小的 */
+        n = GM_CLI_OUT_BULK_BUF_SIZE - gm_cli_mgr.out_len;
+        n = (n < GM_CLI_OUT_BULK_BUF_SIZE - pos) ? n : (GM_CLI_OUT_BULK_BUF_SIZE - pos);
+        n = (n < len) ? n : len;
+        memcpy(&gm_cli_mgr.out_buf[pos], buf, n);
+        gm_cli_mgr.out_len += n;
+        buf += n;
+        len -= n;
+    }
+}
+
+/* 批量输出未发送完时推迟显示提示符，返回：0 - 已推迟，-1 - 可以立即显示 */
+static int gm_cli_out_defer_prompt(void)
+{
+#if GM_CLI_MEM_EN
+    if ((gm_cli_mgr.out_len == 0) && !gm_cli_mgr.out_prompt && (gm_cli_mgr.mem_width == 0))
+#else
+    if ((gm_cli_mgr.out_len == 0) && !gm_cli_mgr.out_prompt)
+#endif  /* GM_CLI_MEM_EN */
+    {
+        return -1;
+    }
+    gm_cli_mgr.out_prompt = 1;
+    return 0;
+}
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+/* 终端输出通道写入，输出调度使能时命令输出先放入批量输出缓存 */
+static void gm_cli_term_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    (void)p_sink;
+#if GM_CLI_OUT_SCHED_EN
+    if (gm_cli_mgr.out_class == GM_CLI_OUT_BULK)
+    {
+        gm_cli_out_push(buf, len);
+        return;
+    }
+    if ((gm_cli_mgr.out_len > 0) || gm_cli_mgr.out_prompt)
+    {
+        /* 回显插在了命令输出中间，发送完成后在新行重绘输入行 */
+        gm_cli_mgr.out_prompt = 1;
+        gm_cli_mgr.out_dirty = 1;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    gm_cli_term_out(buf, len);
+}
+
+/* 打印指定长度的数据 */
+void gm_cli_put_buf(const char* const buf, const unsigned int len)
+{
+    if ((buf == NULL) || (len == 0))
+    {
+        return;
+    }
+#if GM_CLI_BATCH_EN
+    if (gm_cli_batch_job != NULL)
+    {
+        gm_cli_batch_job->sink.write(&gm_cli_batch_job->sink, buf, len);
+        return;
+    }
+#endif  /* GM_CLI_BATCH_EN */
+    gm_cli_mgr.p_sink->write(gm_cli_mgr.p_sink, buf, len);
+}
+
+/* 打印字符 */
+void gm_cli_put_char(const char ch)
+{
+    gm_cli_put_buf(&ch, 1);
+}
+
+/* 打印字符串 */
+void gm_cli_put_str(const char* const str)
+{
+    if (str == NULL)
+    {
+        return;
+    }
+    gm_cli_put_buf(str, (unsigned int)strlen(str));
+}
+
+#if (GM_CLI_PRINTF_BUF_MAX > 0)
+/* 通用打印函数，替代默认printf */
+void gm_cli_printf(const char* const fmt, ...)
+{
+    va_list ap;
+#if GM_CLI_BATCH_EN
+    /* 批量执行时多个线程同时打印，使用栈上的缓存 */
+    char printf_str[GM_CLI_PRINTF_BUF_MAX];
+#else
+    char* const printf_str = gm_cli_mgr.printf_str;
+#endif  /* GM_CLI_BATCH_EN */
+
+    va_start(ap, fmt);
+
+#if (GM_CLI_CC == GM_CLI_CC_VS) || ((GM_CLI_CC == GM_CLI_CC_ANY) && defined _MSC_VER)
+    vsprintf_s(printf_str, GM_CLI_PRINTF_BUF_MAX, fmt, ap);
+#else
+    vsnprintf(printf_str, GM_CLI_PRINTF_BUF_MAX, fmt, ap);
+#endif
+    gm_cli_put_str(printf_str);
+
+    va_end(ap);
+}
+#else
+/* 精简格式化输出的分块缓存大小 */
+#define GM_CLI_PRINTF_CHUNK         16u
+
+/* 精简格式化输出的分块缓存 */
+typedef struct
+{
+    char         buf[GM_CLI_PRINTF_CHUNK];
+    unsigned int len;
+} gm_cli_printf_chunk_t;
+
+/* 向分块缓存写入重复字符，满了就输出 */
+static void gm_cli_printf_fill(gm_cli_printf_chunk_t* const p_chunk, const char ch, int num)
+{
+    while (num-- > 0)
+    {
+        if (p_chunk->len == GM_CLI_PRINTF_CHUNK)
+        {
+            gm_cli_put_buf(p_chunk->buf, p_chunk->len);
+            p_chunk->len = 0;
+        }
+        p_chunk->buf[p_chunk->len++] = ch;
+    }
+}
+
+/* 向分块缓存写入数据，满了就输出 */
+static void gm_cli_printf_put(gm_cli_printf_chunk_t* const p_chunk, const char* str,
+                              unsigned int len)
+{
+    while (len-- > 0)
+    {
+        gm_cli_printf_fill(p_chunk, *str++, 1);
+    }
+}
+
+/* 通用打印函数，替代默认printf，不使用缓存和C库格式化，边解析边输出 */
+void gm_cli_printf(const char* const fmt, ...)
+{
+    static const char digits[] = "0123456789abcdef0123456789ABCDEF";
+    gm_cli_printf_chunk_t chunk;
+    const char* p = fmt;
+    const char* p_spec;
+    const char* str;
+    char num[24];
+    unsigned long long val;
+    unsigned int base, len;
+    int width, prec, left, zero, lmod, neg, stop = 0;
+    va_list ap;
+
+    if (fmt == NULL)
+    {
+        return;
+    }
+
+    chunk.len = 0;
+    va_start(ap, fmt);
+    while ((*p != '\0') && !stop)
+    {
+        if (*p != '%')
+        {
+            gm_cli_printf_fill(&chunk, *p++, 1);
+            continue;
+        }
+        p_spec = p++;
+
+        /* 标志、宽度、精度和长度修饰 */
+        left = 0;
+        zero = 0;
+        for (; (*p == '-') || (*p == '0'); p++)
+        {
+            if (*p == '-')
+            {
+                left = 1;
+            }
+            else
+            {
+                zero = 1;
+            }
+        }
+        width = 0;
+        if (*p == '*')
+        {
+            width = va_arg(ap, int);
+            if (width < 0)
+            {
+                left = 1;
+                width = -width;
+            }
+            p++;
+        }
+        for (; (*p >= '0') && (*p <= '9'); p++)
+        {
+            width = width * 10 + (*p - '0');
+        }
+        prec = -1;
+        if (*p == '.')
+        {
+            p++;
+            prec = 0;
+            if (*p == '*')
+            {
+                prec = va_arg(ap, int);
+                p++;
+            }
+            for (; (*p >= '0') && (*p <= '9'); p++)
+            {
+                prec = prec * 10 + (*p - '0');
+            }
+        }
+        /* l为long，ll为long long，h按int读取 */
+        lmod = 0;
+        for (; (*p == 'l') || (*p == 'h'); p++)
+        {
+            lmod += ((*p == 'l') && (lmod < 2));
+        }
+
+        /* 转换 */
+        neg = 0;
+        base = 0;
+        str = num;
+        len = 1;
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+            {
+                long long sval = (lmod == 2) ? va_arg(ap, long long) :
+                                 ((lmod == 1) ? (long long)va_arg(ap, long) :
+                                                (long long)va_arg(ap, int));
+                neg = (sval < 0);
+                val = neg ? (0ULL - (unsigned long long)sval) : (unsigned long long)sval;
+                base = 10;
+            }
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+            val = (lmod == 2) ? va_arg(ap, unsigned long long) :
+                  ((lmod == 1) ? (unsigned long long)va_arg(ap, unsigned long) :
+                                 (unsigned long long)va_arg(ap, unsigned int));
+            base = (*p == 'u') ? 10 : 16;
+            break;
+        case 'p':
+            /* LLP64平台上long放不下指针 */
+            val = (unsigned long long)(uintptr_t)va_arg(ap, void*);
+            base = 16;
+            gm_cli_printf_put(&chunk, "0x", 2);
+            break;
+        case 'c':
+            num[0] = (char)va_arg(ap, int);
+            break;
+        case 's':
+            str = va_arg(ap, const char*);
+            if (str == NULL)
+            {
+                str = "(null)";
+            }
+            for (len = 0; (str[len] != '\0') && ((prec < 0) || (len < (unsigned int)prec)); len++);
+            zero = 0;
+            break;
+        case '%':
+            num[0] = '%';
+            break;
+        case '\0':
+            continue;
+        default:
+            /* 不支持的转换不知道参数的类型和大小，后面的参数都无法读取，从这里开始
+             * 原样输出格式串的剩余部分 */
+            str = p_spec;
+            len = (unsigned int)strlen(p_spec);
+            width = 0;
+            stop = 1;
+            break;
+        }
+        p++;
+
+        if (base != 0)
+        {
+            const char* p_digit = &digits[(p[-1] == 'X') ? 16 : 0];
+
+            len = sizeof(num);
+            do
+            {
+                num[--len] = p_digit[val % base];
+                val /= base;
+            } while (val != 0);
+            str = &num[len];
+            len = sizeof(num) - len;
+            if (neg && zero && !left)
+            {
+                gm_cli_printf_fill(&chunk, '-', 1);
+                width--;
+                neg = 0;
+            }
+            else if (neg)
+            {
+                num[sizeof(num) - len - 1] = '-';
+                str--;
+                len++;
+            }
+        }
+        else
+        {
+            zero = 0;
+        }
+
+        if (!left)
+        {
+            gm_cli_printf_fill(&chunk, zero ? '0' : ' ', width - (int)len);
+        }
+        gm_cli_printf_put(&chunk, str, len);
+        if (left)
+        {
+            gm_cli_printf_fill(&chunk, ' ', width - (int)len);
+        }
+    }
+    va_end(ap);
+
+    if (chunk.len > 0)
+    {
+        gm_cli_put_buf(chunk.buf, chunk.len);
+    }
+}
+#endif  /* GM_CLI_PRINTF_BUF_MAX > 0 */
+
+#if GM_CLI_PIPE_EN || GM_CLI_EMIT_EN
+/* 无符号数转字符串，返回字符串长度 */
+static unsigned int gm_cli_ultoa(unsigned long val, char* const str)
+{
+    char tmp[24];
+    unsigned int len = 0, i;
+
+    do
+    {
+        tmp[len++] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val != 0);
+    for (i = 0; i < len; i++)
+    {
+        str[i] = tmp[len - 1 - i];
+    }
+    str[len] = '\0';
+    return len;
+}
+#endif  /* GM_CLI_PIPE_EN || GM_CLI_EMIT_EN */
+
+#if GM_CLI_EMIT_EN
+#if (GM_CLI_EMIT_DEPTH_MAX > 16)
+#error "GM_CLI_EMIT_DEPTH_MAX must be less than or equal to 16"
+#endif
+
+/* CBOR主类型 */
+#define GM_CLI_CBOR_UINT            0x00u   /* 无符号整数 */
+#define GM_CLI_CBOR_NINT            0x20u   /* 负整数 */
+#define GM_CLI_CBOR_TEXT            0x60u   /* 文本字符串 */
+#define GM_CLI_CBOR_ARRAY_BEGIN     0x9Fu   /* 不定长数组开始 */
+#define GM_CLI_CBOR_MAP_BEGIN       0xBFu   /* 不定长映射开始 */
+#define GM_CLI_CBOR_FALSE           0xF4u   /* false */
+#define GM_CLI_CBOR_TRUE            0xF5u   /* true */
+#define GM_CLI_CBOR_BREAK           0xFFu   /* 不定长结束 */
+
+/* 当前层的位掩码 */
+#define GM_CLI_EMIT_LEVEL_BIT       (1u << (gm_cli_mgr.emit_depth - 1))
+
+/* 输出格式名 */
+static const char* const gm_cli_fmt_name[] = { "text", "json", "cbor" };
+
+/* 设置会话默认输出格式 */
+void gm_cli_set_output_fmt(const gm_cli_fmt_t fmt)
+{
+    gm_cli_mgr.emit_fmt = fmt;
+    gm_cli_mgr.emit_cur_fmt = fmt;
+}
+
+/* 读取当前命令的输出格式 */
+gm_cli_fmt_t gm_cli_get_output_fmt(void)
+{
+    return gm_cli_mgr.emit_cur_fmt;
+}
+
+/* 输出CBOR头，major为主类型，val为长度或数值 */
+static void gm_cli_emit_cbor_head(const unsigned int major, unsigned long val)
+{
+    unsigned char buf[9];
+    unsigned int len, i;
+
+    if (val < 24)
+    {
+        buf[0] = (unsigned char)(major | val);
+        gm_cli_put_buf((const char*)buf, 1);
+        return;
+    }
+    if (val <= 0xFFul)
+    {
+        buf[0] = (unsigned char)(major | 24);
+        len = 1;
+    }
+    else if (val <= 0xFFFFul)
+    {
+        buf[0] = (unsigned char)(major | 25);
+        len = 2;
+    }
+    else if (val <= 0xFFFFFFFFul)
+    {
+        buf[0] = (unsigned char)(major | 26);
+        len = 4;
+    }
+    else
+    {
+        buf[0] = (unsigned char)(major | 27);
+        len = 8;
+    }
+    /* 大端存放 */
+    for (i = len; i > 0; i--)
+    {
+        buf[i] = (unsigned char)(val & 0xFF);
+        val >>= 4;
+        val >>= 4;
+    }
+    gm_cli_put_buf((const char*)buf, len + 1);
+}
+
+/* 输出JSON字符串，带引号和转义 */
+static void gm_cli_emit_json_str(const char* str)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char* p_start = str;
+    char esc[6];
+
+    gm_cli_put_char('"');
+    for (; *str != '\0'; str++)
+    {
+        if ((*str != '"') && (*str != '\\') && ((unsigned char)*str >= 0x20))
+        {
+            continue;
+        }
+        /* 先输出前面不需要转义的部分 */
+        gm_cli_put_buf(p_start, (unsigned int)(str - p_start));
+        p_start = str + 1;
+        esc[0] = '\\';
+        if ((*str == '"') || (*str == '\\'))
+        {
+            esc[1] = *str;
+            gm_cli_put_buf(esc, 2);
+        }
+        else
+        {
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hex[((unsigned char)*str >> 4) & 0x0F];
+            esc[5] = hex[(unsigned char)*str & 0x0F];
+            gm_cli_put_buf(esc, 6);
+        }
+    }
+    gm_cli_put_buf(p_start, (unsigned int)(str - p_start));
+    gm_cli_put_char('"');
+}
+
+/* 输出元素前缀：分隔符、键名或文本缩进 */
+static void gm_cli_emit_prefix(const char* const name)
+{
+    unsigned int i;
+    int in_map = (gm_cli_mgr.emit_depth > 0) &&
+                 ((gm_cli_mgr.emit_array_mask & GM_CLI_EMIT_LEVEL_BIT) == 0);
+
+    switch (gm_cli_mgr.emit_cur_fmt)
+    {
+    case GM_CLI_FMT_JSON:
+        if (gm_cli_mgr.emit_depth > 0)
+        {
+            if (gm_cli_mgr.emit_item_mask & GM_CLI_EMIT_LEVEL_BIT)
+            {
+                gm_cli_put_char(',');
+            }
+            gm_cli_mgr.emit_item_mask |= GM_CLI_EMIT_LEVEL_BIT;
+        }
+        if (in_map)
+        {
+            gm_cli_emit_json_str((name != NULL) ? name : "");
+            gm_cli_put_char(':');
+        }
+        break;
+
+    case GM_CLI_FMT_CBOR:
+        if (in_map)
+        {
+            if (name == NULL)
+            {
+                gm_cli_emit_cbor_head(GM_CLI_CBOR_TEXT, 0);
+            }
+            else
+            {
+                gm_cli_emit_cbor_head(GM_CLI_CBOR_TEXT, (unsigned long)strlen(name));
+                gm_cli_put_str(name);
+            }
+        }
+        break;
+
+    default:
+        /* 文本格式，最外层容器不缩进 */
+        for (i = 1; i < gm_cli_mgr.emit_depth; i++)
+        {
+            gm_cli_put_str("  ");
+        }
+        if (name != NULL)
+        {
+            gm_cli_put_str(name);
+            gm_cli_put_str(": ");
+        }
+        else if (gm_cli_mgr.emit_depth > 0)
+        {
+            gm_cli_put_str("- ");
+        }
+        break;
+    }
+}
+
+/* 输出元素结束，最外层的JSON值结束后换行 */
+static void gm_cli_emit_suffix(void)
+{
+    if ((gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_TEXT) ||
+        ((gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_JSON) && (gm_cli_mgr.emit_depth == 0)))
+    {
+        gm_cli_put_str("\r\n");
+    }
+}
+
+/* 开始一个容器 */
+static void gm_cli_emit_begin(const char* const name, const int is_array)
+{
+    unsigned int i;
+
+    if (gm_cli_mgr.emit_depth >= GM_CLI_EMIT_DEPTH_MAX)
+    {
+        /* 超出的容器不输出，记下层数使结束时和开始配对，命令返回后报错 */
+        gm_cli_mgr.emit_overflow++;
+        gm_cli_mgr.emit_err = 1;
+        return;
+    }
+
+    if (gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_TEXT)
+    {
+        /* 文本格式最外层的匿名容器不输出标题行 */
+        if ((name != NULL) || (gm_cli_mgr.emit_depth > 0))
+        {
+            for (i = 1; i < gm_cli_mgr.emit_depth; i++)
+            {
+                gm_cli_put_str("  ");
+            }
+            gm_cli_put_str((name != NULL) ? name : "-");
+            gm_cli_put_str((name != NULL) ? ":\r\n" : "\r\n");
+        }
+    }
+    else
+    {
+        gm_cli_emit_prefix(name);
+        if (gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_JSON)
+        {
+            gm_cli_put_char(is_array ? '[' : '{');
+        }
+        else
+        {
+            gm_cli_put_char((char)(is_array ? GM_CLI_CBOR_ARRAY_BEGIN : GM_CLI_CBOR_MAP_BEGIN));
+        }
+    }
+
+    gm_cli_mgr.emit_depth++;
+    if (is_array)
+    {
+        gm_cli_mgr.emit_array_mask |= GM_CLI_EMIT_LEVEL_BIT;
+    }
+    else
+    {
+        gm_cli_mgr.emit_array_mask &= ~GM_CLI_EMIT_LEVEL_BIT;
+    }
+    gm_cli_mgr.emit_item_mask &= ~GM_CLI_EMIT_LEVEL_BIT;
+}
+
+/* 结束一个容器 */
+static void gm_cli_emit_end(void)
+{
+    if (gm_cli_mgr.emit_overflow > 0)
+    {
+        gm_cli_mgr.emit_overflow--;
+        return;
+    }
+    if (gm_cli_mgr.emit_depth == 0)
+    {
+        return;
+    }
+
+    switch (gm_cli_mgr.emit_cur_fmt)
+    {
+    case GM_CLI_FMT_JSON:
+        gm_cli_put_char((gm_cli_mgr.emit_array_mask & GM_CLI_EMIT_LEVEL_BIT) ? ']' : '}');
+        gm_cli_mgr.emit_depth--;
+        gm_cli_emit_suffix();
+        break;
+
+    case GM_CLI_FMT_CBOR:
+        gm_cli_put_char((char)GM_CLI_CBOR_BREAK);
+        gm_cli_mgr.emit_depth--;
+        break;
+
+    default:
+        gm_cli_mgr.emit_depth--;
+        break;
+    }
+}
+
+/* 开始对象 */
+void gm_cli_emit_begin_object(const char* const name)
+{
+    gm_cli_emit_begin(name, 0);
+}
+
+/* 结束对象 */
+void gm_cli_emit_end_object(void)
+{
+    gm_cli_emit_end();
+}
+
+/* 开始数组 */
+void gm_cli_emit_begin_array(const char* const name)
+{
+    gm_cli_emit_begin(name, 1);
+}
+
+/* 结束数组 */
+void gm_cli_emit_end_array(void)
+{
+    gm_cli_emit_end();
+}
+
+/* 输出有符号整数字段 */
+void gm_cli_emit_field_int(const char* const name, const long val)
+{
+    char str[24];
+    unsigned long uval;
+
+    gm_cli_emit_prefix(name);
+    if (gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_CBOR)
+    {
+        if (val < 0)
+        {
+            /* CBOR负整数存放-1-val */
+            gm_cli_emit_cbor_head(GM_CLI_CBOR_NINT, (unsigned long)(-(val + 1)));
+        }
+        else
+        {
+            gm_cli_emit_cbor_head(GM_CLI_CBOR_UINT, (unsigned long)val);
+        }
+        return;
+    }
+
+    uval = (val < 0) ? (0ul - (unsigned long)val) : (unsigned long)val;
+    if (val < 0)
+    {
+        gm_cli_put_char('-');
+    }
+    gm_cli_put_buf(str, gm_cli_ultoa(uval, str));
+    gm_cli_emit_suffix();
+}
+
+/* 输出无符号整数字段 */
+void gm_cli_emit_field_uint(const char* const name, const unsigned long val)
+{
+    char str[24];
+
+    gm_cli_emit_prefix(name);
+    if (gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_CBOR)
+    {
+        gm_cli_emit_cbor_head(GM_CLI_CBOR_UINT, val);
+        return;
+    }
+    gm_cli_put_buf(str, gm_cli_ultoa(val, str));
+    gm_cli_emit_suffix();
+}
+
+/* 输出字符串字段 */
+void gm_cli_emit_field_str(const char* const name, const char* const str)
+{
+    const char* p_str = (str != NULL) ? str : "";
+
+    gm_cli_emit_prefix(name);
+    switch (gm_cli_mgr.emit_cur_fmt)
+    {
+    case GM_CLI_FMT_JSON:
+        gm_cli_emit_json_str(p_str);
+        break;
+
+    case GM_CLI_FMT_CBOR:
+        gm_cli_emit_cbor_head(GM_CLI_CBOR_TEXT, (unsigned long)strlen(p_str));
+        gm_cli_put_str(p_str);
+        return;
+
+    default:
+        gm_cli_put_str(p_str);
+        break;
+    }
+    gm_cli_emit_suffix();
+}
+
+/* 输出布尔字段 */
+void gm_cli_emit_field_bool(const char* const name, const int val)
+{
+    gm_cli_emit_prefix(name);
+    if (gm_cli_mgr.emit_cur_fmt == GM_CLI_FMT_CBOR)
+    {
+        gm_cli_put_char((char)(val ? GM_CLI_CBOR_TRUE : GM_CLI_CBOR_FALSE));
+        return;
+    }
+    gm_cli_put_str(val ? "true" : "false");
+    gm_cli_emit_suffix();
+}
+
+/* 解析命令末尾的输出格式选项--text、--json和--cbor，从参数中去掉，
+ * 只有带GM_CLI_CMD_FLAG_EMIT标志的命令才解析，其他位置的同名参数原样传给命令 */
+static void gm_cli_emit_parse_args(const gm_cli_cmd_t* const p_cmd, int* const p_argc, char* argv[])
+{
+    int fmt = -1;
+
+    gm_cli_mgr.emit_cur_fmt = gm_cli_mgr.emit_fmt;
+    gm_cli_mgr.emit_depth = 0;
+    gm_cli_mgr.emit_overflow = 0;
+    gm_cli_mgr.emit_err = 0;
+    if (!(p_cmd->flags & GM_CLI_CMD_FLAG_EMIT))
+    {
+        return;
+    }
+    /* 从后往前去掉连续的格式选项，最后一个有效 */
+    while (*p_argc > 1)
+    {
+        if (strcmp(argv[*p_argc - 1], "--json") == 0)
+        {
+            fmt = (fmt < 0) ? (int)GM_CLI_FMT_JSON : fmt;
+        }
+        else if (strcmp(argv[*p_argc - 1], "--cbor") == 0)
+        {
+            fmt = (fmt < 0) ? (int)GM_CLI_FMT_CBOR : fmt;
+        }
+        else if (strcmp(argv[*p_argc - 1], "--text") == 0)
+        {
+            fmt = (fmt < 0) ? (int)GM_CLI_FMT_TEXT : fmt;
+        }
+        else
+        {
+            break;
+        }
+        (*p_argc)--;
+    }
+    if (fmt >= 0)
+    {
+        gm_cli_mgr.emit_cur_fmt = (gm_cli_fmt_t)fmt;
+    }
+}
+
+/* 命令结束，关闭命令未结束的容器并恢复会话输出格式，
+ * 返回：0 - 正常，-1 - 嵌套超过最大层数 */
+static int gm_cli_emit_finish(const gm_cli_cmd_t* const p_cmd)
+{
+    gm_cli_mgr.emit_overflow = 0;
+    while (gm_cli_mgr.emit_depth > 0)
+    {
+        gm_cli_emit_end();
+    }
+    gm_cli_mgr.emit_cur_fmt = gm_cli_mgr.emit_fmt;
+    if (gm_cli_mgr.emit_err)
+    {
+        gm_cli_mgr.emit_err = 0;
+        gm_cli_printf("Command \"%s\" nested output deeper than %u levels!\r\n",
+                      p_cmd->name, (unsigned int)GM_CLI_EMIT_DEPTH_MAX);
+        return -1;
+    }
+    return 0;
+}
+#endif  /* GM_CLI_EMIT_EN */
+
+/* 整理行缓存，将间隙移到末尾，使输入内容连续并以'\0'结尾，返回行字符串 */
+static char* gm_cli_line_text(void)
+{
+    unsigned int tail = gm_cli_mgr.line_size - gm_cli_mgr.line_gap_end;
+
+    if (tail > 0)
+    {
+        memmove(&gm_cli_mgr.line[gm_cli_mgr.input_cusor],
+                &gm_cli_mgr.line[gm_cli_mgr.line_gap_end], tail);
+    }
+    gm_cli_mgr.input_cusor = gm_cli_mgr.input_count;
+    gm_cli_mgr.line_gap_end = gm_cli_mgr.line_size;
+    gm_cli_mgr.line[gm_cli_mgr.input_count] = '\0';
+
+    return gm_cli_mgr.line;
+}
+
+/* 移动间隙到指定位置，即设置光标位置，行内容需要已经是连续的 */
+static void gm_cli_line_seek(const unsigned int pos)
+{
+    unsigned int tail = gm_cli_mgr.input_count - pos;
+
+    memmove(&gm_cli_mgr.line[gm_cli_mgr.line_size - tail], &gm_cli_mgr.line[pos], tail);
+    gm_cli_mgr.line_gap_end = gm_cli_mgr.line_size - tail;
+    gm_cli_mgr.input_cusor = pos;
+}
+
+/* 设置行内容，光标移到末尾，超出行缓存的部分截断 */
+static void gm_cli_line_set(const char* const str, unsigned int len)
+{
+    if (len > (unsigned int)gm_cli_mgr.line_size - 1)
+    {
+        len = gm_cli_mgr.line_size - 1;
+    }
+    memmove(gm_cli_mgr.line, str, len);
+    gm_cli_mgr.line[len] = '\0';
+    gm_cli_mgr.input_count = len;
+    gm_cli_mgr.input_cusor = len;
+    gm_cli_mgr.line_gap_end = gm_cli_mgr.line_size;
+}
+
+/* 清空行 */
+static void gm_cli_line_clear(void)
+{
+    gm_cli_mgr.line[0] = '\0';
+    gm_cli_mgr.input_count = 0;
+    gm_cli_mgr.input_cusor = 0;
+    gm_cli_mgr.line_gap_end = gm_cli_mgr.line_size;
+}
+
+/* 删除终端上显示的当前行 */
+static void gm_cli_line_erase(void)
+{
+    unsigned int len;
+
+    GM_CLI_TRACE(GM_CLI_TRACE_REDRAW | GM_CLI_TRACE_BEGIN, gm_cli_mgr.input_count);
+    /* 光标之后的行数据清除掉 */
+    len = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
+    for (unsigned int i = 0; i < len; i++)
+    {
+        gm_cli_put_char(' ');
+    }
+    /* 清除所有的行数据 */
+    for (unsigned int i = 0; i < gm_cli_mgr.input_count; i++)
+    {
+        gm_cli_put_str("\b \b");
+    }
+    GM_CLI_TRACE(GM_CLI_TRACE_REDRAW | GM_CLI_TRACE_END, 0);
+}
+
+#if GM_CLI_WATCH_EN || GM_CLI_LOG_EN || GM_CLI_OUT_SCHED_EN
+/* 显示提示符和输入行，光标回到原位置 */
+static void gm_cli_line_redraw(void)
+{
+    unsigned int i, count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
+
+    GM_CLI_TRACE(GM_CLI_TRACE_REDRAW | GM_CLI_TRACE_BEGIN, gm_cli_mgr.input_count);
+    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+    gm_cli_put_buf(gm_cli_mgr.line, gm_cli_mgr.input_cusor);
+    gm_cli_put_buf(&gm_cli_mgr.line[gm_cli_mgr.line_gap_end], count);
+    for (i = 0; i < count; i++)
+    {
+        gm_cli_put_char('\b');
+    }
+    GM_CLI_TRACE(GM_CLI_TRACE_REDRAW | GM_CLI_TRACE_END, 0);
+}
+#endif  /* GM_CLI_WATCH_EN || GM_CLI_LOG_EN || GM_CLI_OUT_SCHED_EN */
+
+/* 历史记录中第index条记录在存储池中的位置 */
+#define GM_CLI_HISTORY_AT(index, offset)                                        \
+        gm_cli_mgr.history_pool[(gm_cli_mgr.history_pos[index] + (offset)) %    \
+                                gm_cli_mgr.history_pool_size]
+
+/* 添加一条历史记录，存储池空间不足时丢弃最早的记录 */
+static void gm_cli_history_add(const char* const str, const unsigned int len)
+{
+    unsigned int oldest, i;
+
+    /* 空出记录槽位和存储空间 */
+    while ((gm_cli_mgr.history_total > 0) &&
+           ((gm_cli_mgr.history_total >= GM_CLI_HISTORY_LINE_MAX) ||
+            (gm_cli_mgr.history_pool_used + len > gm_cli_mgr.history_pool_size)))
+    {
+        oldest = (gm_cli_mgr.history_index + GM_CLI_HISTORY_LINE_MAX -
+                  gm_cli_mgr.history_total) % GM_CLI_HISTORY_LINE_MAX;
+        gm_cli_mgr.history_pool_used -= gm_cli_mgr.history_len[oldest];
+        gm_cli_mgr.history_total--;
+    }
+
+    gm_cli_mgr.history_pos[gm_cli_mgr.history_index] = gm_cli_mgr.history_pool_pos;
+    gm_cli_mgr.history_len[gm_cli_mgr.history_index] = len;
+    for (i = 0; i < len; i++)
+    {
+        GM_CLI_HISTORY_AT(gm_cli_mgr.history_index, i) = str[i];
+    }
+    gm_cli_mgr.history_pool_pos = (gm_cli_mgr.history_pool_pos + len) % gm_cli_mgr.history_pool_size;
+    gm_cli_mgr.history_pool_used += len;
+
+    gm_cli_mgr.history_index++;
+    gm_cli_mgr.history_index %= GM_CLI_HISTORY_LINE_MAX;
+    gm_cli_mgr.history_total++;
+}
+
+/* 取出一条历史记录到行缓存 */
+static void gm_cli_history_load(const unsigned int index)
+{
+    unsigned int i, len = gm_cli_mgr.history_len[index];
+
+    for (i = 0; i < len; i++)
+    {
+        gm_cli_mgr.line[i] = GM_CLI_HISTORY_AT(index, i);
+    }
+    gm_cli_line_set(gm_cli_mgr.line, len);
+}
+
+/* 输出一条历史记录 */
+static void gm_cli_history_put(const unsigned int index)
+{
+    unsigned int pos = gm_cli_mgr.history_pos[index];
+    unsigned int len = gm_cli_mgr.history_len[index];
+    unsigned int len1 = gm_cli_mgr.history_pool_size - pos;
+
+    if (len1 >= len)
+    {
+        gm_cli_put_buf(&gm_cli_mgr.history_pool[pos], len);
+    }
+    else
+    {
+        /* 记录跨越存储池末尾，分两段输出 */
+        gm_cli_put_buf(&gm_cli_mgr.history_pool[pos], len1);
+        gm_cli_put_buf(&gm_cli_mgr.history_pool[0], len - len1);
+    }
+}
+
+/* 上键处理 */
+static void gm_cli_parse_up_key(void)
+{
+    unsigned int cusor = gm_cli_mgr.input_cusor;
+
+    if (gm_cli_mgr.history_total == 0)
+    {
+        /* 无记录 */
+        return;
+    }
+
+    GM_CLI_TRACE(GM_CLI_TRACE_HISTORY | GM_CLI_TRACE_BEGIN, 0);
+    if (gm_cli_mgr.history_inquire_count == 0)
+    {
+        /* 从未上翻记录，备份当前输入 */
+        gm_cli_line_text();
+        memcpy(gm_cli_mgr.backup_str, gm_cli_mgr.line, gm_cli_mgr.input_count + 1);
+        /* 整理行缓存时光标移到了末尾，恢复光标位置，擦除时才能清掉光标后的内容 */
+        gm_cli_line_seek(cusor);
+        /* 搜索记录位置设置到当前记录处 */
+        gm_cli_mgr.history_inquire_index = gm_cli_mgr.history_index;
+    }
+
+    /* 查看是否已经搜索完成 */
+    if (gm_cli_mgr.history_inquire_count < gm_cli_mgr.history_total)
+    {
+        /* 搜索编号往前找一个记录编号 */
+        if (gm_cli_mgr.history_inquire_index == 0)
+        {
+            gm_cli_mgr.history_inquire_index = GM_CLI_HISTORY_LINE_MAX - 1;
+        }
+        else
+        {
+            gm_cli_mgr.history_inquire_index--;
+        }
+        /* 搜索数量加1 */
+        gm_cli_mgr.history_inquire_count++;
+        /* 清除所有的行数据 */
+        gm_cli_line_erase();
+
+        /* 导入历史输入 */
+        gm_cli_history_load(gm_cli_mgr.history_inquire_index);
+        /* 显示历史记录 */
+        gm_cli_put_buf(gm_cli_mgr.line, gm_cli_mgr.input_count);
+    }
+    GM_CLI_TRACE(GM_CLI_TRACE_HISTORY | GM_CLI_TRACE_END, 0);
+}
+
+/* 下键处理 */
+static void gm_cli_parse_down_key(void)
+{
+    if ((gm_cli_mgr.history_total == 0) ||
+        (gm_cli_mgr.history_inquire_count == 0))
+    {
+        /* 无记录或无上翻 */
+        return;
+    }
+
+    GM_CLI_TRACE(GM_CLI_TRACE_HISTORY | GM_CLI_TRACE_BEGIN, 0);
+    /* 查询数量减一 */
+    gm_cli_mgr.history_inquire_count--;
+    /* 删除当前行内容 */
+    gm_cli_line_erase();
+
+    if (gm_cli_mgr.history_inquire_count == 0)
+    {
+        /* 恢复备份的输入 */
+        gm_cli_line_set(gm_cli_mgr.backup_str, (unsigned int)strlen(gm_cli_mgr.backup_str));
+    }
+    else
+    {
+        /* 更新索引 */
+        gm_cli_mgr.history_inquire_index++;
+        gm_cli_mgr.history_inquire_index %= GM_CLI_HISTORY_LINE_MAX;
+        /* 取出历史 */
+        gm_cli_history_load(gm_cli_mgr.history_inquire_index);
+    }
+
+    /* 显示输入行 */
+    gm_cli_put_buf(gm_cli_mgr.line, gm_cli_mgr.input_count);
+    GM_CLI_TRACE(GM_CLI_TRACE_HISTORY | GM_CLI_TRACE_END, 0);
+}
+
+/* 左键处理，光标前一个字符移到间隙之后 */
+static void gm_cli_parse_left_key(void)
+{
+    if (gm_cli_mgr.input_cusor > 0)
+    {
+        gm_cli_put_char('\b');
+        gm_cli_mgr.input_cusor--;
+        gm_cli_mgr.line_gap_end--;
+        gm_cli_mgr.line[gm_cli_mgr.line_gap_end] = gm_cli_mgr.line[gm_cli_mgr.input_cusor];
+    }
+}
+
+/* 右键处理，间隙后一个字符移到光标处 */
+static void gm_cli_parse_right_key(void)
+{
+    if (gm_cli_mgr.input_cusor < gm_cli_mgr.input_count)
+    {
+        gm_cli_mgr.line[gm_cli_mgr.input_cusor] = gm_cli_mgr.line[gm_cli_mgr.line_gap_end];
+        gm_cli_put_char(gm_cli_mgr.line[gm_cli_mgr.input_cusor]);
+        gm_cli_mgr.input_cusor++;
+        gm_cli_mgr.line_gap_end++;
+    }
+}
+
+/* 功能键处理返回：0 - 已处理的功能字符，-1 - 未处理的字符 */
+static int gm_cli_parse_func_key(const char ch)
+{
+    /* XSHELL终端，超级终端等功能码 */
+    if (ch == (char)0x1B)
+    {
+        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_SPEC_KEY;
+        return 0;
+    }
+    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_SPEC_KEY)
+    {
+        if (ch == (char)0x5b)
+        {
+            gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_FUNC_KEY;
+            return 0;
+        }
+
+        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+    }
+    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_FUNC_NUM)
+    {
+        /* 带数字参数的功能码，以0x40~0x7E结束 */
+        if ((ch >= '0') && (ch <= '9'))
+        {
+            gm_cli_mgr.func_num = gm_cli_mgr.func_num * 10 + (unsigned int)(ch - '0');
+            gm_cli_mgr.func_num %= 100000u;
+            return 0;
+        }
+        if ((ch >= (char)0x40) && (ch <= (char)0x7E))
+        {
+            gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+#if GM_CLI_BRACKETED_PASTE_EN
+            if ((ch == '~') && (gm_cli_mgr.func_num == 200))
+            {
+                /* 粘贴开始 */
+                gm_cli_mgr.paste_mode = 1;
+                gm_cli_mgr.paste_match = 0;
+                gm_cli_mgr.paste_echo_pos = gm_cli_mgr.input_cusor;
+                gm_cli_mgr.paste_last_ch = '\0';
+            }
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+        }
+        /* 其他功能码及';'等分隔符直接忽略 */
+        return 0;
+    }
+    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_FUNC_KEY)
+    {
+        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+
+        if ((ch >= '0') && (ch <= '9'))
+        {
+            gm_cli_mgr.func_num = (unsigned int)(ch - '0');
+            gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_FUNC_NUM;
+            return 0;
+        }
+        else if (ch == (char)0x41) /* 上 */
+        {
+            gm_cli_parse_up_key();
+            return 0;
+        }
+        else if (ch == (char)0x42) /* 下 */
+        {
+            gm_cli_parse_down_key();
+            return 0;
+        }
+        else if (ch == (char)0x44) /* 左 */
+        {
+            gm_cli_parse_left_key();
+            return 0;
+        }
+        else if (ch == (char)0x43) /* 右 */
+        {
+            gm_cli_parse_right_key();
+            return 0;
+        }
+    }
+
+#if (GM_CLI_CC == GM_CLI_CC_VS) || (GM_CLI_CC == GM_CLI_CC_MINGW) || \
+    ((GM_CLI_CC == GM_CLI_CC_ANY) && defined _MSC_VER)
+    /* windows命令行功能码 */
     if (ch == (char)0xE0)
     {
-        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_FUNC_KEY1;
+        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_FUNC_KEY1;
+        return 0;
+    }
+    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_FUNC_KEY1)
+    {
+        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+        if (ch == (char)0x48)         /* 上 */
+        {
+            gm_cli_parse_up_key();
+            return 0;
+        }
+        else if (ch == (char)0x50)    /* 下 */
+        {
+            gm_cli_parse_down_key();
+            return 0;
+        }
+        else if (ch == (char)0x4B)    /* 左 */
+        {
+            gm_cli_parse_left_key();
+            return 0;
+        }
+        else if (ch == (char)0x4D)    /* 右 */
+        {
+            gm_cli_parse_right_key();
+            return 0;
+        }
+    }
+#endif  /* _MSC_VER */
+
+    return -1;
+}
+
+/* 判断字符串是否空，返回：0 - 空，-1 - 非空 */
+static int gm_cli_str_empty_check(const char* const str)
+{
+    const char* p_tmp = str;
+    while (*p_tmp)
+    {
+        if ((*p_tmp) != ' ')
+        {
+            return -1;
+        }
+        p_tmp++;
+    }
+    return 0;
+}
+
+/* 字符串匹配 */
+static int gm_cli_str_completion(const char* const str, const char* const substr)
+{
+    unsigned int len1 = (unsigned int)strlen(str);
+    unsigned int len2 = (unsigned int)strlen(substr);
+    unsigned int i = 0;
+
+    if (len2 > len1)
+    {
+        return -1;
+    }
+    for (i = 0; i < len2; i++)
+    {
+        if (str[i] != substr[i])
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* 删除开头的空格 */
+static const char* gm_cli_delete_start_space(const char* const str)
+{
+    unsigned int i = 0;
+    unsigned int len = (unsigned int)strlen(str);
+    while ((str[i] == ' ') && (str[i] != '\0') && (i < len))
+    {
+        i++;
+    }
+    return (const char*)(str + i);
+}
+
+/* tab键处理 */
+static void gm_cli_parse_tab_key(void)
+{
+    const gm_cli_cmd_t *p_temp, *p_find_first_cmd = NULL;
+    unsigned int find_count = 0;
+    unsigned int cusor = gm_cli_mgr.input_cusor;
+    const char *p_line_start;
+
+    /* 检测是否是空白行 */
+    if (gm_cli_str_empty_check(gm_cli_line_text()) == 0)
+    {
+        gm_cli_line_seek(cusor);
+        return;
+    }
+
+    /* 取消前面的空白 */
+    p_line_start = gm_cli_delete_start_space(gm_cli_mgr.line);
+
+    p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+
+    /* 查询命令 */
+    while (p_temp != NULL)
+    {
+        if (gm_cli_str_completion(p_temp->name, p_line_start) == 0)
+        {
+            if (find_count == 0)
+            {
+                p_find_first_cmd = p_temp;
+            }
+            else if (find_count == 1)
+            {
+                gm_cli_put_str("\r\n");
+                gm_cli_put_str(p_find_first_cmd->name);
+                gm_cli_put_str("\r\n");
+                gm_cli_put_str(p_temp->name);
+                gm_cli_put_str("\r\n");
+            }
+            else
+            {
+                gm_cli_put_str(p_temp->name);
+                gm_cli_put_str("\r\n");
+            }
+            find_count++;
+        }
+        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+    }
+
+    if (find_count == 1)
+    {
+        /* 删除当前行内容，行内容已连续，显示的光标还在原位置 */
+        gm_cli_mgr.input_cusor = cusor;
+        gm_cli_line_erase();
+
+        /* 自动填充行 */
+        gm_cli_line_set(p_find_first_cmd->name, (unsigned int)strlen(p_find_first_cmd->name));
+        /* 显示输入行 */
+        gm_cli_put_buf(gm_cli_mgr.line, gm_cli_mgr.input_count);
+    }
+    else if (find_count > 1)
+    {
+        /* 显示提示符 */
+        gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+        /* 显示输入行，光标在末尾 */
+        gm_cli_put_buf(gm_cli_mgr.line, gm_cli_mgr.input_count);
+    }
+    else
+    {
+        /* 未找到，恢复光标位置 */
+        gm_cli_line_seek(cusor);
+    }
+}
+
+/* 退格键处理，光标前的字符并入间隙 */
+static void gm_cli_parse_backspace_key(void)
+{
+    unsigned int i, count;
+
+    if (gm_cli_mgr.input_cusor == 0)
+    {
+        /* 未输入，直接跳过 */
+        return;
+    }
+
+    /* 更新位置 */
+    gm_cli_mgr.input_cusor--;
+    gm_cli_mgr.input_count--;
+
+    if (gm_cli_mgr.input_cusor == gm_cli_mgr.input_count)
+    {
+        /* 光标在最后 */
+        gm_cli_put_str("\b \b");
+    }
+    else
+    {
+        /* 重新刷新光标后的显示 */
+        count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
+        gm_cli_put_char('\b');
+        gm_cli_put_buf(&gm_cli_mgr.line[gm_cli_mgr.line_gap_end], count);
+        gm_cli_put_str(" \b");
+        /* 光标回位 */
+        for (i = 0; i < count; i++)
+        {
+            gm_cli_put_char('\b');
+        }
+    }
+}
+
+#if GM_CLI_PIPE_EN || GM_CLI_REDIRECT_SUPPORT || GM_CLI_ALIAS_EN || GM_CLI_BATCH_EN
+/* 查找引号之外的字符，返回：字符位置，NULL - 未找到 */
+static char* gm_cli_str_find_unquoted(char* str, const char ch)
+{
+    char quote = '\0';
+
+    for (; *str != '\0'; str++)
+    {
+        if (quote != '\0')
+        {
+            if (*str == quote)
+            {
+                quote = '\0';
+            }
+        }
+        else if ((*str == '\'') || (*str == '"'))
+        {
+            quote = *str;
+        }
+        else if (*str == ch)
+        {
+            return str;
+        }
+    }
+    return NULL;
+}
+#endif  /* GM_CLI_PIPE_EN || GM_CLI_REDIRECT_SUPPORT || GM_CLI_ALIAS_EN || GM_CLI_BATCH_EN */
+
+/* 分割参数，单引号或双引号内的空格不分割，引号本身去掉，返回参数个数，参数过多
+ * 时只保留前面的参数 */
+static int gm_cli_split_args(char* const str, char* argv[])
+{
+    int argc = 0;
+    char* p = str;
+    char* q;
+    char quote, ch;
+
+    while (*p != '\0')
+    {
+        /* 跳过空格和Tab并替换为0 */
+        while ((*p == ' ') || (*p == '\t'))
+        {
+            *p++ = '\0';
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+
+        if (argc >= (int)GM_CLI_CMD_ARGS_NUM_MAX)
+        {
+            gm_cli_put_str("Too many args! Line will replace follow:\r\n  < ");
+            for (int j = 0; j < argc; j++)
+            {
+                gm_cli_put_str(argv[j]);
+                gm_cli_put_char(' ');
+            }
+            gm_cli_put_str(">\r\n");
+            break;
+        }
+
+        argv[argc++] = p;
+        /* 跳过中间的字符串，去掉引号后内容前移 */
+        quote = '\0';
+        for (q = p; (*p != '\0') && ((quote != '\0') || ((*p != ' ') && (*p != '\t'))); p++)
+        {
+            if ((quote == '\0') && ((*p == '\'') || (*p == '"')))
+            {
+                quote = *p;
+            }
+            else if (*p == quote)
+            {
+                quote = '\0';
+            }
+            else
+            {
+                *q++ = *p;
+            }
+        }
+        ch = *p;
+        *q = '\0';
+        if (ch != '\0')
+        {
+            p++;
+        }
+    }
+
+    return argc;
+}
+
+#if GM_CLI_PIPE_EN
+/* 子串查找，返回：0 - 找到，-1 - 未找到 */
+static int gm_cli_str_search(const char* const str, const char* const substr,
+                             const int ignore_case)
+{
+    const char *p, *q, *s;
+
+    for (p = str; ; p++)
+    {
+        for (s = p, q = substr; *q != '\0'; s++, q++)
+        {
+            if (ignore_case)
+            {
+                if (tolower((unsigned char)*s) != tolower((unsigned char)*q))
+                {
+                    break;
+                }
+            }
+            else if (*s != *q)
+            {
+                break;
+            }
+        }
+        if (*q == '\0')
+        {
+            return 0;
+        }
+        if (*p == '\0')
+        {
+            return -1;
+        }
+    }
+}
+
+/* 输出数据到管道的下一级 */
+static void gm_cli_pipe_forward(gm_cli_pipe_stage_t* const p_stage,
+                                const char* const buf, const unsigned int len)
+{
+    if (len > 0)
+    {
+        p_stage->sink.next->write(p_stage->sink.next, buf, len);
+    }
+}
+
+/* 输出一行数据到管道的下一级 */
+static void gm_cli_pipe_forward_line(gm_cli_pipe_stage_t* const p_stage,
+                                     const char* const line, const unsigned int len)
+{
+    gm_cli_pipe_forward(p_stage, line, len);
+    gm_cli_pipe_forward(p_stage, "\r\n", 2);
+}
+
+/* 解析过滤器的数量参数，返回：0 - 成功，-1 - 参数错误 */
+static int gm_cli_filter_parse_num(gm_cli_pipe_stage_t* const p_stage,
+                                   const int argc, char* argv[])
+{
+    char* p_end;
+
+    p_stage->limit = 10;
+    if (argc == 2)
+    {
+        if (argv[1][0] == '-')
+        {
+            argv[1]++;
+        }
+        p_stage->limit = strtoul(argv[1], &p_end, 10);
+        if ((*p_end != '\0') || (p_end == argv[1]))
+        {
+            return -1;
+        }
+    }
+    else if (argc > 2)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/* grep过滤器选项 */
+#define GM_CLI_GREP_INVERT          0x01u   /* 反向匹配 */
+#define GM_CLI_GREP_IGNORE_CASE     0x02u   /* 忽略大小写 */
+
+/* 过滤器grep打开，grep [-v] [-i] pattern */
+static int gm_cli_filter_grep_open(gm_cli_pipe_stage_t* const p_stage,
+                                   int argc, char* argv[])
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+        {
+            p_stage->flags |= GM_CLI_GREP_INVERT;
+        }
+        else if (strcmp(argv[i], "-i") == 0)
+        {
+            p_stage->flags |= GM_CLI_GREP_IGNORE_CASE;
+        }
+        else if (p_stage->p_arg == NULL)
+        {
+            p_stage->p_arg = argv[i];
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    return (p_stage->p_arg != NULL) ? 0 : -1;
+}
+
+/* 过滤器grep处理一行 */
+static void gm_cli_filter_grep_line(gm_cli_pipe_stage_t* const p_stage,
+                                    const char* const line, const unsigned int len)
+{
+    int match;
+
+    match = (gm_cli_str_search(line, p_stage->p_arg,
+                               (p_stage->flags & GM_CLI_GREP_IGNORE_CASE) != 0) == 0);
+    if (match != ((p_stage->flags & GM_CLI_GREP_INVERT) != 0))
+    {
+        gm_cli_pipe_forward_line(p_stage, line, len);
+    }
+}
+
+/* 过滤器head打开，head [num] */
+static int gm_cli_filter_head_open(gm_cli_pipe_stage_t* const p_stage,
+                                   int argc, char* argv[])
+{
+    return gm_cli_filter_parse_num(p_stage, argc, argv);
+}
+
+/* 过滤器head处理一行 */
+static void gm_cli_filter_head_line(gm_cli_pipe_stage_t* const p_stage,
+                                    const char* const line, const unsigned int len)
+{
+    if (p_stage->count < p_stage->limit)
+    {
+        p_stage->count++;
+        gm_cli_pipe_forward_line(p_stage, line, len);
+    }
+}
+
+/* 过滤器tail打开，tail [num]，tail缓存只有一份，一条命令行只能使用一次 */
+static int gm_cli_filter_tail_open(gm_cli_pipe_stage_t* const p_stage,
+                                   int argc, char* argv[])
+{
+    if (gm_cli_mgr.pipe_tail_used)
+    {
+        return -1;
+    }
+    if (gm_cli_filter_parse_num(p_stage, argc, argv) != 0)
+    {
+        return -1;
+    }
+    gm_cli_mgr.pipe_tail_used = 1;
+    gm_cli_mgr.pipe_tail_pos = 0;
+    gm_cli_mgr.pipe_tail_len = 0;
+    return 0;
+}
+
+/* 过滤器tail缓存一个字符，缓存满时覆盖最早的数据 */
+static void gm_cli_filter_tail_push(const char ch)
+{
+    gm_cli_mgr.pipe_tail_buf[gm_cli_mgr.pipe_tail_pos++] = ch;
+    gm_cli_mgr.pipe_tail_pos %= GM_CLI_PIPE_TAIL_BUF_MAX;
+    if (gm_cli_mgr.pipe_tail_len < GM_CLI_PIPE_TAIL_BUF_MAX)
+    {
+        gm_cli_mgr.pipe_tail_len++;
+    }
+    else
+    {
+        /* 最早的行已被覆盖，标记为不完整 */
+        gm_cli_mgr.pipe_tail_used = 2;
+    }
+}
+
+/* 过滤器tail处理一行 */
+static void gm_cli_filter_tail_line(gm_cli_pipe_stage_t* const p_stage,
+                                    const char* const line, const unsigned int len)
+{
+    unsigned int i;
+
+    (void)p_stage;
+    for (i = 0; i < len; i++)
+    {
+        gm_cli_filter_tail_push(line[i]);
+    }
+    gm_cli_filter_tail_push('\n');
+}
+
+/* 过滤器tail读取缓存中的一个字符，index为从最早数据开始的偏移 */
+static char gm_cli_filter_tail_at(const unsigned int index)
+{
+    return gm_cli_mgr.pipe_tail_buf[(GM_CLI_PIPE_TAIL_BUF_MAX + gm_cli_mgr.pipe_tail_pos -
+                                     gm_cli_mgr.pipe_tail_len + index) % GM_CLI_PIPE_TAIL_BUF_MAX];
+}
+
+/* 过滤器tail输出缓存中的一段数据，缓存可能回绕，需要分两段输出 */
+static void gm_cli_filter_tail_emit(gm_cli_pipe_stage_t* const p_stage,
+                                    const unsigned int index, const unsigned int len)
+{
+    unsigned int pos = (GM_CLI_PIPE_TAIL_BUF_MAX + gm_cli_mgr.pipe_tail_pos -
+                        gm_cli_mgr.pipe_tail_len + index) % GM_CLI_PIPE_TAIL_BUF_MAX;
+    unsigned int len1 = GM_CLI_PIPE_TAIL_BUF_MAX - pos;
+
+    if (len1 >= len)
+    {
+        gm_cli_pipe_forward(p_stage, &gm_cli_mgr.pipe_tail_buf[pos], len);
+    }
+    else
+    {
+        gm_cli_pipe_forward(p_stage, &gm_cli_mgr.pipe_tail_buf[pos], len1);
+        gm_cli_pipe_forward(p_stage, &gm_cli_mgr.pipe_tail_buf[0], len - len1);
+    }
+}
+
+/* 过滤器tail关闭，输出缓存中最后的若干行 */
+static void gm_cli_filter_tail_close(gm_cli_pipe_stage_t* const p_stage)
+{
+    unsigned int total = gm_cli_mgr.pipe_tail_len;
+    unsigned int i, skip = 0, line_start;
+    unsigned long lines = 0;
+
+    /* 从末尾往前数换行，找到需要输出的起始位置 */
+    for (i = total; i > 0; i--)
+    {
+        if (gm_cli_filter_tail_at(i - 1) == '\n')
+        {
+            if (lines >= p_stage->limit)
+            {
+                skip = i;
+                break;
+            }
+            lines++;
+        }
+    }
+    if ((i == 0) && (gm_cli_mgr.pipe_tail_used == 2))
+    {
+        /* 最早的行已被覆盖不完整，跳过 */
+        while ((skip < total) && (gm_cli_filter_tail_at(skip) != '\n'))
+        {
+            skip++;
+        }
+        skip++;
+    }
+
+    /* 逐行输出 */
+    for (i = line_start = skip; i < total; i++)
+    {
+        if (gm_cli_filter_tail_at(i) == '\n')
+        {
+            gm_cli_filter_tail_emit(p_stage, line_start, i - line_start);
+            gm_cli_pipe_forward(p_stage, "\r\n", 2);
+            line_start = i + 1;
+        }
+    }
+    gm_cli_mgr.pipe_tail_used = 0;
+}
+
+/* 过滤器count处理一行 */
+static void gm_cli_filter_count_line(gm_cli_pipe_stage_t* const p_stage,
+                                     const char* const line, const unsigned int len)
+{
+    (void)line;
+    (void)len;
+    p_stage->count++;
+}
+
+/* 过滤器count关闭，输出行数 */
+static void gm_cli_filter_count_close(gm_cli_pipe_stage_t* const p_stage)
+{
+    char str[24];
+
+    gm_cli_pipe_forward_line(p_stage, str, gm_cli_ultoa(p_stage->count, str));
+}
+
+/* 过滤器count打开，count */
+static int gm_cli_filter_count_open(gm_cli_pipe_stage_t* const p_stage,
+                                    int argc, char* argv[])
+{
+    (void)p_stage;
+    (void)argv;
+    return (argc == 1) ? 0 : -1;
+}
+
+/* 内置管道过滤器表 */
+static const gm_cli_filter_t gm_cli_filters[] =
+{
+    { "grep",  gm_cli_filter_grep_open,  gm_cli_filter_grep_line,  NULL },
+    { "head",  gm_cli_filter_head_open,  gm_cli_filter_head_line,  NULL },
+    { "tail",  gm_cli_filter_tail_open,  gm_cli_filter_tail_line,  gm_cli_filter_tail_close },
+    { "count", gm_cli_filter_count_open, gm_cli_filter_count_line, gm_cli_filter_count_close },
+};
+
+/* 管道级输出通道写入，按行缓存后交给过滤器处理 */
+static void gm_cli_pipe_stage_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    gm_cli_pipe_stage_t* p_stage = (gm_cli_pipe_stage_t*)p_sink;
+    char ch;
+
+    while (len--)
+    {
+        ch = *buf++;
+        if (ch == '\r')
+        {
+            continue;
+        }
+        if ((ch == '\n') || (p_stage->buf_len >= sizeof(p_stage->buf) - 1))
+        {
+            /* 一行结束或行缓存满，交给过滤器处理 */
+            p_stage->buf[p_stage->buf_len] = '\0';
+            p_stage->p_filter->line(p_stage, p_stage->buf, p_stage->buf_len);
+            p_stage->buf_len = 0;
+            if (ch == '\n')
+            {
+                continue;
+            }
+        }
+        p_stage->buf[p_stage->buf_len++] = ch;
+    }
+}
+
+/* 打开管道并检查各过滤器参数，p_stage_str为各过滤器的命令行，p_subst不为NULL时
+ * 替换参数中的变量，替换后的参数放在p_subst中*p_pos开始的位置，
+ * 返回：0 - 成功，-1 - 失败 */
+static int gm_cli_pipe_open(char* p_stage_str[], const unsigned int num, char* const p_subst,
+                            unsigned int* const p_pos)
+{
+    gm_cli_pipe_stage_t* p_stage;
+    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
+    unsigned int i, j;
+    int argc;
+
+    gm_cli_mgr.pipe_tail_used = 0;
+    for (i = 0; i < num; i++)
+    {
+        p_stage = &gm_cli_mgr.pipe_stage[i];
+        argc = gm_cli_split_args(p_stage_str[i], argv);
+        if (argc == 0)
+        {
+            gm_cli_put_str("Empty pipe stage!\r\n");
+            return -1;
+        }
+#if GM_CLI_VAR_EN
+        if ((p_subst != NULL) && (gm_cli_var_subst_args(argc, argv, p_subst, p_pos) != 0))
+        {
+            return -1;
+        }
+#else
+        (void)p_subst;
+        (void)p_pos;
+#endif  /* GM_CLI_VAR_EN */
+
+        p_stage->p_filter = NULL;
+        for (j = 0; j < sizeof(gm_cli_filters) / sizeof(gm_cli_filters[0]); j++)
+        {
+            if (strcmp(gm_cli_filters[j].name, argv[0]) == 0)
+            {
+                p_stage->p_filter = &gm_cli_filters[j];
+                break;
+            }
+        }
+        if (p_stage->p_filter == NULL)
+        {
+            gm_cli_put_str("Not found filter \"");
+            gm_cli_put_str(argv[0]);
+            gm_cli_put_str("\", support: grep head tail count\r\n");
+            return -1;
+        }
+
+        p_stage->sink.write = gm_cli_pipe_stage_write;
+        p_stage->p_arg = NULL;
+        p_stage->limit = 0;
+        p_stage->count = 0;
+        p_stage->flags = 0;
+        p_stage->buf_len = 0;
+        if (p_stage->p_filter->open(p_stage, argc, argv) != 0)
+        {
+            gm_cli_put_str("Invalid args of filter \"");
+            gm_cli_put_str(argv[0]);
+            gm_cli_put_str("\"\r\n");
+            gm_cli_mgr.pipe_tail_used = 0;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* 挂接管道，各级依次连接，最后一级输出到当前输出通道 */
+static void gm_cli_pipe_attach(const unsigned int num)
+{
+    unsigned int i;
+
+    for (i = 0; i < num; i++)
+    {
+        gm_cli_mgr.pipe_stage[i].sink.next = (i + 1 < num) ?
+                                             &gm_cli_mgr.pipe_stage[i + 1].sink :
+                                             gm_cli_mgr.p_sink;
+    }
+    gm_cli_mgr.p_sink = &gm_cli_mgr.pipe_stage[0].sink;
+}
+
+/* 关闭管道，按顺序冲刷各级剩余的数据 */
+static void gm_cli_pipe_close(const unsigned int num)
+{
+    gm_cli_pipe_stage_t* p_stage;
+    unsigned int i;
+
+    gm_cli_mgr.p_sink = gm_cli_mgr.pipe_stage[num - 1].sink.next;
+    for (i = 0; i < num; i++)
+    {
+        p_stage = &gm_cli_mgr.pipe_stage[i];
+        if (p_stage->buf_len > 0)
+        {
+            p_stage->buf[p_stage->buf_len] = '\0';
+            p_stage->p_filter->line(p_stage, p_stage->buf, p_stage->buf_len);
+            p_stage->buf_len = 0;
+        }
+        if (p_stage->p_filter->close != NULL)
+        {
+            p_stage->p_filter->close(p_stage);
+        }
+    }
+}
+#endif  /* GM_CLI_PIPE_EN */
+
+#if GM_CLI_REDIRECT_SUPPORT
+/* 文件写缓存，按页对齐，攒满一块后整块写入 */
+static char gm_cli_file_buf[GM_CLI_REDIRECT_BUF_SIZE] __attribute__((aligned(4096)));
+
+/* 文件写缓存全部写入文件 */
+static void gm_cli_file_flush(const char* buf, unsigned int len)
+{
+    ssize_t ret;
+
+    while ((len > 0) && (gm_cli_mgr.file_err == 0))
+    {
+        ret = write(gm_cli_mgr.file_fd, buf, len);
+        if (ret <= 0)
+        {
+            gm_cli_mgr.file_err = 1;
+            break;
+        }
+        buf += ret;
+        len -= (unsigned int)ret;
+    }
+}
+
+/* 文件输出通道写入 */
+static void gm_cli_file_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    unsigned int n;
+
+    (void)p_sink;
+    while (len > 0)
+    {
+        if ((gm_cli_mgr.file_buf_len == 0) && (len >= GM_CLI_REDIRECT_BUF_SIZE))
+        {
+            /* 缓存为空且数据超过一块，整块直接写入 */
+            n = len - (len % GM_CLI_REDIRECT_BUF_SIZE);
+            gm_cli_file_flush(buf, n);
+        }
+        else
+        {
+            n = GM_CLI_REDIRECT_BUF_SIZE - gm_cli_mgr.file_buf_len;
+            if (n > len)
+            {
+                n = len;
+            }
+            memcpy(&gm_cli_file_buf[gm_cli_mgr.file_buf_len], buf, n);
+            gm_cli_mgr.file_buf_len += n;
+            if (gm_cli_mgr.file_buf_len >= GM_CLI_REDIRECT_BUF_SIZE)
+            {
+                gm_cli_file_flush(gm_cli_file_buf, gm_cli_mgr.file_buf_len);
+                gm_cli_mgr.file_buf_len = 0;
+            }
+        }
+        buf += n;
+        len -= n;
+    }
+}
+
+/* 打开重定向文件并替换当前输出通道，返回：0 - 成功，-1 - 失败 */
+static int gm_cli_redirect_open(const char* const path, const int append)
+{
+    gm_cli_mgr.file_fd = open(path, O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+    if (gm_cli_mgr.file_fd < 0)
+    {
+        gm_cli_put_str("Open file \"");
+        gm_cli_put_str(path);
+        gm_cli_put_str("\" failed\r\n");
+        return -1;
+    }
+    gm_cli_mgr.file_buf_len = 0;
+    gm_cli_mgr.file_err = 0;
+    gm_cli_mgr.file_sink.write = gm_cli_file_sink_write;
+    gm_cli_mgr.file_sink.next = NULL;
+    return 0;
+}
+
+/* 挂接文件输出通道，替换当前输出通道 */
+static void gm_cli_redirect_attach(void)
+{
+    gm_cli_mgr.file_sink.next = gm_cli_mgr.p_sink;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.file_sink;
+}
+
+/* 写入剩余数据，关闭重定向文件并恢复原输出通道 */
+static void gm_cli_redirect_close(void)
+{
+    gm_cli_file_flush(gm_cli_file_buf, gm_cli_mgr.file_buf_len);
+    gm_cli_mgr.file_buf_len = 0;
+    if (gm_cli_mgr.p_sink == &gm_cli_mgr.file_sink)
+    {
+        gm_cli_mgr.p_sink = gm_cli_mgr.file_sink.next;
+    }
+    if (close(gm_cli_mgr.file_fd) != 0)
+    {
+        gm_cli_mgr.file_err = 1;
+    }
+    if (gm_cli_mgr.file_err)
+    {
+        gm_cli_put_str("Write file failed\r\n");
+    }
+}
+
+/* 解析重定向，将'>'及后面的文件名从行中截断，返回：0 - 无重定向，1 - 覆盖写，
+ * 2 - 追加写，-1 - 格式错误 */
+static int gm_cli_redirect_parse(char* const line, char** const p_path)
+{
+    char *p, *p_end;
+    int mode;
+
+    p = gm_cli_str_find_unquoted(line, '>');
+    if (p == NULL)
+    {
+        return 0;
+    }
+    *p++ = '\0';
+    mode = 1;
+    if (*p == '>')
+    {
+        p++;
+        mode = 2;
+    }
+
+    /* 取出文件名，只允许一个 */
+    while (*p == ' ')
+    {
+        p++;
+    }
+    p_end = p;
+    while ((*p_end != ' ') && (*p_end != '\0'))
+    {
+        p_end++;
+    }
+    *p_path = p;
+    if (p_end == p)
+    {
+        return -1;
+    }
+    if (*p_end != '\0')
+    {
+        *p_end++ = '\0';
+        if (gm_cli_str_empty_check(p_end) != 0)
+        {
+            return -1;
+        }
+    }
+    return (gm_cli_str_find_unquoted(p, '>') == NULL) ? mode : -1;
+}
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+
+/* 调用命令回调函数，返回命令返回值 */
+#if GM_CLI_BUDGET_EN
+/* 开始计时，嵌套执行的命令（别名和周期命令中的命令）使用最外层命令的预算，
+ * 返回：1 - 本次开始计时，0 - 已在计时 */
+static int gm_cli_budget_begin(const gm_cli_cmd_t* const p_cmd)
+{
+    if (gm_cli_atomic_load(&gm_cli_mgr.run_active))
+    {
+        return 0;
+    }
+    gm_cli_atomic_store(&gm_cli_mgr.run_abort, GM_CLI_ABORT_NONE);
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        gm_cli_mgr.run_start = gm_cli_mgr.pf_tick();
+        gm_cli_mgr.run_budget = (p_cmd->budget_ms > 0) ? p_cmd->budget_ms : GM_CLI_CMD_BUDGET_MS;
+    }
+    else
+    {
+        gm_cli_mgr.run_start = 0;
+        gm_cli_mgr.run_budget = 0;
+    }
+    gm_cli_mgr.p_run_cmd = p_cmd;
+    /* 命令执行期间收到的输入从解析器当前的状态开始预解析 */
+#if GM_CLI_BRACKETED_PASTE_EN
+    gm_cli_mgr.peek_paste = gm_cli_mgr.paste_mode;
+    gm_cli_mgr.peek_seq = 0;
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_BIN_EN
+    gm_cli_mgr.peek_bin = gm_cli_mgr.bin_mode;
+    gm_cli_mgr.peek_bin_match = gm_cli_mgr.bin_match;
+#endif  /* GM_CLI_BIN_EN */
+    /* 最后设置执行标志，其他线程看到时命令、开始时间和预算已经有效 */
+    gm_cli_atomic_store(&gm_cli_mgr.run_active, 1);
+    return 1;
+}
+
+/* 命令返回后计入统计，超过预算或被中止时提示 */
+static void gm_cli_budget_report(const gm_cli_cmd_t* const p_cmd, const unsigned long elapsed,
+                                 const unsigned long budget, const unsigned int abort_reason)
+{
+    if (elapsed > gm_cli_mgr.wdog_max_ms)
+    {
+        gm_cli_mgr.wdog_max_ms = elapsed;
+    }
+    if ((abort_reason == GM_CLI_ABORT_BUDGET) || ((budget > 0) && (elapsed > budget)))
+    {
+        gm_cli_mgr.wdog_overruns++;
+        /* 复制命令名，命令所在的插件可能被卸载 */
+        strncpy(gm_cli_mgr.wdog_last_name, p_cmd->name, sizeof(gm_cli_mgr.wdog_last_name) - 1);
+        gm_cli_mgr.wdog_last_name[sizeof(gm_cli_mgr.wdog_last_name) - 1] = '\0';
+        gm_cli_mgr.wdog_last_ms = elapsed;
+        gm_cli_mgr.wdog_last_budget = budget;
+        gm_cli_printf("Command \"%s\" overran its budget: %lu/%lu ms\r\n",
+                      p_cmd->name, elapsed, budget);
+    }
+    if (abort_reason == GM_CLI_ABORT_USER)
+    {
+        gm_cli_mgr.wdog_aborts++;
+        gm_cli_printf("Command \"%s\" aborted\r\n", p_cmd->name);
+    }
+}
+
+/* 结束计时，超过预算或被中止时提示并计入统计 */
+static void gm_cli_budget_end(void)
+{
+    const gm_cli_cmd_t* p_cmd = gm_cli_mgr.p_run_cmd;
+    unsigned long elapsed = 0;
+    unsigned int abort_reason;
+
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        elapsed = gm_cli_mgr.pf_tick() - gm_cli_mgr.run_start;
+    }
+    gm_cli_atomic_store(&gm_cli_mgr.run_active, 0);
+    abort_reason = gm_cli_atomic_xchg(&gm_cli_mgr.run_abort, GM_CLI_ABORT_NONE);
+    gm_cli_budget_report(p_cmd, elapsed, gm_cli_mgr.run_budget, abort_reason);
+}
+
+#if GM_CLI_BATCH_EN
+/* 查询工作线程中执行的任务是否应该中止 */
+static int gm_cli_batch_should_abort(gm_cli_batch_job_t* const p_job)
+{
+    if (gm_cli_atomic_load(&p_job->run_abort) != GM_CLI_ABORT_NONE)
+    {
+        return 1;
+    }
+    if (gm_cli_atomic_load(&gm_cli_batch_abort))
+    {
+        gm_cli_atomic_cas(&p_job->run_abort, GM_CLI_ABORT_NONE, GM_CLI_ABORT_USER);
+        return 1;
+    }
+    if ((p_job->run_budget > 0) &&
+        (gm_cli_mgr.pf_tick() - p_job->run_start >= p_job->run_budget))
+    {
+        gm_cli_atomic_cas(&p_job->run_abort, GM_CLI_ABORT_NONE, GM_CLI_ABORT_BUDGET);
+        return 1;
+    }
+    return 0;
+}
+#endif  /* GM_CLI_BATCH_EN */
+
+/* 查询正在执行的命令是否应该中止 */
+int gm_cli_should_abort(void)
+{
+#if GM_CLI_BATCH_EN
+    if (gm_cli_batch_job != NULL)
+    {
+        return gm_cli_batch_should_abort(gm_cli_batch_job);
+    }
+#endif  /* GM_CLI_BATCH_EN */
+    if (gm_cli_atomic_load(&gm_cli_mgr.run_abort) != GM_CLI_ABORT_NONE)
+    {
+        return 1;
+    }
+    if (!gm_cli_atomic_load(&gm_cli_mgr.run_active) || (gm_cli_mgr.run_budget == 0))
+    {
+        return 0;
+    }
+    if (gm_cli_mgr.pf_tick() - gm_cli_mgr.run_start >= gm_cli_mgr.run_budget)
+    {
+        /* 用户中止的标志不覆盖 */
+        gm_cli_atomic_cas(&gm_cli_mgr.run_abort, GM_CLI_ABORT_NONE, GM_CLI_ABORT_BUDGET);
+        return 1;
+    }
+    return 0;
+}
+
+/* 请求中止正在执行的命令 */
+int gm_cli_request_abort(void)
+{
+    int ret = -1;
+
+#if GM_CLI_BATCH_EN
+    if (gm_cli_atomic_load(&gm_cli_batch_active))
+    {
+        gm_cli_atomic_store(&gm_cli_batch_abort, 1);
+        ret = 0;
+    }
+#endif  /* GM_CLI_BATCH_EN */
+    if (gm_cli_atomic_load(&gm_cli_mgr.run_active))
+    {
+        gm_cli_atomic_store(&gm_cli_mgr.run_abort, GM_CLI_ABORT_USER);
+        ret = 0;
+    }
+    return ret;
+}
+
+/* 检查正在执行的命令是否超过预算 */
+int gm_cli_watchdog_poll(void)
+{
+    if (!gm_cli_atomic_load(&gm_cli_mgr.run_active))
+    {
+#if GM_CLI_BATCH_EN
+        /* 工作线程中的命令由gm_cli_should_abort检查各自的预算 */
+        if (gm_cli_atomic_load(&gm_cli_batch_active))
+        {
+            return 0;
+        }
+#endif  /* GM_CLI_BATCH_EN */
+        return -1;
+    }
+    if (gm_cli_atomic_load(&gm_cli_mgr.run_abort) == GM_CLI_ABORT_BUDGET)
+    {
+        return 1;
+    }
+    if ((gm_cli_mgr.run_budget == 0) ||
+        (gm_cli_mgr.pf_tick() - gm_cli_mgr.run_start < gm_cli_mgr.run_budget))
+    {
+        return 0;
+    }
+    /* 用户中止的标志不覆盖 */
+    gm_cli_atomic_cas(&gm_cli_mgr.run_abort, GM_CLI_ABORT_NONE, GM_CLI_ABORT_BUDGET);
+    return 1;
+}
+#endif  /* GM_CLI_BUDGET_EN */
+
+static int gm_cli_call_cmd(const gm_cli_cmd_t* const p_cmd, int argc, char* argv[])
+{
+    int ret = 0;
+#if GM_CLI_BUDGET_EN
+    int timing;
+#endif  /* GM_CLI_BUDGET_EN */
+
+#if GM_CLI_EMIT_EN
+    gm_cli_emit_parse_args(p_cmd, &argc, argv);
+#endif  /* GM_CLI_EMIT_EN */
+    if (p_cmd->cb)
+    {
+#if GM_CLI_BUDGET_EN
+        timing = gm_cli_budget_begin(p_cmd);
+#endif  /* GM_CLI_BUDGET_EN */
+        GM_CLI_TRACE(GM_CLI_TRACE_CMD | GM_CLI_TRACE_BEGIN, argc);
+        ret = p_cmd->cb(argc, argv);
+        GM_CLI_TRACE(GM_CLI_TRACE_CMD | GM_CLI_TRACE_END, ret);
+#if GM_CLI_BUDGET_EN
+        if (timing)
+        {
+            gm_cli_budget_end();
+        }
+#endif  /* GM_CLI_BUDGET_EN */
+    }
+#if GM_CLI_EMIT_EN
+    if ((gm_cli_emit_finish(p_cmd) != 0) && (ret == 0))
+    {
+        ret = -1;
+    }
+#endif  /* GM_CLI_EMIT_EN */
+    return ret;
+}
+
+#if GM_CLI_CACHE_EN
+/* 输出缓存 */
+static gm_cli_cache_t gm_cli_cache[GM_CLI_CACHE_ENTRY_NUM];
+
+/* 输出缓存捕获通道写入，数据同时传给下一级 */
+static void gm_cli_cache_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    gm_cli_cache_t* p_cache = gm_cli_mgr.p_cache_fill;
+
+    if (!gm_cli_mgr.cache_overflow)
+    {
+        if (len > GM_CLI_CACHE_BUF_SIZE - p_cache->len)
+        {
+            gm_cli_mgr.cache_overflow = 1;
+        }
+        else
+        {
+            memcpy(&p_cache->buf[p_cache->len], buf, len);
+            p_cache->len += len;
+        }
+    }
+    p_sink->next->write(p_sink->next, buf, len);
+}
+
+/* 查找命令的输出缓存，返回有效缓存或分配给本次执行的空缓存，NULL表示不缓存 */
+static gm_cli_cache_t* gm_cli_cache_find(const gm_cli_cmd_t* const p_cmd,
+                                         const int argc, char* argv[])
+{
+    char key[GM_CLI_CACHE_KEY_MAX];
+    unsigned int key_len = 0, len, i;
+    unsigned long now;
+    gm_cli_cache_t* p_cache;
+    gm_cli_cache_t* p_free = NULL;
+    int n;
+
+    /* 命令中嵌套执行命令时，只缓存最外层 */
+    if (((p_cmd->flags & GM_CLI_CMD_FLAG_IDEMPOTENT) == 0) || (p_cmd->ttl_ms == 0) ||
+        (gm_cli_mgr.pf_tick == NULL) || (gm_cli_mgr.p_cache_fill != NULL))
+    {
+        return NULL;
+    }
+
+    /* 以全部参数作为缓存键，参数中不会有'\0'，以它分隔，"a b"和a b是不同的键 */
+    for (n = 0; n < argc; n++)
+    {
+        len = (unsigned int)strlen(argv[n]) + 1;
+        if (key_len + len > GM_CLI_CACHE_KEY_MAX)
+        {
+            return NULL;
+        }
+        memcpy(&key[key_len], argv[n], len);
+        key_len += len;
+    }
+
+    now = gm_cli_mgr.pf_tick();
+    for (i = 0; i < GM_CLI_CACHE_ENTRY_NUM; i++)
+    {
+        p_cache = &gm_cli_cache[i];
+        if ((p_cache->p_cmd == p_cmd) && (p_cache->key_len == key_len) &&
+#if GM_CLI_EMIT_EN
+            (p_cache->fmt == gm_cli_mgr.emit_fmt) &&
+#endif  /* GM_CLI_EMIT_EN */
+            (memcmp(p_cache->key, key, key_len) == 0))
+        {
+            if (p_cache->valid && (now - p_cache->stamp < p_cmd->ttl_ms))
+            {
+                gm_cli_mgr.cache_hit++;
+                return p_cache;
+            }
+            /* 已过期，原位置重新缓存 */
+            p_free = p_cache;
+            break;
+        }
+        /* 优先使用空闲的，否则替换最早缓存的 */
+        if ((p_free == NULL) || ((p_free->p_cmd != NULL) &&
+            ((p_cache->p_cmd == NULL) || !p_cache->valid ||
+             (now - p_cache->stamp > now - p_free->stamp))))
+        {
+            p_free = p_cache;
+        }
+    }
+
+    gm_cli_mgr.cache_miss++;
+    p_free->p_cmd = p_cmd;
+    p_free->valid = 0;
+    p_free->stamp = now;
+#if GM_CLI_EMIT_EN
+    p_free->fmt = gm_cli_mgr.emit_fmt;
+#endif  /* GM_CLI_EMIT_EN */
+    p_free->key_len = key_len;
+    memcpy(p_free->key, key, key_len);
+    p_free->len = 0;
+    return p_free;
+}
+
+/* 开始捕获命令输出 */
+static void gm_cli_cache_attach(gm_cli_cache_t* const p_cache)
+{
+    gm_cli_mgr.p_cache_fill = p_cache;
+    gm_cli_mgr.cache_overflow = 0;
+    gm_cli_mgr.cache_sink.write = gm_cli_cache_sink_write;
+    gm_cli_mgr.cache_sink.next = gm_cli_mgr.p_sink;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.cache_sink;
+}
+
+/* 结束捕获命令输出，命令执行成功且输出未超过缓存大小时缓存生效 */
+static void gm_cli_cache_close(const int ret)
+{
+    gm_cli_cache_t* p_cache = gm_cli_mgr.p_cache_fill;
+
+    gm_cli_mgr.p_sink = gm_cli_mgr.cache_sink.next;
+    gm_cli_mgr.p_cache_fill = NULL;
+    if ((ret == 0) && !gm_cli_mgr.cache_overflow)
+    {
+        p_cache->ret = ret;
+        p_cache->valid = 1;
+    }
+    else
+    {
+        p_cache->p_cmd = NULL;
+    }
+}
+
+/* 使命令的输出缓存失效 */
+void gm_cli_cache_invalidate(const char* const name)
+{
+    unsigned int i;
+
+    for (i = 0; i < GM_CLI_CACHE_ENTRY_NUM; i++)
+    {
+        /* 正在写入的缓存也要失效，写入完成后不会生效 */
+        if ((gm_cli_cache[i].p_cmd != NULL) &&
+            ((name == NULL) || (strcmp(gm_cli_cache[i].p_cmd->name, name) == 0)))
+        {
+            gm_cli_cache[i].valid = 0;
+            if (&gm_cli_cache[i] == gm_cli_mgr.p_cache_fill)
+            {
+                gm_cli_mgr.cache_overflow = 1;
+            }
+        }
+    }
+}
+
+/* 读取输出缓存的命中和未命中次数 */
+void gm_cli_cache_get_stats(unsigned long* const p_hit, unsigned long* const p_miss)
+{
+    if (p_hit != NULL)
+    {
+        *p_hit = gm_cli_mgr.cache_hit;
+    }
+    if (p_miss != NULL)
+    {
+        *p_miss = gm_cli_mgr.cache_miss;
+    }
+}
+#endif  /* GM_CLI_CACHE_EN */
+
+/* 执行命令，可缓存的命令优先使用缓存，返回命令返回值 */
+static int gm_cli_run_cmd(const gm_cli_cmd_t* const p_cmd, int argc, char* argv[])
+{
+#if GM_CLI_CACHE_EN
+    gm_cli_cache_t* p_cache;
+    int ret;
+
+    p_cache = gm_cli_cache_find(p_cmd, argc, argv);
+    if (p_cache == NULL)
+    {
+        return gm_cli_call_cmd(p_cmd, argc, argv);
+    }
+    if (p_cache->valid)
+    {
+        /* 缓存的是命令原始输出，仍然经过管道和重定向 */
+        gm_cli_put_buf(p_cache->buf, p_cache->len);
+        return p_cache->ret;
+    }
+    gm_cli_cache_attach(p_cache);
+    ret = gm_cli_call_cmd(p_cmd, argc, argv);
+    gm_cli_cache_close(ret);
+    return ret;
+#else
+    return gm_cli_call_cmd(p_cmd, argc, argv);
+#endif  /* GM_CLI_CACHE_EN */
+}
+
+#if GM_CLI_ALIAS_EN
+/* 删除运行时别名，后面的别名数据前移 */
+static void gm_cli_alias_del(gm_cli_alias_t* const p_alias)
+{
+    unsigned int pos = p_alias->pos, len = p_alias->len, i;
+
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    gm_cli_cmd_index_del(&p_alias->cmd);
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
+    memmove(&gm_cli_alias_arena[pos], &gm_cli_alias_arena[pos + len],
+            gm_cli_mgr.alias_used - pos - len);
+    gm_cli_mgr.alias_used -= len;
+    p_alias->cmd.name = NULL;
+
+    for (i = 0; i < GM_CLI_ALIAS_NUM; i++)
+    {
+        if ((gm_cli_alias[i].cmd.name != NULL) && (gm_cli_alias[i].pos > pos))
+        {
+            gm_cli_alias[i].pos -= len;
+            gm_cli_alias[i].cmd.name -= len;
+            gm_cli_alias[i].cmd.usage -= len;
+            gm_cli_alias[i].p_args -= len;
+        }
+    }
+}
+
+/* 定义运行时别名，def为"名字=定义"，定义在此解析一次，返回：0 - 成功，-1 - 失败 */
+static int gm_cli_alias_define(char* const def)
+{
+    char body[GM_CLI_LINE_CHAR_MAX];
+    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
+    char* p_body;
+    char* p_part;
+    char* p_next;
+    char* p_arena;
+    gm_cli_alias_t* p_alias = NULL;
+    const gm_cli_cmd_t* p_cmd;
+    unsigned int name_len, body_len, len, n, i;
+    int argc, k;
+
+    p_body = strchr(def, '=');
+    if (p_body != NULL)
+    {
+        *p_body++ = '\0';
+    }
+    if ((p_body == NULL) || (*def == '\0') || (strpbrk(def, "'\";|>") != NULL))
+    {
+        gm_cli_put_str("Invalid alias! Usage: alias name='cmd [args][; cmd [args]]'\r\n");
+        return -1;
+    }
+    name_len = (unsigned int)strlen(def) + 1;
+    body_len = (unsigned int)strlen(p_body) + 1;
+    if (body_len > sizeof(body))
+    {
+        gm_cli_put_str("Alias too long!\r\n");
+        return -1;
+    }
+    if ((gm_cli_str_find_unquoted(p_body, '|') != NULL) ||
+        (gm_cli_str_find_unquoted(p_body, '>') != NULL))
+    {
+        gm_cli_put_str("Pipe and redirection are not supported in alias!\r\n");
+        return -1;
+    }
+    if ((strchr(p_body, '\'') != NULL) && (strchr(p_body, '"') != NULL))
+    {
+        gm_cli_put_str("Alias can not contain both ' and \"!\r\n");
+        return -1;
+    }
+
+    p_cmd = gm_cli_search_cmd(def);
+    if (p_cmd != NULL)
+    {
+        if (!(p_cmd->flags & GM_CLI_CMD_FLAG_MACRO))
+        {
+            gm_cli_put_str("Can not redefine a command!\r\n");
+            return -1;
+        }
+        p_alias = (gm_cli_alias_t*)p_cmd;
+    }
+    for (i = 0; (p_alias == NULL) && (i < GM_CLI_ALIAS_NUM); i++)
+    {
+        if (gm_cli_alias[i].cmd.name == NULL)
+        {
+            p_alias = &gm_cli_alias[i];
+        }
+    }
+    if (p_alias == NULL)
+    {
+        gm_cli_put_str("Too many aliases!\r\n");
+        return -1;
+    }
+
+    /* 新定义先写在存储区已用部分之后，成功后再删除旧定义 */
+    p_arena = &gm_cli_alias_arena[gm_cli_mgr.alias_used];
+    len = name_len + body_len + 1;
+    if (gm_cli_mgr.alias_used + len > GM_CLI_ALIAS_ARENA_SIZE)
+    {
+        gm_cli_put_str("Alias arena full!\r\n");
+        return -1;
+    }
+    memcpy(p_arena, def, name_len);
+    memcpy(&p_arena[name_len], p_body, body_len);
+    p_arena[name_len + body_len] = 0;
+
+    /* 按引号外的';'分割为多条命令，逐条分割参数 */
+    memcpy(body, p_body, body_len);
+    for (p_part = body; p_part != NULL; p_part = p_next)
+    {
+        p_next = gm_cli_str_find_unquoted(p_part, ';');
+        if (p_next != NULL)
+        {
+            *p_next++ = '\0';
+        }
+        argc = gm_cli_split_args(p_part, argv);
+        if (argc == 0)
+        {
+            continue;
+        }
+        if (gm_cli_mgr.alias_used + len + 1 > GM_CLI_ALIAS_ARENA_SIZE)
+        {
+            gm_cli_put_str("Alias arena full!\r\n");
+            return -1;
+        }
+        p_arena[len++] = (char)argc;
+        for (k = 0; k < argc; k++)
+        {
+            n = (unsigned int)strlen(argv[k]);
+            if (gm_cli_mgr.alias_used + len + n + 2 > GM_CLI_ALIAS_ARENA_SIZE)
+            {
+                gm_cli_put_str("Alias arena full!\r\n");
+                return -1;
+            }
+            p_arena[len++] = (char)n;
+            memcpy(&p_arena[len], argv[k], n + 1);
+            len += n + 1;
+        }
+        p_arena[name_len + body_len]++;
+    }
+    if (p_arena[name_len + body_len] == 0)
+    {
+        gm_cli_put_str("Empty alias!\r\n");
+        return -1;
+    }
+
+    gm_cli_mgr.alias_used += len;
+    if (p_alias->cmd.name != NULL)
+    {
+        gm_cli_alias_del(p_alias);
+        p_arena -= p_alias->len;
+    }
+    p_alias->pos = (unsigned int)(p_arena - gm_cli_alias_arena);
+    p_alias->len = len;
+    p_alias->p_args = (const unsigned char*)&p_arena[name_len + body_len];
+    p_alias->cmd.name = p_arena;
+    p_alias->cmd.usage = &p_arena[name_len];
+    p_alias->cmd.cb = NULL;
+    p_alias->cmd.link = NULL;
+    p_alias->cmd.flags = GM_CLI_CMD_FLAG_MACRO;
+    p_alias->cmd.ttl_ms = 0;
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    if (gm_cli_mgr.cmd_index_ok && (gm_cli_cmd_index_add(gm_cli_cmd_index, &p_alias->cmd) != 0))
+    {
+        /* 索引已满，改为逐个查找 */
+        gm_cli_mgr.cmd_index_ok = 0;
+    }
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
+    return 0;
+}
+
+/* 输出别名定义 */
+static void gm_cli_alias_put(const gm_cli_alias_t* const p_alias)
+{
+    char quote = (strchr(p_alias->cmd.usage, '\'') != NULL) ? '"' : '\'';
+
+    gm_cli_put_str("alias ");
+    gm_cli_put_str(p_alias->cmd.name);
+    gm_cli_put_char('=');
+    gm_cli_put_char(quote);
+    gm_cli_put_str(p_alias->cmd.usage);
+    gm_cli_put_char(quote);
+}
+
+/* 执行运行时别名，直接使用解析好的参数，调用时的参数追加到最后一条命令，
+ * 有命令返回非0时停止，返回最后执行的命令的返回值 */
+static int gm_cli_alias_run(const gm_cli_cmd_t* const p_cmd, const int argc, char* argv[])
+{
+    const unsigned char* p = ((const gm_cli_alias_t*)p_cmd)->p_args;
+    char* args[GM_CLI_CMD_ARGS_NUM_MAX];
+    const gm_cli_cmd_t* p_target;
+    unsigned int cmd_num = *p++, n, i;
+    int ret = 0, k;
+
+    gm_cli_mgr.alias_running = 1;
+    while (cmd_num-- > 0)
+    {
+        n = *p++;
+        for (i = 0; i < n; i++)
+        {
+            args[i] = (char*)&p[1];
+            p += p[0] + 2;
+        }
+        for (k = 1; (cmd_num == 0) && (k < argc) && (n < GM_CLI_CMD_ARGS_NUM_MAX); k++)
+        {
+            args[n++] = argv[k];
+        }
+
+        /* 别名只能展开为命令，不能嵌套别名 */
+        p_target = gm_cli_search_cmd(args[0]);
+        if ((p_target != NULL) && (p_target->link != NULL))
+        {
+            p_target = p_target->link;
+        }
+        if (p_target == NULL)
+        {
+            gm_cli_put_not_found(args[0]);
+            ret = -1;
+            break;
+        }
+        if (p_target->flags & GM_CLI_CMD_FLAG_MACRO)
+        {
+            gm_cli_put_str("Can not run alias in alias \"");
+            gm_cli_put_str(args[0]);
+            gm_cli_put_str("\"\r\n");
+            ret = -1;
+            break;
+        }
+        ret = gm_cli_run_cmd(p_target, (int)n, args);
+        if (ret != 0)
+        {
+            break;
+        }
+    }
+    gm_cli_mgr.alias_running = 0;
+
+    return ret;
+}
+#endif  /* GM_CLI_ALIAS_EN */
+
+#if GM_CLI_VAR_EN
+/* 变量名首字符 */
+#define GM_CLI_VAR_HEAD(ch)         (isalpha((unsigned char)(ch)) || ((ch) == '_'))
+/* 变量名其他字符 */
+#define GM_CLI_VAR_CHAR(ch)         (isalnum((unsigned char)(ch)) || ((ch) == '_'))
+
+/* 变量名长度，不是合法的变量名时返回0 */
+static unsigned int gm_cli_var_name_len(const char* const name)
+{
+    unsigned int len = 0;
+
+    if (!GM_CLI_VAR_HEAD(name[0]))
+    {
+        return 0;
+    }
+    while (GM_CLI_VAR_CHAR(name[len]))
+    {
+        len++;
+    }
+    return len;
+}
+
+/* 变量名哈希，FNV-1a，名字不要求以'\0'结尾 */
+static unsigned int gm_cli_var_hash(const char* const name, const unsigned int len)
+{
+    unsigned long hash = 2166136261ul;
+    unsigned int i;
+
+    for (i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619ul;
+    }
+    return (unsigned int)(hash & (GM_CLI_VAR_NUM - 1));
+}
+
+/* 查找变量，返回槽序号，不存在时返回-1 */
+static int gm_cli_var_find(const char* const name, const unsigned int len)
+{
+    unsigned int i = gm_cli_var_hash(name, len), n;
+    const gm_cli_var_t* p_var;
+
+    for (n = 0; n < GM_CLI_VAR_NUM; n++)
+    {
+        p_var = &gm_cli_var[i];
+        if (p_var->state == GM_CLI_VAR_EMPTY)
+        {
+            break;
+        }
+        if ((p_var->state == GM_CLI_VAR_USED) &&
+            (strncmp(p_var->name, name, len) == 0) && (p_var->name[len] == '\0'))
+        {
+            return (int)i;
+        }
+        i = (i + 1) & (GM_CLI_VAR_NUM - 1);
+    }
+    return -1;
+}
+
+/* 设置变量，不存在时新建，返回：0 - 成功，-1 - 失败 */
+static int gm_cli_var_set(const char* const name, const char* const value)
+{
+    unsigned int name_len = gm_cli_var_name_len(name);
+    unsigned int len = (unsigned int)strlen(value);
+    gm_cli_var_t* p_var;
+    unsigned int i;
+    int index;
+
+    if ((name_len == 0) || (name[name_len] != '\0'))
+    {
+        gm_cli_put_str("Invalid variable name!\r\n");
+        return -1;
+    }
+    if (name_len >= GM_CLI_VAR_NAME_MAX)
+    {
+        gm_cli_put_str("Variable name too long!\r\n");
+        return -1;
+    }
+    if (len >= GM_CLI_VAR_VALUE_MAX)
+    {
+        gm_cli_put_str("Variable value too long!\r\n");
+        return -1;
+    }
+
+    index = gm_cli_var_find(name, name_len);
+    if (index < 0)
+    {
+        /* 至少保留一个空闲槽，保证查找能结束 */
+        if (gm_cli_mgr.var_num >= GM_CLI_VAR_NUM - 1)
+        {
+            gm_cli_put_str("Too many variables!\r\n");
+            return -1;
+        }
+        i = gm_cli_var_hash(name, name_len);
+        while (gm_cli_var[i].state == GM_CLI_VAR_USED)
+        {
+            i = (i + 1) & (GM_CLI_VAR_NUM - 1);
+        }
+        index = (int)i;
+        memcpy(gm_cli_var[index].name, name, name_len + 1);
+        gm_cli_var[index].state = GM_CLI_VAR_USED;
+        gm_cli_mgr.var_num++;
+    }
+    p_var = &gm_cli_var[index];
+    memcpy(p_var->value, value, len + 1);
+    p_var->len = (unsigned char)len;
+    return 0;
+}
+
+/* 删除变量，编译好的模板可能引用了这个槽，需要重新编译 */
+static void gm_cli_var_del(gm_cli_var_t* const p_var)
+{
+    p_var->state = GM_CLI_VAR_DELETED;
+    gm_cli_mgr.var_num--;
+    gm_cli_mgr.var_gen++;
+}
+
+/* 输出变量定义，单引号放在双引号中，其他内容放在单引号中，相连的各段解析为一个参数，
+ * 读回时不会替换其中的'$' */
+static void gm_cli_var_put(const gm_cli_var_t* const p_var)
+{
+    unsigned int i = 0, n;
+    char quote;
+
+    gm_cli_put_str("set ");
+    gm_cli_put_str(p_var->name);
+    gm_cli_put_char(' ');
+    do
+    {
+        quote = (p_var->value[i] == '\'') ? '"' : '\'';
+        n = i;
+        while ((n < p_var->len) && ((p_var->value[n] == '\'') == (quote == '"')))
+        {
+            n++;
+        }
+        gm_cli_put_char(quote);
+        gm_cli_put_buf(&p_var->value[i], n - i);
+        gm_cli_put_char(quote);
+        i = n;
+    } while (i < p_var->len);
+}
+
+/* 模板增加一段，和上一段原样复制的内容相连时合并，返回：0 - 成功，-1 - 段数超出 */
+static int gm_cli_tmpl_add(gm_cli_tmpl_t* const p_tmpl, const unsigned int pos, const unsigned int len)
+{
+    gm_cli_tmpl_seg_t* p_last;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+    if ((p_tmpl->seg_num > 0) && (len != GM_CLI_TMPL_VAR))
+    {
+        p_last = &p_tmpl->seg[p_tmpl->seg_num - 1];
+        if ((p_last->len != GM_CLI_TMPL_VAR) && (p_last->pos + p_last->len == pos))
+        {
+            p_last->len = (unsigned short)(p_last->len + len);
+            return 0;
+        }
+    }
+    if (p_tmpl->seg_num >= GM_CLI_VAR_SEG_MAX)
+    {
+        gm_cli_put_str("Too many variables in line!\r\n");
+        return -1;
+    }
+    p_tmpl->seg[p_tmpl->seg_num].pos = (unsigned short)pos;
+    p_tmpl->seg[p_tmpl->seg_num].len = (unsigned short)len;
+    p_tmpl->seg_num++;
+    return 0;
+}
+
+/* 扫描一个源串加入模板，命令行中单引号内不替换，参数的引号已经去掉，结束的'\0'
+ * 也作为原样复制的字符，返回：0 - 成功，-1 - 变量不存在或格式错误 */
+static int gm_cli_tmpl_scan(gm_cli_tmpl_t* const p_tmpl, const char* const src)
+{
+    const char* p_base = p_tmpl->pp_src[0];
+    const char* p = src;
+    const char* p_lit = src;
+    const char* p_name;
+    unsigned int len;
+    char quote = 0;
+    int index;
+
+    for (; *p != '\0'; p++)
+    {
+        if (!p_tmpl->args && ((*p == '\'') || (*p == '"')))
+        {
+            /* 双引号内替换，单引号内不替换 */
+            quote = (quote == 0) ? *p : ((quote == *p) ? 0 : quote);
+            continue;
+        }
+        if ((quote == '\'') || (*p != '$'))
+        {
+            continue;
+        }
+
+        if (p[1] == '$')
+        {
+            /* 保留第一个'$'，跳过第二个 */
+            if (gm_cli_tmpl_add(p_tmpl, (unsigned int)(p_lit - p_base), (unsigned int)(p - p_lit) + 1) != 0)
+            {
+                return -1;
+            }
+            p++;
+            p_lit = p + 1;
+            continue;
+        }
+        p_name = (p[1] == '{') ? &p[2] : &p[1];
+        len = gm_cli_var_name_len(p_name);
+        if ((p_name == &p[2]) && ((len == 0) || (p_name[len] != '}')))
+        {
+            gm_cli_put_str("Invalid variable reference! Usage: $name or ${name}\r\n");
+            return -1;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+        index = gm_cli_var_find(p_name, len);
+        if (index < 0)
+        {
+            gm_cli_put_str("Undefined variable \"");
+            gm_cli_put_buf(p_name, len);
+            gm_cli_put_str("\"!\r\n");
+            return -1;
+        }
+        if ((gm_cli_tmpl_add(p_tmpl, (unsigned int)(p_lit - p_base), (unsigned int)(p - p_lit)) != 0) ||
+            (gm_cli_tmpl_add(p_tmpl, (unsigned int)index, GM_CLI_TMPL_VAR) != 0))
+        {
+            return -1;
+        }
+        p = &p_name[len] + (p_name == &p[2]);
+        p_lit = p;
+        p--;
+    }
+    return gm_cli_tmpl_add(p_tmpl, (unsigned int)(p_lit - p_base),
+                           (unsigned int)(p - p_lit) + (p_tmpl->args ? 1 : 0));
+}
+
+/* 编译模板，args为0时src为一行命令，为1时为分割好的参数，$$为'$'，'$'后不是变量名时
+ * 原样保留，源串在模板使用期间不能修改，返回：0 - 成功，-1 - 变量不存在或格式错误 */
+static int gm_cli_tmpl_compile(gm_cli_tmpl_t* const p_tmpl, char* src[], const unsigned int num,
+                               const unsigned int args)
+{
+    unsigned int i;
+
+    p_tmpl->pp_src = src;
+    p_tmpl->src_num = num;
+    p_tmpl->args = args;
+    p_tmpl->gen = gm_cli_mgr.var_gen;
+    p_tmpl->seg_num = 0;
+    for (i = 0; i < num; i++)
+    {
+        if (gm_cli_tmpl_scan(p_tmpl, src[i]) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#if GM_CLI_LOOP_EN
+/* 模板是否引用了变量 */
+static int gm_cli_tmpl_has_var(const gm_cli_tmpl_t* const p_tmpl)
+{
+    unsigned int i;
+
+    for (i = 0; i < p_tmpl->seg_num; i++)
+    {
+        if (p_tmpl->seg[i].len == GM_CLI_TMPL_VAR)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif  /* GM_CLI_LOOP_EN */
+
+/* 展开模板，删除过变量时先重新编译，size为行长度限制，按参数编译时argv输出各参数，
+ * 返回：展开后的长度，-1 - 失败或超出行长度 */
+static int gm_cli_tmpl_expand(gm_cli_tmpl_t* const p_tmpl, char* const buf, const unsigned int size,
+                              char* argv[])
+{
+    const gm_cli_tmpl_seg_t* p_seg;
+    const gm_cli_var_t* p_var;
+    unsigned int len = 0, n, i;
+
+    if ((p_tmpl->gen != gm_cli_mgr.var_gen) &&
+        (gm_cli_tmpl_compile(p_tmpl, p_tmpl->pp_src, p_tmpl->src_num, p_tmpl->args) != 0))
+    {
+        return -1;
+    }
+    for (i = 0; i < p_tmpl->seg_num; i++)
+    {
+        p_seg = &p_tmpl->seg[i];
+        if (p_seg->len == GM_CLI_TMPL_VAR)
+        {
+            p_var = &gm_cli_var[p_seg->pos];
+            if (len + p_var->len >= size)
+            {
+                break;
+            }
+            memcpy(&buf[len], p_var->value, p_var->len);
+            len += p_var->len;
+        }
+        else
+        {
+            if (len + p_seg->len >= size)
+            {
+                break;
+            }
+            memcpy(&buf[len], &p_tmpl->pp_src[0][p_seg->pos], p_seg->len);
+            len += p_seg->len;
+        }
+    }
+    if (i < p_tmpl->seg_num)
+    {
+        gm_cli_put_str("Line too long after variable expansion!\r\n");
+        return -1;
+    }
+    buf[len] = '\0';
+
+    if (p_tmpl->args)
+    {
+        /* 每个参数都以'\0'结束 */
+        for (n = 0, i = 0; n < p_tmpl->src_num; n++)
+        {
+            argv[n] = &buf[i];
+            i += (unsigned int)strlen(&buf[i]) + 1;
+        }
+    }
+    return (int)len;
+}
+
+/* 命令是否自己替换变量，只查找第一个词 */
+static int gm_cli_var_raw_cmd(char* const line)
+{
+    const gm_cli_cmd_t* p_cmd;
+    char* p_name = line + strspn(line, " \t");
+    unsigned int len = (unsigned int)strcspn(p_name, " \t");
+    char save = p_name[len];
+
+    p_name[len] = '\0';
+    p_cmd = gm_cli_search_cmd(p_name);
+    p_name[len] = save;
+    if ((p_cmd != NULL) && (p_cmd->link != NULL))
+    {
+        p_cmd = p_cmd->link;
+    }
+    return (p_cmd != NULL) && (p_cmd->flags & GM_CLI_CMD_FLAG_RAW);
+}
+
+/* 分割参数会去掉引号，单引号内的'$'先写成"$$"，按参数替换时还原为'$'，不需要改写时
+ * 直接返回原行，改写后的行放在buf中，返回：替换前的行，NULL - 超出行长度 */
+static char* gm_cli_var_quote(char* line, char* const buf, const unsigned int size)
+{
+    unsigned int len = 0;
+    char quote = '\0';
+    char* p;
+
+    for (p = line; *p != '\0'; p++)
+    {
+        if ((quote == '\0') && ((*p == '\'') || (*p == '"')))
+        {
+            quote = *p;
+        }
+        else if (*p == quote)
+        {
+            quote = '\0';
+        }
+        else if ((quote == '\'') && (*p == '$'))
+        {
+            break;
+        }
+    }
+    if (*p == '\0')
+    {
+        return line;
+    }
+
+    quote = '\0';
+    for (p = line; *p != '\0'; p++)
+    {
+        if (len + 2 >= size)
+        {
+            gm_cli_put_str("Line too long after variable expansion!\r\n");
+            return NULL;
+        }
+        if ((quote == '\0') && ((*p == '\'') || (*p == '"')))
+        {
+            quote = *p;
+        }
+        else if (*p == quote)
+        {
+            quote = '\0';
+        }
+        else if ((quote == '\'') && (*p == '$'))
+        {
+            buf[len++] = '$';
+        }
+        buf[len++] = *p;
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+/* 替换分割好的参数中的变量，变量值只作为参数内容，不会形成引号、管道或重定向，替换后
+ * 的参数依次放在buf中*p_pos开始的位置，buf长度为行长度，返回：0 - 成功，-1 - 失败 */
+static int gm_cli_var_subst_args(const int argc, char* argv[], char* const buf,
+                                 unsigned int* const p_pos)
+{
+    gm_cli_tmpl_t tmpl;
+    int i, len;
+
+    i = 0;
+    while ((i < argc) && (strchr(argv[i], '$') == NULL))
+    {
+        i++;
+    }
+    if (i == argc)
+    {
+        return 0;
+    }
+    /* 展开后不再使用模板，argv可以同时作为源串和输出 */
+    if (gm_cli_tmpl_compile(&tmpl, argv, (unsigned int)argc, 1) != 0)
+    {
+        return -1;
+    }
+    len = gm_cli_tmpl_expand(&tmpl, &buf[*p_pos], GM_CLI_LINE_CHAR_MAX - *p_pos, argv);
+    if (len < 0)
+    {
+        return -1;
+    }
+    *p_pos += (unsigned int)len + 1;
+    return 0;
+}
+#endif  /* GM_CLI_VAR_EN */
+
+/* 执行一行命令，行内容会被修改，返回：0 - 已执行，-1 - 未执行 */
+static int gm_cli_exec_line(char* line, int* const p_ret)
+{
+    int argc;
+    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
+    const gm_cli_cmd_t* p_cmd;
+#if GM_CLI_VAR_EN
+    char quoted[GM_CLI_LINE_CHAR_MAX];
+    char expand[GM_CLI_LINE_CHAR_MAX];
+#endif  /* GM_CLI_VAR_EN */
+#if GM_CLI_VAR_EN || GM_CLI_PIPE_EN
+    char* p_subst = NULL;
+    unsigned int subst_pos = 0;
+#endif  /* GM_CLI_VAR_EN || GM_CLI_PIPE_EN */
+#if GM_CLI_REDIRECT_SUPPORT
+    char* p_path = NULL;
+    int redirect;
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+#if GM_CLI_PIPE_EN
+    char* p_stage_str[GM_CLI_PIPE_STAGE_MAX];
+    unsigned int stage_num = 1;
+    char* p;
+#endif  /* GM_CLI_PIPE_EN */
+
+#if GM_CLI_VAR_EN
+    /* 变量在分割管道和参数之后按参数替换，替换后的参数放在expand中，总长度不能超过
+     * 行长度，命令自己替换变量时不替换 */
+    if ((strchr(line, '$') != NULL) && !gm_cli_var_raw_cmd(line))
+    {
+        line = gm_cli_var_quote(line, quoted, sizeof(quoted));
+        if (line == NULL)
+        {
+            return -1;
+        }
+        p_subst = expand;
+    }
+#endif  /* GM_CLI_VAR_EN */
+
+#if GM_CLI_REDIRECT_SUPPORT
+    /* 重定向作用于整条命令行，先从行中截掉 */
+    redirect = gm_cli_redirect_parse(line, &p_path);
+    if (redirect < 0)
+    {
+        gm_cli_put_str("Invalid redirection! Usage: cmd > file or cmd >> file\r\n");
+        return -1;
+    }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+
+#if GM_CLI_PIPE_EN
+    /* 按引号外的'|'分割管道各级 */
+    for (p = gm_cli_str_find_unquoted(line, '|'); p != NULL;
+         p = gm_cli_str_find_unquoted(p + 1, '|'))
+    {
+        if (stage_num >= GM_CLI_PIPE_STAGE_MAX)
+        {
+            gm_cli_put_str("Too many pipe stages!\r\n");
+            return -1;
+        }
+        *p = '\0';
+        p_stage_str[stage_num++] = p + 1;
+    }
+#endif  /* GM_CLI_PIPE_EN */
+
+    argc = gm_cli_split_args(line, argv);
+    if (argc == 0)
+    {
+#if GM_CLI_PIPE_EN
+        if (stage_num > 1)
+        {
+            gm_cli_put_str("Empty pipe stage!\r\n");
+            return -1;
+        }
+#endif  /* GM_CLI_PIPE_EN */
+        *p_ret = 0;
+        return 0;
+    }
+#if GM_CLI_VAR_EN
+    if ((p_subst != NULL) && (gm_cli_var_subst_args(argc, argv, p_subst, &subst_pos) != 0))
+    {
+        return -1;
+    }
+#if GM_CLI_REDIRECT_SUPPORT
+    /* 重定向的文件名也替换变量 */
+    if ((p_subst != NULL) && (redirect > 0) &&
+        (gm_cli_var_subst_args(1, &p_path, p_subst, &subst_pos) != 0))
+    {
+        return -1;
+    }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+#endif  /* GM_CLI_VAR_EN */
+
+    p_cmd = gm_cli_search_cmd(argv[0]);
+    if (p_cmd == NULL)
+    {
+        gm_cli_put_not_found(argv[0]);
+        return -1;
+    }
+    if (p_cmd->link != NULL)
+    {
+        p_cmd = p_cmd->link;
+    }
+
+#if GM_CLI_REDIRECT_SUPPORT
+    if ((redirect > 0) && (gm_cli_redirect_open(p_path, redirect == 2) != 0))
+    {
+        return -1;
+    }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+
+#if GM_CLI_PIPE_EN
+    if ((stage_num > 1) &&
+        (gm_cli_pipe_open(&p_stage_str[1], stage_num - 1, p_subst, &subst_pos) != 0))
+    {
+#if GM_CLI_REDIRECT_SUPPORT
+        if (redirect > 0)
+        {
+            gm_cli_redirect_close();
+        }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+        return -1;
+    }
+#endif  /* GM_CLI_PIPE_EN */
+
+    /* 错误提示都已输出到终端，挂接输出通道 */
+#if GM_CLI_REDIRECT_SUPPORT
+    if (redirect > 0)
+    {
+        gm_cli_redirect_attach();
+    }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+#if GM_CLI_PIPE_EN
+    if (stage_num > 1)
+    {
+        gm_cli_pipe_attach(stage_num - 1);
+    }
+#endif  /* GM_CLI_PIPE_EN */
+
+#if GM_CLI_ALIAS_EN
+    if (p_cmd->flags & GM_CLI_CMD_FLAG_MACRO)
+    {
+        *p_ret = gm_cli_alias_run(p_cmd, argc, argv);
+    }
+    else
+#endif  /* GM_CLI_ALIAS_EN */
+    {
+        *p_ret = gm_cli_run_cmd(p_cmd, argc, argv);
+    }
+
+#if GM_CLI_PIPE_EN
+    if (stage_num > 1)
+    {
+        gm_cli_pipe_close(stage_num - 1);
+    }
+#endif  /* GM_CLI_PIPE_EN */
+
+#if GM_CLI_REDIRECT_SUPPORT
+    if (redirect > 0)
+    {
+        gm_cli_redirect_close();
+    }
+#endif  /* GM_CLI_REDIRECT_SUPPORT */
+
+    return 0;
+}
+
+#if GM_CLI_MEM_EN
+/* 一个字节的两个十六进制字符，按字节值查表 */
+#define GM_CLI_HEX_ROW(h)   h "0" h "1" h "2" h "3" h "4" h "5" h "6" h "7" \
+                            h "8" h "9" h "a" h "b" h "c" h "d" h "e" h "f"
+static const char gm_cli_hex_pair[] =
+    GM_CLI_HEX_ROW("0") GM_CLI_HEX_ROW("1") GM_CLI_HEX_ROW("2") GM_CLI_HEX_ROW("3")
+    GM_CLI_HEX_ROW("4") GM_CLI_HEX_ROW("5") GM_CLI_HEX_ROW("6") GM_CLI_HEX_ROW("7")
+    GM_CLI_HEX_ROW("8") GM_CLI_HEX_ROW("9") GM_CLI_HEX_ROW("a") GM_CLI_HEX_ROW("b")
+    GM_CLI_HEX_ROW("c") GM_CLI_HEX_ROW("d") GM_CLI_HEX_ROW("e") GM_CLI_HEX_ROW("f");
+
+/* md一行的最大长度：地址和冒号，16个字节的十六进制和空格，两个空格和ASCII列，回车换行 */
+#define GM_CLI_MEM_ROW_MAX  (sizeof(void*) * 2 + 1 + 16 * 3 + 2 + 16 + 2)
+
+/* 按字节查表输出bytes个字节的十六进制，高字节在前，返回字符数 */
+static unsigned int gm_cli_mem_hex(char* const buf, const uintptr_t val, unsigned int bytes)
+{
+    const char* p_hex;
+    unsigned int pos = 0;
+
+    while (bytes-- > 0)
+    {
+        p_hex = &gm_cli_hex_pair[((val >> (bytes * 8)) & 0xFF) * 2];
+        buf[pos++] = p_hex[0];
+        buf[pos++] = p_hex[1];
+    }
+    return pos;
+}
+
+/* 按宽度读取一个单元，p_byte不为NULL时按内存中的顺序保存读到的字节 */
+static uint32_t gm_cli_mem_load(const uintptr_t addr, const unsigned int width,
+                                unsigned char* const p_byte)
+{
+    uint32_t val;
+    uint16_t half;
+
+    if (width == 1)
+    {
+        val = *(const volatile uint8_t*)addr;
+        if (p_byte != NULL)
+        {
+            p_byte[0] = (unsigned char)val;
+        }
+    }
+    else if (width == 2)
+    {
+        half = *(const volatile uint16_t*)addr;
+        if (p_byte != NULL)
+        {
+            memcpy(p_byte, &half, 2);
+        }
+        val = half;
+    }
+    else
+    {
+        val = *(const volatile uint32_t*)addr;
+        if (p_byte != NULL)
+        {
+            memcpy(p_byte, &val, 4);
+        }
+    }
+    return val;
+}
+
+/* 按宽度写入一个单元 */
+static void gm_cli_mem_store(const uintptr_t addr, const unsigned int width, const uint32_t val)
+{
+    if (width == 1)
+    {
+        *(volatile uint8_t*)addr = (uint8_t)val;
+    }
+    else if (width == 2)
+    {
+        *(volatile uint16_t*)addr = (uint16_t)val;
+    }
+    else
+    {
+        *(volatile uint32_t*)addr = val;
+    }
+}
+
+/* 格式化一行，最多16个字节，每个单元只读取一次，返回行长度 */
+static unsigned int gm_cli_mem_format_row(char* const buf, const uintptr_t addr,
+                                          const unsigned int len, const unsigned int width)
+{
+    unsigned char data[16];
+    unsigned int i, pos;
+
+    pos = gm_cli_mem_hex(buf, addr, sizeof(void*));
+    buf[pos++] = ':';
+    for (i = 0; i < 16; i += width)
+    {
+        buf[pos++] = ' ';
+        if (i < len)
+        {
+            pos += gm_cli_mem_hex(&buf[pos], gm_cli_mem_load(addr + i, width, &data[i]), width);
+        }
+        else
+        {
+            /* 最后一行不满时补空格，ASCII列对齐 */
+            memset(&buf[pos], ' ', width * 2);
+            pos += width * 2;
+        }
+    }
+    buf[pos++] = ' ';
+    buf[pos++] = ' ';
+    for (i = 0; i < len; i++)
+    {
+        buf[pos++] = ((data[i] >= 0x20) && (data[i] < 0x7F)) ? (char)data[i] : '.';
+    }
+    buf[pos++] = '\r';
+    buf[pos++] = '\n';
+    return pos;
+}
+
+/* 输出最多GM_CLI_MEM_CHUNK_ROWS行，每行一次写入输出通道，更新地址和剩余长度 */
+static void gm_cli_mem_dump_chunk(uintptr_t* const p_addr, uintptr_t* const p_left,
+                                  const unsigned int width)
+{
+    char row[GM_CLI_MEM_ROW_MAX];
+    unsigned int rows, len;
+
+    for (rows = 0; (rows < GM_CLI_MEM_CHUNK_ROWS) && (*p_left > 0); rows++)
+    {
+        len = (*p_left < 16) ? (unsigned int)*p_left : 16;
+        gm_cli_put_buf(row, gm_cli_mem_format_row(row, *p_addr, len, width));
+        *p_addr += len;
+        *p_left -= len;
+    }
+}
+
+#if GM_CLI_OUT_SCHED_EN
+/* 继续输出md剩余的一块，直接写入终端的批量输出 */
+static void gm_cli_mem_resume(void)
+{
+    gm_cli_sink_t* p_sink = gm_cli_mgr.p_sink;
+    unsigned int out_class = gm_cli_mgr.out_class;
+
+    gm_cli_mgr.p_sink = &gm_cli_mgr.term_sink;
+    gm_cli_mgr.out_class = GM_CLI_OUT_BULK;
+    gm_cli_mem_dump_chunk(&gm_cli_mgr.mem_addr, &gm_cli_mgr.mem_left, gm_cli_mgr.mem_width);
+    gm_cli_mgr.p_sink = p_sink;
+    gm_cli_mgr.out_class = out_class;
+    if (gm_cli_mgr.mem_left == 0)
+    {
+        gm_cli_mgr.mem_width = 0;
+    }
+}
+
+/* 输出md剩余的全部行，新的命令输出到终端前调用，保持终端输出的顺序 */
+static void gm_cli_mem_flush(void)
+{
+    while (gm_cli_mgr.mem_width != 0)
+    {
+        gm_cli_mem_resume();
+    }
+}
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#endif  /* GM_CLI_MEM_EN */
+
+/* 非交互执行一行命令 */
+int gm_cli_exec(char* const line, int* const p_ret)
+{
+    int ret = 0;
+    int result;
+#if GM_CLI_OUT_SCHED_EN
+    unsigned int out_class = gm_cli_mgr.out_class;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+    if (line == NULL)
+    {
+        return -1;
+    }
+#if GM_CLI_MEM_EN && GM_CLI_OUT_SCHED_EN
+    if (gm_cli_mgr.p_sink == &gm_cli_mgr.term_sink)
+    {
+        gm_cli_mem_flush();
+    }
+#endif  /* GM_CLI_MEM_EN && GM_CLI_OUT_SCHED_EN */
+    /* 查找到执行结束期间插件不会被卸载 */
+    GM_CLI_RCU_READ_LOCK();
+#if GM_CLI_OUT_SCHED_EN
+    gm_cli_mgr.out_class = GM_CLI_OUT_BULK;
+    result = gm_cli_exec_line(line, &ret);
+    gm_cli_mgr.out_class = out_class;
+#else
+    result = gm_cli_exec_line(line, &ret);
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    GM_CLI_RCU_READ_UNLOCK();
+    if (result != 0)
+    {
+        return -1;
+    }
+    if (p_ret != NULL)
+    {
+        *p_ret = ret;
+    }
+    return 0;
+}
+
+#if GM_CLI_BATCH_EN
+/* 批量执行的共享状态，任务按序号放在环形窗口中，序号小于take的已被工作线程取走 */
+static struct
+{
+    pthread_mutex_t    lock;
+    pthread_cond_t     cond_work;                        /* 有新任务或需要退出 */
+    pthread_cond_t     cond_done;                        /* 有任务执行完成 */
+    unsigned int       head;                             /* 下一个放入的任务序号 */
+    unsigned int       take;                             /* 下一个取走执行的任务序号 */
+    unsigned int       quit;                             /* 工作线程退出 */
+    gm_cli_batch_job_t job[GM_CLI_BATCH_WINDOW];
+} gm_cli_batch_ctx;
+
+/* 任务输出捕获通道写入，超出缓存的部分丢弃 */
+static void gm_cli_batch_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    gm_cli_batch_job_t* p_job = (gm_cli_batch_job_t*)p_sink;
+
+    if (len > GM_CLI_BATCH_OUT_MAX - p_job->out_len)
+    {
+        len = GM_CLI_BATCH_OUT_MAX - p_job->out_len;
+        p_job->out_trunc = 1;
+    }
+    memcpy(&p_job->out[p_job->out_len], buf, len);
+    p_job->out_len += len;
+}
+
+/* 在工作线程中执行任务的命令，和gm_cli_call_cmd一样计时和记录跟踪事件，预算和中止
+ * 状态属于任务，超过预算或被中止的提示写入任务的输出 */
+static int gm_cli_batch_call_cmd(gm_cli_batch_job_t* const p_job)
+{
+    const gm_cli_cmd_t* p_cmd = p_job->p_cmd;
+    int ret;
+#if GM_CLI_BUDGET_EN
+    unsigned long elapsed = 0;
+    unsigned int abort_reason;
+
+    p_job->run_start = 0;
+    p_job->run_budget = 0;
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        p_job->run_start = gm_cli_mgr.pf_tick();
+        p_job->run_budget = (p_cmd->budget_ms > 0) ? p_cmd->budget_ms : GM_CLI_CMD_BUDGET_MS;
+    }
+    gm_cli_atomic_store(&p_job->run_abort, GM_CLI_ABORT_NONE);
+#endif  /* GM_CLI_BUDGET_EN */
+
+    gm_cli_batch_job = p_job;
+    GM_CLI_RCU_READ_LOCK();
+    GM_CLI_TRACE(GM_CLI_TRACE_CMD | GM_CLI_TRACE_BEGIN, p_job->argc);
+    ret = p_cmd->cb(p_job->argc, p_job->argv);
+    GM_CLI_TRACE(GM_CLI_TRACE_CMD | GM_CLI_TRACE_END, ret);
+    GM_CLI_RCU_READ_UNLOCK();
+
+#if GM_CLI_BUDGET_EN
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        elapsed = gm_cli_mgr.pf_tick() - p_job->run_start;
+    }
+    abort_reason = gm_cli_atomic_xchg(&p_job->run_abort, GM_CLI_ABORT_NONE);
+    /* 统计是共享的，提示写入本任务的输出 */
+    pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+    gm_cli_budget_report(p_cmd, elapsed, p_job->run_budget, abort_reason);
+    pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+#endif  /* GM_CLI_BUDGET_EN */
+    gm_cli_batch_job = NULL;
+    return ret;
+}
+
+/* 工作线程，依次取出任务执行 */
+static void* gm_cli_batch_worker(void* arg)
+{
+    gm_cli_batch_job_t* p_job;
+
+    (void)arg;
+    pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+    for (;;)
+    {
+        while (!gm_cli_batch_ctx.quit && (gm_cli_batch_ctx.take == gm_cli_batch_ctx.head))
+        {
+            pthread_cond_wait(&gm_cli_batch_ctx.cond_work, &gm_cli_batch_ctx.lock);
+        }
+        if (gm_cli_batch_ctx.take == gm_cli_batch_ctx.head)
+        {
+            break;
+        }
+        p_job = &gm_cli_batch_ctx.job[gm_cli_batch_ctx.take++ % GM_CLI_BATCH_WINDOW];
+        p_job->state = GM_CLI_BATCH_RUNNING;
+        pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+
+        p_job->ret = gm_cli_batch_call_cmd(p_job);
+
+        pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+        p_job->state = GM_CLI_BATCH_DONE;
+        pthread_cond_broadcast(&gm_cli_batch_ctx.cond_done);
+    }
+    pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+    return NULL;
+}
+
+/* 按顺序输出最早的任务，wait为0时任务未完成直接返回，返回：1 - 已输出，
+ * 0 - 任务未完成，-1 - 命令返回值不为0 */
+static int gm_cli_batch_emit(const unsigned int seq, const int wait)
+{
+    gm_cli_batch_job_t* p_job = &gm_cli_batch_ctx.job[seq % GM_CLI_BATCH_WINDOW];
+
+    pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+    while (wait && (p_job->state != GM_CLI_BATCH_DONE))
+    {
+        pthread_cond_wait(&gm_cli_batch_ctx.cond_done, &gm_cli_batch_ctx.lock);
+    }
+    if (p_job->state != GM_CLI_BATCH_DONE)
+    {
+        pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+        return 0;
+    }
+    pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+
+    gm_cli_put_buf(p_job->out, p_job->out_len);
+    if (p_job->out_trunc)
+    {
+        gm_cli_put_str("... [output truncated]\r\n");
+    }
+    return (p_job->ret == 0) ? 1 : -1;
+}
+
+/* 取出下一行，去掉行尾回车，返回行首，没有更多行时返回NULL */
+static char* gm_cli_batch_next_line(char** const pp_str)
+{
+    char* p_line = *pp_str;
+    char* p;
+
+    if (p_line == NULL)
+    {
+        return NULL;
+    }
+    p = strchr(p_line, '\n');
+    if (p != NULL)
+    {
+        *p = '\0';
+        *pp_str = p + 1;
+    }
+    else
+    {
+        *pp_str = NULL;
+    }
+    p = p_line + strlen(p_line);
+    while ((p > p_line) && (p[-1] == '\r'))
+    {
+        *--p = '\0';
+    }
+    return p_line;
+}
+
+/* 判断一行是否可以并行执行，返回可重入命令，否则返回NULL */
+static const gm_cli_cmd_t* gm_cli_batch_reentrant(char* const line)
+{
+    const gm_cli_cmd_t* p_cmd;
+    char* p_name = line + strspn(line, " \t");
+    unsigned int len = (unsigned int)strcspn(p_name, " \t");
+    char save = p_name[len];
+
+    /* 管道和重定向改变全局输出通道，变量替换使用全局变量表，都按屏障处理，
+     * 引号中的'|'和'>'是参数内容 */
+    if ((gm_cli_str_find_unquoted(line, '|') != NULL) ||
+        (gm_cli_str_find_unquoted(line, '>') != NULL) ||
+        (strchr(line, '$') != NULL))
+    {
+        return NULL;
+    }
+    p_name[len] = '\0';
+    p_cmd = gm_cli_search_cmd(p_name);
+    p_name[len] = save;
+    if ((p_cmd != NULL) && (p_cmd->link != NULL))
+    {
+        p_cmd = p_cmd->link;
+    }
+    /* 结构化输出使用全局状态，按屏障处理 */
+    if ((p_cmd == NULL) || (p_cmd->cb == NULL) ||
+        (p_cmd->flags & (GM_CLI_CMD_FLAG_MACRO | GM_CLI_CMD_FLAG_EMIT)) ||
+        !(p_cmd->flags & GM_CLI_CMD_FLAG_REENTRANT))
+    {
+        return NULL;
+    }
+    return p_cmd;
+}
+
+/* 批量执行脚本 */
+int gm_cli_batch(char* const script, unsigned int threads, unsigned int* const p_line)
+{
+    pthread_t thread[GM_CLI_BATCH_THREAD_MAX];
+    unsigned int thread_num = 0;
+    unsigned int emit = 0;
+    unsigned int line_no = 0;
+    unsigned int fail_line = 0;
+    const gm_cli_cmd_t* p_cmd;
+    gm_cli_batch_job_t* p_job;
+    char* p_str = script;
+    char* p_line_str;
+    int cmd_ret;
+    int result;
+    unsigned int i;
+
+    if (script == NULL)
+    {
+        return -1;
+    }
+    if (threads > GM_CLI_BATCH_THREAD_MAX)
+    {
+        threads = GM_CLI_BATCH_THREAD_MAX;
+    }
+
+    gm_cli_batch_ctx.head = 0;
+    gm_cli_batch_ctx.take = 0;
+    gm_cli_batch_ctx.quit = 0;
+    pthread_mutex_init(&gm_cli_batch_ctx.lock, NULL);
+    pthread_cond_init(&gm_cli_batch_ctx.cond_work, NULL);
+    pthread_cond_init(&gm_cli_batch_ctx.cond_done, NULL);
+    if (threads > 1)
+    {
+        for (; thread_num < threads; thread_num++)
+        {
+            if (pthread_create(&thread[thread_num], NULL, gm_cli_batch_worker, NULL) != 0)
+            {
+                break;
+            }
+        }
+    }
+#if GM_CLI_BUDGET_EN
+    gm_cli_atomic_store(&gm_cli_batch_abort, 0);
+    gm_cli_atomic_store(&gm_cli_batch_active, thread_num > 0);
+#endif  /* GM_CLI_BUDGET_EN */
+
+    while ((fail_line == 0) && ((p_line_str = gm_cli_batch_next_line(&p_str)) != NULL))
+    {
+        line_no++;
+        p_line_str += strspn(p_line_str, " \t");
+        if ((*p_line_str == '\0') || (*p_line_str == '#'))
+        {
+            continue;
+        }
+#if GM_CLI_BUDGET_EN
+        /* 请求中止后不再执行新的命令 */
+        if (gm_cli_atomic_load(&gm_cli_batch_abort))
+        {
+            fail_line = line_no;
+            break;
+        }
+#endif  /* GM_CLI_BUDGET_EN */
+
+        p_cmd = (thread_num > 0) ? gm_cli_batch_reentrant(p_line_str) : NULL;
+        if (p_cmd != NULL)
+        {
+            /* 窗口满时等待最早的任务完成并输出 */
+            if (gm_cli_batch_ctx.head - emit == GM_CLI_BATCH_WINDOW)
+            {
+                if (gm_cli_batch_emit(emit, 1) < 0)
+                {
+                    fail_line = gm_cli_batch_ctx.job[emit % GM_CLI_BATCH_WINDOW].line;
+                    break;
+                }
+                emit++;
+            }
+            p_job = &gm_cli_batch_ctx.job[gm_cli_batch_ctx.head % GM_CLI_BATCH_WINDOW];
+            p_job->sink.write = gm_cli_batch_sink_write;
+            p_job->sink.next = NULL;
+            p_job->p_cmd = p_cmd;
+            p_job->argc = gm_cli_split_args(p_line_str, p_job->argv);
+            p_job->ret = 0;
+            p_job->state = GM_CLI_BATCH_READY;
+            p_job->line = line_no;
+            p_job->out_len = 0;
+            p_job->out_trunc = 0;
+            pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+            gm_cli_batch_ctx.head++;
+            pthread_cond_signal(&gm_cli_batch_ctx.cond_work);
+            pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+
+            /* 已完成的任务及时输出 */
+            while ((emit != gm_cli_batch_ctx.head) && ((result = gm_cli_batch_emit(emit, 0)) != 0))
+            {
+                if (result < 0)
+                {
+                    fail_line = gm_cli_batch_ctx.job[emit % GM_CLI_BATCH_WINDOW].line;
+                    break;
+                }
+                emit++;
+            }
+            continue;
+        }
+
+        /* 屏障，之前的任务全部输出后在当前线程执行 */
+        for (; emit != gm_cli_batch_ctx.head; emit++)
+        {
+            if (gm_cli_batch_emit(emit, 1) < 0)
+            {
+                fail_line = gm_cli_batch_ctx.job[emit % GM_CLI_BATCH_WINDOW].line;
+                break;
+            }
+        }
+        if (fail_line != 0)
+        {
+            break;
+        }
+        if ((gm_cli_exec(p_line_str, &cmd_ret) != 0) || (cmd_ret != 0))
+        {
+            fail_line = line_no;
+        }
+    }
+
+    for (; (fail_line == 0) && (emit != gm_cli_batch_ctx.head); emit++)
+    {
+        if (gm_cli_batch_emit(emit, 1) < 0)
+        {
+            fail_line = gm_cli_batch_ctx.job[emit % GM_CLI_BATCH_WINDOW].line;
+        }
+    }
+
+    /* 失败时丢弃未开始的任务，已开始的任务执行完后线程退出 */
+    pthread_mutex_lock(&gm_cli_batch_ctx.lock);
+    gm_cli_batch_ctx.head = gm_cli_batch_ctx.take;
+    gm_cli_batch_ctx.quit = 1;
+    pthread_cond_broadcast(&gm_cli_batch_ctx.cond_work);
+    pthread_mutex_unlock(&gm_cli_batch_ctx.lock);
+    for (i = 0; i < thread_num; i++)
+    {
+        pthread_join(thread[i], NULL);
+    }
+#if GM_CLI_BUDGET_EN
+    gm_cli_atomic_store(&gm_cli_batch_active, 0);
+#endif  /* GM_CLI_BUDGET_EN */
+    pthread_cond_destroy(&gm_cli_batch_ctx.cond_done);
+    pthread_cond_destroy(&gm_cli_batch_ctx.cond_work);
+    pthread_mutex_destroy(&gm_cli_batch_ctx.lock);
+
+    if (fail_line != 0)
+    {
+        if (p_line != NULL)
+        {
+            *p_line = fail_line;
+        }
+        return -1;
+    }
+    return 0;
+}
+#endif  /* GM_CLI_BATCH_EN */
+
+#if GM_CLI_SHM_EN
+/* 共享内存控制通道 */
+static struct
+{
+    gm_cli_shm_hdr_t*      p_hdr;                        /* 共享内存，NULL为未打开 */
+    gm_cli_sink_t          sink;                         /* 应答输出通道 */
+    char*                  p_out;                        /* 应答输出位置，在应答缓存中 */
+    unsigned int           out_len;                      /* 应答输出长度 */
+    unsigned int           out_trunc;                    /* 应答输出是否被截断 */
+    char                   name[64];                     /* 共享内存名称 */
+} gm_cli_shm_ctx;
+
+/* 应答输出通道写入，直接写入应答缓存，超出部分丢弃 */
+static void gm_cli_shm_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    (void)p_sink;
+    if (len > GM_CLI_SHM_OUT_MAX - gm_cli_shm_ctx.out_len)
+    {
+        len = GM_CLI_SHM_OUT_MAX - gm_cli_shm_ctx.out_len;
+        gm_cli_shm_ctx.out_trunc = 1;
+    }
+    memcpy(&gm_cli_shm_ctx.p_out[gm_cli_shm_ctx.out_len], buf, len);
+    gm_cli_shm_ctx.out_len += len;
+}
+
+/* 创建共享内存控制通道 */
+int gm_cli_shm_open(const char* const name)
+{
+    gm_cli_shm_hdr_t* p_hdr;
+    int fd;
+
+    if ((name == NULL) || (strlen(name) >= sizeof(gm_cli_shm_ctx.name)))
+    {
+        return -1;
+    }
+    gm_cli_shm_close();
+    fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)GM_CLI_SHM_MAP_SIZE(GM_CLI_SHM_SIZE)) != 0)
+    {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+    p_hdr = (gm_cli_shm_hdr_t*)mmap(NULL, GM_CLI_SHM_MAP_SIZE(GM_CLI_SHM_SIZE),
+                                    PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p_hdr == (gm_cli_shm_hdr_t*)MAP_FAILED)
+    {
+        shm_unlink(name);
+        return -1;
+    }
+
+    /* 新建的共享内存全为0，填写头部后客户端才能连接 */
+    p_hdr->size = GM_CLI_SHM_SIZE;
+    p_hdr->out_max = GM_CLI_SHM_OUT_MAX;
+    p_hdr->server = (uint32_t)getpid();
+    p_hdr->version = GM_CLI_SHM_VERSION;
+    __atomic_store_n(&p_hdr->magic, GM_CLI_SHM_MAGIC, __ATOMIC_RELEASE);
+    gm_cli_shm_ctx.sink.write = gm_cli_shm_sink_write;
+    strcpy(gm_cli_shm_ctx.name, name);
+    gm_cli_shm_ctx.p_hdr = p_hdr;
+    return 0;
+}
+
+/* 关闭并删除共享内存控制通道 */
+void gm_cli_shm_close(void)
+{
+    if (gm_cli_shm_ctx.p_hdr == NULL)
+    {
+        return;
+    }
+    munmap(gm_cli_shm_ctx.p_hdr, GM_CLI_SHM_MAP_SIZE(GM_CLI_SHM_SIZE));
+    shm_unlink(gm_cli_shm_ctx.name);
+    gm_cli_shm_ctx.p_hdr = NULL;
+}
+
+/* 是否有请求并且应答缓存能放下最长的应答 */
+static int gm_cli_shm_ready(gm_cli_shm_hdr_t* const p_hdr)
+{
+    return (__atomic_load_n(&p_hdr->req.head, __ATOMIC_ACQUIRE) != p_hdr->req.tail) &&
+           (gm_cli_shm_space(&p_hdr->rsp, GM_CLI_SHM_SIZE, GM_CLI_SHM_OUT_MAX) >= 0);
+}
+
+/* 执行共享内存通道中的请求 */
+int gm_cli_shm_poll(void)
+{
+    gm_cli_shm_hdr_t* p_hdr = gm_cli_shm_ctx.p_hdr;
+    unsigned char* p_req_data;
+    const gm_cli_shm_rec_t* p_req;
+    gm_cli_shm_rec_t* p_rsp;
+    char line[GM_CLI_LINE_CHAR_MAX];
+    unsigned int num, len;
+    int ret, bad;
+
+    if ((p_hdr == NULL) || !gm_cli_shm_ready(p_hdr))
+    {
+        return 0;
+    }
+    p_req_data = GM_CLI_SHM_REQ_DATA(p_hdr);
+    for (num = 0; num < GM_CLI_SHM_BURST; num++)
+    {
+        p_req = gm_cli_shm_peek(&p_hdr->req, p_req_data, GM_CLI_SHM_SIZE);
+        if (p_req == NULL)
+        {
+            break;
+        }
+        p_rsp = gm_cli_shm_reserve(&p_hdr->rsp, GM_CLI_SHM_RSP_DATA(p_hdr),
+                                   GM_CLI_SHM_SIZE, GM_CLI_SHM_OUT_MAX);
+        if (p_rsp == NULL)
+        {
+            /* 客户端没有及时取走应答 */
+            break;
+        }
+        p_rsp->seq = p_req->seq;
+        p_rsp->flags = 0;
+        ret = 0;
+        gm_cli_shm_ctx.p_out = (char*)(p_rsp + 1);
+        gm_cli_shm_ctx.out_len = 0;
+        gm_cli_shm_ctx.out_trunc = 0;
+        gm_cli_shm_ctx.sink.next = gm_cli_mgr.p_sink;
+        gm_cli_mgr.p_sink = &gm_cli_shm_ctx.sink;
+
+        /* 共享内存中的数据随时可能被客户端修改，长度只读一次，命令行复制后再执行 */
+        len = p_req->len;
+        bad = (len > GM_CLI_SHM_SIZE - (unsigned int)((const unsigned char*)p_req - p_req_data) -
+                     sizeof(gm_cli_shm_rec_t));
+        if (bad)
+        {
+            gm_cli_put_str("Bad request!\r\n");
+            p_rsp->flags = GM_CLI_SHM_FLAG_FAIL;
+        }
+        else if (len >= sizeof(line))
+        {
+            gm_cli_put_str("Line too long!\r\n");
+            p_rsp->flags = GM_CLI_SHM_FLAG_FAIL;
+        }
+        else
+        {
+            memcpy(line, p_req + 1, len);
+            line[len] = '\0';
+            if (gm_cli_exec(line, &ret) != 0)
+            {
+                p_rsp->flags = GM_CLI_SHM_FLAG_FAIL;
+            }
+        }
+
+        gm_cli_mgr.p_sink = gm_cli_shm_ctx.sink.next;
+        if (gm_cli_shm_ctx.out_trunc)
+        {
+            p_rsp->flags |= GM_CLI_SHM_FLAG_TRUNC;
+        }
+        p_rsp->ret = ret;
+        p_rsp->len = gm_cli_shm_ctx.out_len;
+        gm_cli_shm_commit(&p_hdr->rsp, GM_CLI_SHM_RSP_DATA(p_hdr), GM_CLI_SHM_SIZE, p_rsp);
+        /* 应答发布之后再释放请求，请求缓存为空时所有应答都已发布，记录损坏时丢弃全部请求 */
+        __atomic_store_n(&p_hdr->req.tail,
+                         bad ? __atomic_load_n(&p_hdr->req.head, __ATOMIC_ACQUIRE) :
+                               p_hdr->req.tail + gm_cli_shm_rec_size(len),
+                         __ATOMIC_RELEASE);
+    }
+    if (num > 0)
+    {
+        gm_cli_shm_ring_bell(&p_hdr->cli);
+    }
+    return (int)num;
+}
+
+/* 等待共享内存通道中有可以执行的请求 */
+int gm_cli_shm_wait(const unsigned int ms)
+{
+    gm_cli_shm_hdr_t* p_hdr = gm_cli_shm_ctx.p_hdr;
+    uint32_t seen;
+    int ready;
+
+    if (p_hdr == NULL)
+    {
+        return -1;
+    }
+    if (gm_cli_shm_ready(p_hdr))
+    {
+        return 1;
+    }
+    seen = gm_cli_shm_bell_arm(&p_hdr->srv);
+    ready = gm_cli_shm_ready(p_hdr);
+    gm_cli_shm_bell_wait(&p_hdr->srv, seen, ready ? 0 : ms);
+    return ready ? 1 : gm_cli_shm_ready(p_hdr);
+}
+#endif  /* GM_CLI_SHM_EN */
+
+#if GM_CLI_CALL_EN
+/* 设置函数符号表 */
+int gm_cli_set_sym_table(const gm_cli_sym_t* const p_table, const unsigned int num)
+{
+    unsigned int i;
+
+    if ((p_table == NULL) && (num > 0))
+    {
+        return -1;
+    }
+    /* 二分查找要求名称严格递增，生成工具按C locale排序，和strcmp一致 */
+    for (i = 1; i < num; i++)
+    {
+        if (strcmp(p_table[i - 1].name, p_table[i].name) >= 0)
+        {
+            return -1;
+        }
+    }
+    gm_cli_mgr.p_sym_table = p_table;
+    gm_cli_mgr.sym_num = num;
+    return 0;
+}
+
+/* 二分查找第一个名称不小于name的符号，返回下标，都小于时返回符号数 */
+static unsigned int gm_cli_sym_lower_bound(const char* const name)
+{
+    unsigned int low = 0, high = gm_cli_mgr.sym_num, mid;
+
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (strcmp(gm_cli_mgr.p_sym_table[mid].name, name) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* 按名称查找函数符号，返回NULL为不存在 */
+static const gm_cli_sym_t* gm_cli_sym_find(const char* const name)
+{
+    unsigned int i = gm_cli_sym_lower_bound(name);
+
+    if ((i < gm_cli_mgr.sym_num) && (strcmp(gm_cli_mgr.p_sym_table[i].name, name) == 0))
+    {
+        return &gm_cli_mgr.p_sym_table[i];
+    }
+    return NULL;
+}
+#endif  /* GM_CLI_CALL_EN */
+
+#if GM_CLI_WATCH_EN
+/* 周期命令 */
+static gm_cli_watch_t gm_cli_watch[GM_CLI_WATCH_NUM];
+/* 两层时间轮，0层每槽一个节拍，1层每槽GM_CLI_WHEEL_SLOTS个节拍 */
+static gm_cli_watch_t* gm_cli_wheel[2][GM_CLI_WHEEL_SLOTS];
+
+/* 周期命令按到期节拍放入时间轮 */
+static void gm_cli_watch_insert(gm_cli_watch_t* const p_watch)
+{
+    unsigned long delta = p_watch->expire - gm_cli_mgr.wheel_tick;
+    gm_cli_watch_t** pp_head;
+
+    if (delta < GM_CLI_WHEEL_SLOTS)
+    {
+        pp_head = &gm_cli_wheel[0][p_watch->expire & GM_CLI_WHEEL_MASK];
+    }
+    else if (delta < GM_CLI_WHEEL_SLOTS * GM_CLI_WHEEL_SLOTS)
+    {
+        pp_head = &gm_cli_wheel[1][(p_watch->expire >> GM_CLI_WATCH_WHEEL_BITS) & GM_CLI_WHEEL_MASK];
+    }
+    else
+    {
+        /* 超出时间轮范围，放到最晚转到的槽，转到时再重新放入 */
+        pp_head = &gm_cli_wheel[1][((gm_cli_mgr.wheel_tick >> GM_CLI_WATCH_WHEEL_BITS) - 1) &
+                                   GM_CLI_WHEEL_MASK];
+    }
+
+    p_watch->next = *pp_head;
+    if (p_watch->next != NULL)
+    {
+        p_watch->next->pprev = &p_watch->next;
+    }
+    *pp_head = p_watch;
+    p_watch->pprev = pp_head;
+}
+
+/* 周期命令从时间轮中取出 */
+static void gm_cli_watch_remove(gm_cli_watch_t* const p_watch)
+{
+    if (p_watch->pprev != NULL)
+    {
+        *p_watch->pprev = p_watch->next;
+        if (p_watch->next != NULL)
+        {
+            p_watch->next->pprev = p_watch->pprev;
+        }
+        p_watch->pprev = NULL;
+    }
+}
+
+/* 取出槽内链表的第一个，槽内链表在处理时仍可以被删除 */
+static gm_cli_watch_t* gm_cli_watch_pop(gm_cli_watch_t** const pp_head)
+{
+    gm_cli_watch_t* p_watch = *pp_head;
+
+    if (p_watch != NULL)
+    {
+        gm_cli_watch_remove(p_watch);
+    }
+    return p_watch;
+}
+
+/* 槽内链表整体移到局部链表头，执行的命令停止其它周期命令时链表仍然正确 */
+static void gm_cli_watch_take(gm_cli_watch_t** const pp_head, gm_cli_watch_t** const pp_list)
+{
+    *pp_list = *pp_head;
+    *pp_head = NULL;
+    if (*pp_list != NULL)
+    {
+        (*pp_list)->pprev = pp_list;
+    }
+}
+
+/* 停止周期命令 */
+static void gm_cli_watch_kill(gm_cli_watch_t* const p_watch)
+{
+    gm_cli_watch_remove(p_watch);
+    if (p_watch->flags & GM_CLI_WATCH_FLAG_FG)
+    {
+        gm_cli_mgr.watch_fg_num--;
+    }
+    if (gm_cli_mgr.p_watch_last == p_watch)
+    {
+        gm_cli_mgr.p_watch_last = NULL;
+    }
+    p_watch->p_cmd = NULL;
+    gm_cli_mgr.watch_num--;
+}
+
+/* 输出行数统计通道写入 */
+static void gm_cli_watch_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    unsigned int i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] == '\n')
+        {
+            gm_cli_mgr.watch_lines++;
+        }
+    }
+    p_sink->next->write(p_sink->next, buf, len);
+}
+
+/* 执行一次周期命令 */
+static void gm_cli_watch_run(gm_cli_watch_t* const p_watch)
+{
+    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
+    int prompt = (gm_cli_mgr.watch_fg_num == 0);
+
+    if (prompt)
+    {
+        /* 擦除提示符和输入行，输出后重新显示 */
+        gm_cli_put_str("\r\x1b[K");
+    }
+    if ((p_watch->flags & GM_CLI_WATCH_FLAG_REDRAW) &&
+        (gm_cli_mgr.p_watch_last == p_watch) && (p_watch->lines > 0))
+    {
+        /* 上次输出之后没有其它输出，回到上次输出的起始处覆盖 */
+        gm_cli_printf("\x1b[%uA\x1b[J", p_watch->lines);
+    }
+
+    gm_cli_mgr.watch_lines = 0;
+    gm_cli_mgr.watch_sink.write = gm_cli_watch_sink_write;
+    gm_cli_mgr.watch_sink.next = gm_cli_mgr.p_sink;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.watch_sink;
+    /* 命令可能修改参数数组，使用副本 */
+    memcpy(argv, p_watch->argv, sizeof(argv));
+    GM_CLI_RCU_READ_LOCK();
+    gm_cli_run_cmd(p_watch->p_cmd, p_watch->argc, argv);
+    GM_CLI_RCU_READ_UNLOCK();
+    gm_cli_mgr.p_sink = gm_cli_mgr.watch_sink.next;
+
+    p_watch->runs++;
+    p_watch->lines = gm_cli_mgr.watch_lines;
+    gm_cli_mgr.p_watch_last = p_watch;
+    if (prompt)
+    {
+        gm_cli_line_redraw();
+    }
+}
+
+/* 时间轮前进一个节拍，执行到期的周期命令 */
+static void gm_cli_watch_step(void)
+{
+    gm_cli_watch_t* p_list;
+    gm_cli_watch_t* p_watch;
+    int busy = 0;
+
+    gm_cli_mgr.wheel_tick++;
+
+    /* 0层转完一圈，1层对应槽的命令重新放入 */
+    if ((gm_cli_mgr.wheel_tick & GM_CLI_WHEEL_MASK) == 0)
+    {
+        gm_cli_watch_take(&gm_cli_wheel[1][(gm_cli_mgr.wheel_tick >> GM_CLI_WATCH_WHEEL_BITS) &
+                                           GM_CLI_WHEEL_MASK], &p_list);
+        while ((p_watch = gm_cli_watch_pop(&p_list)) != NULL)
+        {
+            gm_cli_watch_insert(p_watch);
+        }
+    }
+
+    /* 二进制帧模式和粘贴时不输出，批量输出未发送完时也不输出，顺延一个周期 */
+#if GM_CLI_BIN_EN
+    busy |= gm_cli_mgr.bin_mode;
+#endif  /* GM_CLI_BIN_EN */
+#if GM_CLI_BRACKETED_PASTE_EN
+    busy |= gm_cli_mgr.paste_mode;
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_OUT_SCHED_EN
+    busy |= (gm_cli_mgr.out_len > 0) || gm_cli_mgr.out_prompt;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+    gm_cli_watch_take(&gm_cli_wheel[0][gm_cli_mgr.wheel_tick & GM_CLI_WHEEL_MASK], &p_list);
+    while ((p_watch = gm_cli_watch_pop(&p_list)) != NULL)
+    {
+        if (p_watch->expire == gm_cli_mgr.wheel_tick)
+        {
+            if (!busy)
+            {
+                gm_cli_watch_run(p_watch);
+            }
+            /* 命令可能停止了自己 */
+            if (p_watch->p_cmd == NULL)
+            {
+                continue;
+            }
+            p_watch->expire += p_watch->interval;
+        }
+        gm_cli_watch_insert(p_watch);
+    }
+}
+
+/* 按时基推进时间轮 */
+static void gm_cli_watch_poll(void)
+{
+    unsigned long ticks;
+
+    if (gm_cli_mgr.pf_tick == NULL)
+    {
+        return;
+    }
+
+    ticks = (gm_cli_mgr.pf_tick() - gm_cli_mgr.wheel_ms) / GM_CLI_WATCH_TICK_MS;
+    gm_cli_mgr.wheel_ms += ticks * GM_CLI_WATCH_TICK_MS;
+    if (gm_cli_mgr.watch_num == 0)
+    {
+        /* 时间轮为空，直接跳过 */
+        gm_cli_mgr.wheel_tick += ticks;
+        return;
+    }
+    while (ticks-- > 0)
+    {
+        gm_cli_watch_step();
+    }
+}
+
+/* 按键停止全部前台周期命令，返回：0 - 已停止，-1 - 没有前台周期命令 */
+static int gm_cli_watch_stop_fg(void)
+{
+    unsigned int i;
+
+    if (gm_cli_mgr.watch_fg_num == 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < GM_CLI_WATCH_NUM; i++)
+    {
+        if ((gm_cli_watch[i].p_cmd != NULL) && (gm_cli_watch[i].flags & GM_CLI_WATCH_FLAG_FG))
+        {
+            gm_cli_watch_kill(&gm_cli_watch[i]);
+        }
+    }
+#if GM_CLI_OUT_SCHED_EN
+    if (gm_cli_out_defer_prompt() == 0)
+    {
+        return 0;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    gm_cli_line_redraw();
+    return 0;
+}
+#endif  /* GM_CLI_WATCH_EN */
+
+#if GM_CLI_PLUGIN_EN
+/* 查找插件导出的命令，先找命令表，再找段，返回：0 - 找到，-1 - 没有导出命令 */
+static int gm_cli_plugin_find_cmds(gm_cli_plugin_t* const p_plugin)
+{
+    const gm_cli_cmd_t* p_cmd = (const gm_cli_cmd_t*)dlsym(p_plugin->handle, "gm_cli_plugin_cmds");
+    const gm_cli_cmd_t* const* pp_section;
+
+    if (p_cmd != NULL)
+    {
+        p_plugin->p_start = p_cmd;
+        while (p_cmd->name != NULL)
+        {
+            p_cmd++;
+        }
+        p_plugin->p_end = p_cmd;
+        return 0;
+    }
+    pp_section = (const gm_cli_cmd_t* const*)dlsym(p_plugin->handle, "gm_cli_plugin_section");
+    if (pp_section != NULL)
+    {
+        p_plugin->p_start = pp_section[0];
+        p_plugin->p_end = pp_section[1];
+        return 0;
+    }
+    return -1;
+}
+
+/* 命令变化后重建查找索引和提示用的BK树 */
+static void gm_cli_plugin_rebuild(void)
+{
+#if (GM_CLI_CMD_INDEX_SIZE > 0)
+    gm_cli_cmd_index_build();
+#endif  /* GM_CLI_CMD_INDEX_SIZE > 0 */
+#if GM_CLI_SUGGEST_EN
+    gm_cli_bk_build();
+#endif  /* GM_CLI_SUGGEST_EN */
+}
+
+/* 加载命令插件 */
+int gm_cli_plugin_load(const char* const path)
+{
+    gm_cli_plugin_t* p_plugin = NULL;
+    const gm_cli_cmd_t* p_cmd;
+    unsigned int i;
+
+    if (path == NULL)
+    {
+        return -1;
+    }
+    if (strlen(path) >= GM_CLI_PLUGIN_PATH_MAX)
+    {
+        gm_cli_put_str("Plugin path too long!\r\n");
+        return -1;
+    }
+    for (i = 0; i < GM_CLI_PLUGIN_NUM; i++)
+    {
+        if (gm_cli_plugin[i].handle == NULL)
+        {
+            if (p_plugin == NULL)
+            {
+                p_plugin = &gm_cli_plugin[i];
+            }
+        }
+        else if (strcmp(gm_cli_plugin[i].path, path) == 0)
+        {
+            gm_cli_put_str("Plugin already loaded!\r\n");
+            return -1;
+        }
+    }
+    if (p_plugin == NULL)
+    {
+        gm_cli_put_str("Too many plugins!\r\n");
+        return -1;
+    }
+
+    p_plugin->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (p_plugin->handle == NULL)
+    {
+        gm_cli_put_str(dlerror());
+        gm_cli_put_str("\r\n");
+        return -1;
+    }
+    if (gm_cli_plugin_find_cmds(p_plugin) != 0)
+    {
+        gm_cli_put_str("No commands exported by plugin!\r\n");
+        p_cmd = NULL;
+    }
+    else
+    {
+        /* 命令名不能和已有命令重复 */
+        for (p_cmd = p_plugin->p_start; p_cmd < p_plugin->p_end; p_cmd++)
+        {
+            if ((p_cmd->name == NULL) || (gm_cli_search_cmd(p_cmd->name) != NULL))
+            {
+                gm_cli_printf("Command \"%s\" already exists!\r\n",
+                              (p_cmd->name != NULL) ? p_cmd->name : "");
+                break;
+            }
+        }
+    }
+    if (p_cmd != p_plugin->p_end)
+    {
+        dlclose(p_plugin->handle);
+        p_plugin->handle = NULL;
+        p_plugin->p_start = NULL;
+        p_plugin->p_end = NULL;
+        return -1;
+    }
+
+    strcpy(p_plugin->path, path);
+    __atomic_store_n(&p_plugin->active, 1, __ATOMIC_RELEASE);
+    gm_cli_plugin_rebuild();
+    return 0;
+}
+
+/* 卸载命令插件 */
+int gm_cli_plugin_unload(const char* const name)
+{
+    gm_cli_plugin_t* p_plugin = NULL;
+    unsigned long id;
+    unsigned int i;
+    char* p_end;
+
+    if (name == NULL)
+    {
+        return -1;
+    }
+    id = strtoul(name, &p_end, 10);
+    for (i = 0; i < GM_CLI_PLUGIN_NUM; i++)
+    {
+        if ((gm_cli_plugin[i].handle != NULL) &&
+            (((*p_end == '\0') && (id == i + 1)) || (strcmp(gm_cli_plugin[i].path, name) == 0)))
+        {
+            p_plugin = &gm_cli_plugin[i];
+            break;
+        }
+    }
+    if (p_plugin == NULL)
+    {
+        gm_cli_put_str("No such plugin!\r\n");
+        return -1;
+    }
+    /* 嵌套执行时外层的命令可能就在插件中 */
+    if (gm_cli_rcu_depth > 1)
+    {
+        gm_cli_put_str("Plugin busy!\r\n");
+        return -1;
+    }
+
+    /* 先让插件的命令不可见，再清除对命令的引用 */
+    __atomic_store_n(&p_plugin->active, 0, __ATOMIC_RELEASE);
+#if GM_CLI_WATCH_EN
+    for (i = 0; i < GM_CLI_WATCH_NUM; i++)
+    {
+        if ((gm_cli_watch[i].p_cmd >= p_plugin->p_start) && (gm_cli_watch[i].p_cmd < p_plugin->p_end))
+        {
+            gm_cli_watch_kill(&gm_cli_watch[i]);
+        }
+    }
+#endif  /* GM_CLI_WATCH_EN */
+#if GM_CLI_CACHE_EN
+    for (i = 0; i < GM_CLI_CACHE_ENTRY_NUM; i++)
+    {
+        if ((gm_cli_cache[i].p_cmd >= p_plugin->p_start) && (gm_cli_cache[i].p_cmd < p_plugin->p_end))
+        {
+            gm_cli_cache[i].valid = 0;
+            if (&gm_cli_cache[i] == gm_cli_mgr.p_cache_fill)
+            {
+                gm_cli_mgr.cache_overflow = 1;
+            }
+            else
+            {
+                gm_cli_cache[i].p_cmd = NULL;
+            }
+        }
+    }
+#endif  /* GM_CLI_CACHE_EN */
+    gm_cli_plugin_rebuild();
+    /* 等待切换索引之前开始的查找和执行全部结束 */
+    gm_cli_rcu_sync();
+
+    dlclose(p_plugin->handle);
+    p_plugin->handle = NULL;
+    p_plugin->p_start = NULL;
+    p_plugin->p_end = NULL;
+    return 0;
+}
+#endif  /* GM_CLI_PLUGIN_EN */
+
+#if GM_CLI_LOG_EN
+/* 日志队列 */
+static gm_cli_log_slot_t gm_cli_log_queue[GM_CLI_LOG_NUM];
+
+/* 初始化日志队列 */
+static void gm_cli_log_init(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < GM_CLI_LOG_NUM; i++)
+    {
+        gm_cli_atomic_store(&gm_cli_log_queue[i].seq, i);
+    }
+    gm_cli_atomic_store(&gm_cli_mgr.log_tail, 0);
+    gm_cli_atomic_store(&gm_cli_mgr.log_dropped, 0);
+    gm_cli_mgr.log_head = 0;
+}
+
+/* 抢占一个可写的槽，队列满时丢弃并计数，不等待，返回槽，队列满时返回NULL */
+static gm_cli_log_slot_t* gm_cli_log_acquire(unsigned int* const p_pos)
+{
+    gm_cli_log_slot_t* p_slot;
+    unsigned int pos, seq;
+
+    pos = gm_cli_atomic_load(&gm_cli_mgr.log_tail);
+    while (1)
+    {
+        p_slot = &gm_cli_log_queue[pos & (GM_CLI_LOG_NUM - 1)];
+        seq = gm_cli_atomic_load(&p_slot->seq);
+        if (seq == pos)
+        {
+            if (gm_cli_atomic_cas(&gm_cli_mgr.log_tail, pos, pos + 1))
+            {
+                *p_pos = pos;
+                return p_slot;
+            }
+            pos = gm_cli_atomic_load(&gm_cli_mgr.log_tail);
+        }
+        else if ((int)(seq - pos) < 0)
+        {
+            /* 这个槽还没有被读走，队列已满 */
+            seq = gm_cli_atomic_load(&gm_cli_mgr.log_dropped);
+            while (!gm_cli_atomic_cas(&gm_cli_mgr.log_dropped, seq, seq + 1))
+            {
+                seq = gm_cli_atomic_load(&gm_cli_mgr.log_dropped);
+            }
+            return NULL;
+        }
+        else
+        {
+            /* 其它线程已经占用，重新读取写入位置 */
+            pos = gm_cli_atomic_load(&gm_cli_mgr.log_tail);
+        }
+    }
+}
+
+/* 去掉行尾的换行后发布，行尾的换行由命令行统一输出 */
+static void gm_cli_log_publish(gm_cli_log_slot_t* const p_slot, const unsigned int pos, unsigned int len)
+{
+    while ((len > 0) && ((p_slot->buf[len - 1] == '\n') || (p_slot->buf[len - 1] == '\r')))
+    {
+        len--;
+    }
+    p_slot->len = len;
+    gm_cli_atomic_store(&p_slot->seq, pos + 1);
+}
+
+/* 输出日志 */
+int gm_cli_log(const char* const fmt, ...)
+{
+    gm_cli_log_slot_t* p_slot;
+    unsigned int pos;
+    va_list ap;
+    int len;
+
+    if (fmt == NULL)
+    {
+        return -1;
+    }
+    p_slot = gm_cli_log_acquire(&pos);
+    if (p_slot == NULL)
+    {
+        return -1;
+    }
+
+    /* 占用的槽只由本线程写入，格式化完成后再发布 */
+    va_start(ap, fmt);
+    len = vsnprintf(p_slot->buf, sizeof(p_slot->buf), fmt, ap);
+    va_end(ap);
+    if (len < 0)
+    {
+        len = 0;
+    }
+    else if (len >= (int)sizeof(p_slot->buf))
+    {
+        len = (int)sizeof(p_slot->buf) - 1;
+    }
+    gm_cli_log_publish(p_slot, pos, (unsigned int)len);
+
+    return 0;
+}
+
+/* 输出已格式化的日志，只复制字符串，不调用格式化函数 */
+int gm_cli_log_str(const char* const str)
+{
+    gm_cli_log_slot_t* p_slot;
+    unsigned int pos, len;
+
+    if (str == NULL)
+    {
+        return -1;
+    }
+    p_slot = gm_cli_log_acquire(&pos);
+    if (p_slot == NULL)
+    {
+        return -1;
+    }
+    for (len = 0; (len < sizeof(p_slot->buf) - 1) && (str[len] != '\0'); len++)
+    {
+        p_slot->buf[len] = str[len];
+    }
+    p_slot->buf[len] = '\0';
+    gm_cli_log_publish(p_slot, pos, len);
+
+    return 0;
+}
+
+/* 批量输出日志，输入行只擦除和重绘一次 */
+static void gm_cli_log_drain(void)
+{
+    gm_cli_log_slot_t* p_slot;
+    unsigned int num, dropped;
+    int prompt = 1;
+
+    p_slot = &gm_cli_log_queue[gm_cli_mgr.log_head & (GM_CLI_LOG_NUM - 1)];
+    dropped = gm_cli_atomic_load(&gm_cli_mgr.log_dropped);
+    if ((gm_cli_atomic_load(&p_slot->seq) != gm_cli_mgr.log_head + 1) && (dropped == 0))
+    {
+        return;
+    }
+#if GM_CLI_BIN_EN
+    /* 二进制帧模式下不能输出，先留在队列中 */
+    if (gm_cli_mgr.bin_mode)
+    {
+        return;
+    }
+#endif  /* GM_CLI_BIN_EN */
+#if GM_CLI_BRACKETED_PASTE_EN
+    if (gm_cli_mgr.paste_mode)
+    {
+        return;
+    }
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+#if GM_CLI_OUT_SCHED_EN
+    /* 等命令输出和提示符显示完成 */
+    if ((gm_cli_mgr.out_len > 0) || gm_cli_mgr.out_prompt)
+    {
+        return;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#if GM_CLI_WATCH_EN
+    /* 前台周期命令运行时没有显示输入行 */
+    prompt = (gm_cli_mgr.watch_fg_num == 0);
+    gm_cli_mgr.p_watch_last = NULL;
+#endif  /* GM_CLI_WATCH_EN */
+
+    if (prompt)
+    {
+        /* 擦除提示符和输入行 */
+        gm_cli_put_str("\r\x1b[K");
+    }
+    /* 一次最多输出一整个队列，生产者一直写入时也能回到输入处理 */
+    for (num = 0; num < GM_CLI_LOG_NUM; num++)
+    {
+        p_slot = &gm_cli_log_queue[gm_cli_mgr.log_head & (GM_CLI_LOG_NUM - 1)];
+        if (gm_cli_atomic_load(&p_slot->seq) != gm_cli_mgr.log_head + 1)
+        {
+            break;
+        }
+        gm_cli_put_buf(p_slot->buf, p_slot->len);
+        gm_cli_put_str("\r\n");
+        /* 槽交还给下一轮的写入者 */
+        gm_cli_atomic_store(&p_slot->seq, gm_cli_mgr.log_head + GM_CLI_LOG_NUM);
+        gm_cli_mgr.log_head++;
+    }
+    if (dropped > 0)
+    {
+        dropped = gm_cli_atomic_xchg(&gm_cli_mgr.log_dropped, 0);
+        gm_cli_printf("[%u log lines dropped]\r\n", dropped);
+    }
+    if (prompt)
+    {
+        gm_cli_line_redraw();
+    }
+}
+#endif  /* GM_CLI_LOG_EN */
+
+#if GM_CLI_OUT_SCHED_EN
+/* 按速率发送一块批量输出，发送完成后显示推迟的提示符，
+ * 返回：0 - 没有待发送的输出，-1 - 还有待发送的输出 */
+static int gm_cli_out_poll(void)
+{
+    unsigned int max = GM_CLI_OUT_BULK_CHUNK;
+#if (GM_CLI_OUT_BULK_RATE > 0)
+    unsigned long now, elapsed;
+
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        /* 令牌桶，每ms增加GM_CLI_OUT_BULK_RATE字节，最多累积一块 */
+        now = gm_cli_mgr.pf_tick();
+        elapsed = now - gm_cli_mgr.out_stamp;
+        gm_cli_mgr.out_stamp = now;
+        if (elapsed >= GM_CLI_OUT_BULK_CHUNK)
+        {
+            gm_cli_mgr.out_credit = GM_CLI_OUT_BULK_CHUNK;
+        }
+        else
+        {
+            gm_cli_mgr.out_credit += elapsed * GM_CLI_OUT_BULK_RATE;
+            if (gm_cli_mgr.out_credit > GM_CLI_OUT_BULK_CHUNK)
+            {
+                gm_cli_mgr.out_credit = GM_CLI_OUT_BULK_CHUNK;
+            }
+        }
+        max = (unsigned int)gm_cli_mgr.out_credit;
+    }
+#endif  /* GM_CLI_OUT_BULK_RATE */
+
+    if (gm_cli_mgr.out_len > 0)
+    {
+        max = gm_cli_out_send(max);
+#if (GM_CLI_OUT_BULK_RATE > 0)
+        if (gm_cli_mgr.pf_tick != NULL)
+        {
+            gm_cli_mgr.out_credit -= max;
+        }
+#endif  /* GM_CLI_OUT_BULK_RATE */
+        if (gm_cli_mgr.out_len > 0)
+        {
+            return -1;
+        }
+    }
+#if GM_CLI_MEM_EN
+    /* 批量输出发送完后再格式化md的下一块 */
+    if (gm_cli_mgr.mem_width != 0)
+    {
+        gm_cli_mem_resume();
+        return -1;
+    }
+#endif  /* GM_CLI_MEM_EN */
+
+    if (gm_cli_mgr.out_prompt)
+    {
+        gm_cli_mgr.out_prompt = 0;
+        gm_cli_mgr.out_class = GM_CLI_OUT_INTERACTIVE;
+        if (gm_cli_mgr.out_dirty)
+        {
+            /* 回显的字符混在命令输出中，在新行重新显示 */
+            gm_cli_mgr.out_dirty = 0;
+            gm_cli_put_str("\r\n");
+        }
+#if GM_CLI_WATCH_EN
+        if (gm_cli_mgr.watch_fg_num == 0)
+#endif  /* GM_CLI_WATCH_EN */
+        {
+            gm_cli_line_redraw();
+        }
+        gm_cli_mgr.out_class = GM_CLI_OUT_BULK;
+    }
+    return 0;
+}
+
+/* 中断键处理，丢弃未发送的命令输出，停止前台周期命令，清空输入行 */
+static void gm_cli_out_cancel(void)
+{
+    unsigned int dropped = gm_cli_mgr.out_len;
+
+    gm_cli_mgr.out_head = 0;
+    gm_cli_mgr.out_len = 0;
+    gm_cli_mgr.out_prompt = 0;
+    gm_cli_mgr.out_dirty = 0;
+#if GM_CLI_MEM_EN
+    gm_cli_mgr.mem_width = 0;
+#endif  /* GM_CLI_MEM_EN */
+    if (dropped > 0)
+    {
+        gm_cli_printf("^C [%u bytes dropped]\r\n", dropped);
+    }
+    else
+    {
+        gm_cli_put_str("^C\r\n");
+    }
+    gm_cli_line_clear();
+#if GM_CLI_WATCH_EN
+    if (gm_cli_watch_stop_fg() == 0)
+    {
+        return;
+    }
+#endif  /* GM_CLI_WATCH_EN */
+    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+}
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+/* CLI后台处理 */
+void gm_cli_poll(void)
+{
+    GM_CLI_TRACE(GM_CLI_TRACE_POLL | GM_CLI_TRACE_BEGIN, 0);
+#if GM_CLI_SHM_EN
+    /* 控制通道的输出不经过终端，不受输出调度限制 */
+    gm_cli_shm_poll();
+#endif  /* GM_CLI_SHM_EN */
+#if GM_CLI_OUT_SCHED_EN
+    /* 批量输出优先，没有发送完时不产生新的后台输出 */
+    if (gm_cli_out_poll() != 0)
+    {
+#if GM_CLI_REC_EN
+        gm_cli_rec_poll();
+#endif  /* GM_CLI_REC_EN */
+        GM_CLI_TRACE(GM_CLI_TRACE_POLL | GM_CLI_TRACE_END, 1);
+        return;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+#if GM_CLI_WATCH_EN
+    gm_cli_watch_poll();
+#endif  /* GM_CLI_WATCH_EN */
+#if GM_CLI_LOG_EN
+    gm_cli_log_drain();
+#endif  /* GM_CLI_LOG_EN */
+#if GM_CLI_REC_EN
+    gm_cli_rec_poll();
+#endif  /* GM_CLI_REC_EN */
+    GM_CLI_TRACE(GM_CLI_TRACE_POLL | GM_CLI_TRACE_END, 0);
+}
+
+#if GM_CLI_SESSION_EN
+/* 会话保存通道写入，数据不再传给下一级 */
+static void gm_cli_session_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    (void)p_sink;
+    if (len > gm_cli_mgr.session_size - gm_cli_mgr.session_len)
+    {
+        gm_cli_mgr.session_overflow = 1;
+        return;
+    }
+    memcpy(&gm_cli_mgr.session_buf[gm_cli_mgr.session_len], buf, len);
+    gm_cli_mgr.session_len += len;
+}
+
+/* 输出改为写入会话保存位置，size为0时丢弃输出 */
+static void gm_cli_session_attach(char* const buf, const unsigned int size)
+{
+    gm_cli_mgr.session_buf = buf;
+    gm_cli_mgr.session_size = size;
+    gm_cli_mgr.session_len = 0;
+    gm_cli_mgr.session_overflow = 0;
+    gm_cli_mgr.session_sink.write = gm_cli_session_sink_write;
+    gm_cli_mgr.session_sink.next = gm_cli_mgr.p_sink;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.session_sink;
+}
+
+/* 保存会话状态 */
+int gm_cli_session_save(char* const buf, const unsigned int size)
+{
+    unsigned int i, index;
+
+    if (buf == NULL)
+    {
+        return -1;
+    }
+
+    gm_cli_session_attach(buf, size);
+#if GM_CLI_EMIT_EN
+    if (gm_cli_mgr.emit_fmt != GM_CLI_FMT_TEXT)
+    {
+        gm_cli_put_str("format ");
+        gm_cli_put_str(gm_cli_fmt_name[gm_cli_mgr.emit_fmt]);
+        gm_cli_put_char('\n');
+    }
+#endif  /* GM_CLI_EMIT_EN */
+#if GM_CLI_ALIAS_EN
+    for (i = 0; i < GM_CLI_ALIAS_NUM; i++)
+    {
+        if (gm_cli_alias[i].cmd.name != NULL)
+        {
+            gm_cli_alias_put(&gm_cli_alias[i]);
+            gm_cli_put_char('\n');
+        }
+    }
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_VAR_EN
+    for (i = 0; i < GM_CLI_VAR_NUM; i++)
+    {
+        if (gm_cli_var[i].state == GM_CLI_VAR_USED)
+        {
+            gm_cli_var_put(&gm_cli_var[i]);
+            gm_cli_put_char('\n');
+        }
+    }
+#endif  /* GM_CLI_VAR_EN */
+    /* 历史记录从最早的开始，以'!'开头 */
+    index = (gm_cli_mgr.history_index + GM_CLI_HISTORY_LINE_MAX - gm_cli_mgr.history_total) %
+            GM_CLI_HISTORY_LINE_MAX;
+    for (i = 0; i < gm_cli_mgr.history_total; i++)
+    {
+        gm_cli_put_char('!');
+        gm_cli_history_put(index);
+        gm_cli_put_char('\n');
+        index = (index + 1) % GM_CLI_HISTORY_LINE_MAX;
+    }
+    gm_cli_mgr.p_sink = gm_cli_mgr.session_sink.next;
+
+    return gm_cli_mgr.session_overflow ? -1 : (int)gm_cli_mgr.session_len;
+}
+
+/* 恢复会话状态 */
+int gm_cli_session_restore(const char* const buf, const unsigned int len)
+{
+    char line[GM_CLI_LINE_CHAR_MAX];
+    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
+    const char* p_end;
+    unsigned int pos = 0, n;
+    int argc, ret = 0;
+#if GM_CLI_EMIT_EN
+    unsigned int i;
+#endif  /* GM_CLI_EMIT_EN */
+
+    if (buf == NULL)
+    {
+        return -1;
+    }
+
+    /* 恢复过程中的错误提示不输出 */
+    gm_cli_session_attach(NULL, 0);
+    while (pos < len)
+    {
+        p_end = memchr(&buf[pos], '\n', len - pos);
+        n = (p_end != NULL) ? (unsigned int)(p_end - &buf[pos]) : (len - pos);
+        if (n >= sizeof(line))
+        {
+            ret = -1;
+        }
+        else if ((n > 1) && (buf[pos] == '!'))
+        {
+            gm_cli_history_add(&buf[pos + 1], n - 1);
+        }
+        else if (n > 0)
+        {
+            memcpy(line, &buf[pos], n);
+            line[n] = '\0';
+            argc = gm_cli_split_args(line, argv);
+#if GM_CLI_EMIT_EN
+            if ((argc == 2) && (strcmp(argv[0], "format") == 0))
+            {
+                for (i = 0; i < sizeof(gm_cli_fmt_name) / sizeof(gm_cli_fmt_name[0]); i++)
+                {
+                    if (strcmp(argv[1], gm_cli_fmt_name[i]) == 0)
+                    {
+                        gm_cli_set_output_fmt((gm_cli_fmt_t)i);
+                        break;
+                    }
+                }
+                argc = (i < sizeof(gm_cli_fmt_name) / sizeof(gm_cli_fmt_name[0])) ? 0 : -1;
+            }
+#endif  /* GM_CLI_EMIT_EN */
+#if GM_CLI_ALIAS_EN
+            if ((argc == 2) && (strcmp(argv[0], "alias") == 0))
+            {
+                argc = (gm_cli_alias_define(argv[1]) == 0) ? 0 : -1;
+            }
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_VAR_EN
+            if ((argc == 3) && (strcmp(argv[0], "set") == 0))
+            {
+                argc = (gm_cli_var_set(argv[1], argv[2]) == 0) ? 0 : -1;
+            }
+#endif  /* GM_CLI_VAR_EN */
+            if (argc != 0)
+            {
+                ret = -1;
+            }
+        }
+        pos += n + 1;
+    }
+    gm_cli_mgr.p_sink = gm_cli_mgr.session_sink.next;
+
+    return ret;
+}
+#endif  /* GM_CLI_SESSION_EN */
+
+/* 回车换行键处理 */
+static void gm_cli_parse_enter_key(void)
+{
+    /* 回车，处理命令时可能有输出 */
+    gm_cli_put_str("\r\n");
+
+    if (gm_cli_mgr.input_count > 0)
+    {
+        /* 备份进入历史记录 */
+        gm_cli_history_add(gm_cli_line_text(), gm_cli_mgr.input_count);
+        gm_cli_mgr.history_inquire_index = 0;
+        gm_cli_mgr.history_inquire_count = 0;
+
+        /* 执行命令 */
+        gm_cli_exec(gm_cli_mgr.line, NULL);
+    }
+
+#if GM_CLI_WATCH_EN
+    /* 终端上有新的输出，周期命令不能再原位刷新 */
+    gm_cli_mgr.p_watch_last = NULL;
+    /* 前台周期命令运行时不显示提示符，按键停止后再显示 */
+    if (gm_cli_mgr.watch_fg_num > 0)
+    {
+        gm_cli_line_clear();
+        return;
+    }
+#endif  /* GM_CLI_WATCH_EN */
+
+#if GM_CLI_OUT_SCHED_EN
+    /* 命令输出还没有发送完，提示符在发送完成后显示 */
+    if (gm_cli_out_defer_prompt() == 0)
+    {
+        gm_cli_line_clear();
+        return;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+    /* 清空行，为下一次输入准备 */
+    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+    gm_cli_line_clear();
+}
+
+/* 通用可显示字符处理，字符插入到光标处的间隙中 */
+static void gm_cli_parse_common_char(const char ch)
+{
+    unsigned int i, count;
+
+    /* 保留一个字符给'\0' */
+    if (gm_cli_mgr.input_count >= (gm_cli_mgr.line_size - 1))
+    {
+        return;
+    }
+
+    gm_cli_mgr.line[gm_cli_mgr.input_cusor++] = ch;
+    gm_cli_mgr.input_count++;
+    gm_cli_put_char(ch);
+
+    if (gm_cli_mgr.input_cusor != gm_cli_mgr.input_count)
+    {
+        /* 光标不在最后，刷新光标后的显示 */
+        count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
+        gm_cli_put_buf(&gm_cli_mgr.line[gm_cli_mgr.line_gap_end], count);
+        /* 光标回位 */
+        for (i = 0; i < count; i++)
+        {
+            gm_cli_put_char('\b');
+        }
+    }
+}
+
+#if GM_CLI_BRACKETED_PASTE_EN
+/* 回显粘贴插入的内容，一次输出 */
+static void gm_cli_paste_echo(void)
+{
+    unsigned int i, count;
+
+    if (gm_cli_mgr.input_cusor > gm_cli_mgr.paste_echo_pos)
+    {
+        gm_cli_put_buf(&gm_cli_mgr.line[gm_cli_mgr.paste_echo_pos],
+                       gm_cli_mgr.input_cusor - gm_cli_mgr.paste_echo_pos);
+        if (gm_cli_mgr.input_cusor != gm_cli_mgr.input_count)
+        {
+            /* 光标不在最后，刷新光标后的显示 */
+            count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
+            gm_cli_put_buf(&gm_cli_mgr.line[gm_cli_mgr.line_gap_end], count);
+            for (i = 0; i < count; i++)
+            {
+                gm_cli_put_char('\b');
+            }
+        }
+    }
+    gm_cli_mgr.paste_echo_pos = gm_cli_mgr.input_cusor;
+}
+
+/* 粘贴字符处理，不回显，不处理功能键，换行时回显整行后执行 */
+static void gm_cli_paste_insert(const char ch)
+{
+    char last_ch = gm_cli_mgr.paste_last_ch;
+
+    gm_cli_mgr.paste_last_ch = ch;
+    if ((ch == '\r') || (ch == '\n'))
+    {
+        if ((ch == '\n') && (last_ch == '\r'))
+        {
+            /* \r\n只算一次换行 */
+            return;
+        }
+        gm_cli_paste_echo();
+        gm_cli_parse_enter_key();
+        gm_cli_mgr.paste_echo_pos = 0;
+    }
+    else if ((ch == '\t') || ((ch >= ' ') && (ch <= '~')))
+    {
+        /* Tab按普通字符插入，其他控制字符丢弃 */
+        if (gm_cli_mgr.input_count < gm_cli_mgr.line_size - 1)
+        {
+            gm_cli_mgr.line[gm_cli_mgr.input_cusor++] = ch;
+            gm_cli_mgr.input_count++;
+        }
+    }
+}
+
+/* 粘贴模式下解析一个字符，识别结束序列"ESC[201~" */
+static void gm_cli_parse_paste_char(const char ch)
+{
+    static const char end_seq[] = "\x1b[201~";
+    unsigned int i;
+
+    if (ch == end_seq[gm_cli_mgr.paste_match])
+    {
+        if (++gm_cli_mgr.paste_match == sizeof(end_seq) - 1)
+        {
+            /* 粘贴结束，回显剩余的内容 */
+            gm_cli_mgr.paste_mode = 0;
+            gm_cli_mgr.paste_match = 0;
+            gm_cli_paste_echo();
+        }
+        return;
+    }
+
+    if (gm_cli_mgr.paste_match > 0)
+    {
+        /* 不是结束序列，已匹配部分除ESC外按粘贴内容处理 */
+        for (i = 1; i < gm_cli_mgr.paste_match; i++)
+        {
+            gm_cli_paste_insert(end_seq[i]);
+        }
+        gm_cli_mgr.paste_match = (ch == end_seq[0]) ? 1 : 0;
+        if (gm_cli_mgr.paste_match)
+        {
+            return;
+        }
+    }
+
+    gm_cli_paste_insert(ch);
+}
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+
+#if GM_CLI_BIN_EN
+/* 进入二进制帧模式的序列，均为普通模式下会被忽略的字符 */
+static const unsigned char gm_cli_bin_magic[] = { 0xA5, 0xC3, 0x96, 0xF1 };
+
+/* 帧头 */
+#define GM_CLI_BIN_REQ_SOF          0xA5u   /* 请求帧头 */
+#define GM_CLI_BIN_RSP_SOF          0x5Au   /* 响应帧头 */
+/* 请求标志 */
+#define GM_CLI_BIN_REQ_EXIT         0x01u   /* 退出二进制帧模式 */
+/* 响应标志 */
+#define GM_CLI_BIN_RSP_TRUNC        0x01u   /* 输出超出缓存被截断 */
+#define GM_CLI_BIN_RSP_NOT_EXEC     0x02u   /* 命令未执行 */
+#define GM_CLI_BIN_RSP_BAD_FRAME    0x04u   /* 请求帧错误，CRC错误或过长 */
+#define GM_CLI_BIN_RSP_MODE         0x80u   /* 模式切换应答 */
+
+/* CRC16-CCITT（多项式0x1021，初值0xFFFF），半字节查表 */
+static unsigned int gm_cli_bin_crc16(unsigned int crc, const unsigned char* buf,
+                                     unsigned int len)
+{
+    static const unsigned short table[16] =
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+
+    while (len--)
+    {
+        crc = (crc << 4) ^ table[((crc >> 12) ^ (*buf >> 4)) & 0x0F];
+        crc = (crc << 4) ^ table[((crc >> 12) ^ (*buf & 0x0F)) & 0x0F];
+        crc &= 0xFFFF;
+        buf++;
+    }
+    return crc;
+}
+
+/* 响应输出捕获通道写入，超出缓存的部分丢弃并标记截断 */
+static void gm_cli_bin_sink_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
+{
+    unsigned int n = GM_CLI_BIN_RSP_MAX - gm_cli_mgr.bin_rsp_len;
+
+    (void)p_sink;
+    if (len > n)
+    {
+        len = n;
+        gm_cli_mgr.bin_rsp_flags |= GM_CLI_BIN_RSP_TRUNC;
+    }
+    memcpy(&gm_cli_mgr.bin_rsp[gm_cli_mgr.bin_rsp_len], buf, len);
+    gm_cli_mgr.bin_rsp_len += len;
+}
+
+/* 发送响应帧：帧头(1) + 标志(1) + 序号(2) + 返回值(4) + 长度(2) + 输出 + CRC(2)，
+ * 多字节均为小端，CRC从标志开始计算到输出结束 */
+static void gm_cli_bin_send(const unsigned int seq, const int ret)
+{
+    unsigned char head[10], tail[2];
+    unsigned int crc;
+    unsigned long uret = (unsigned long)ret;
+
+    head[0] = GM_CLI_BIN_RSP_SOF;
+    head[1] = (unsigned char)gm_cli_mgr.bin_rsp_flags;
+    head[2] = (unsigned char)(seq & 0xFF);
+    head[3] = (unsigned char)((seq >> 8) & 0xFF);
+    head[4] = (unsigned char)(uret & 0xFF);
+    head[5] = (unsigned char)((uret >> 8) & 0xFF);
+    head[6] = (unsigned char)((uret >> 16) & 0xFF);
+    head[7] = (unsigned char)((uret >> 24) & 0xFF);
+    head[8] = (unsigned char)(gm_cli_mgr.bin_rsp_len & 0xFF);
+    head[9] = (unsigned char)((gm_cli_mgr.bin_rsp_len >> 8) & 0xFF);
+    crc = gm_cli_bin_crc16(0xFFFF, &head[1], sizeof(head) - 1);
+    crc = gm_cli_bin_crc16(crc, (const unsigned char*)gm_cli_mgr.bin_rsp, gm_cli_mgr.bin_rsp_len);
+    tail[0] = (unsigned char)(crc & 0xFF);
+    tail[1] = (unsigned char)((crc >> 8) & 0xFF);
+
+    gm_cli_put_buf((const char*)head, sizeof(head));
+    gm_cli_put_buf(gm_cli_mgr.bin_rsp, gm_cli_mgr.bin_rsp_len);
+    gm_cli_put_buf((const char*)tail, sizeof(tail));
+}
+
+/* 发送模式切换应答 */
+static void gm_cli_bin_send_mode(void)
+{
+    static const char ack[] = "GM_CLI_BIN/1";
+
+    gm_cli_mgr.bin_rsp_flags = GM_CLI_BIN_RSP_MODE;
+    gm_cli_mgr.bin_rsp_len = sizeof(ack) - 1;
+    memcpy(gm_cli_mgr.bin_rsp, ack, sizeof(ack) - 1);
+    gm_cli_bin_send(0, gm_cli_mgr.bin_mode);
+}
+
+/* 处理一个完整的请求帧 */
+static void gm_cli_bin_process(void)
+{
+    unsigned char* rx = gm_cli_mgr.bin_rx;
+    unsigned int len = rx[3] | ((unsigned int)rx[4] << 8);
+    unsigned int seq = rx[1] | ((unsigned int)rx[2] << 8);
+    unsigned int crc = rx[5 + len] | ((unsigned int)rx[6 + len] << 8);
+    int ret = 0;
+
+    gm_cli_mgr.bin_rsp_len = 0;
+    gm_cli_mgr.bin_rsp_flags = 0;
+
+    if (gm_cli_bin_crc16(0xFFFF, rx, 5 + len) != crc)
+    {
+        gm_cli_mgr.bin_rsp_flags = GM_CLI_BIN_RSP_BAD_FRAME;
+        gm_cli_bin_send(seq, -1);
+        return;
+    }
+
+    if (rx[0] & GM_CLI_BIN_REQ_EXIT)
+    {
+        /* 退出二进制帧模式，恢复命令提示符 */
+        gm_cli_mgr.bin_mode = 0;
+        gm_cli_bin_send_mode();
+        gm_cli_put_str("\r\n");
+        gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
+        return;
+    }
+
+    /* 捕获命令输出，不回显，不记录历史 */
+    rx[5 + len] = '\0';
+    gm_cli_mgr.bin_sink.write = gm_cli_bin_sink_write;
+    gm_cli_mgr.bin_sink.next = gm_cli_mgr.p_sink;
+    gm_cli_mgr.p_sink = &gm_cli_mgr.bin_sink;
+    if (gm_cli_exec((char*)&rx[5], &ret) != 0)
+    {
+        gm_cli_mgr.bin_rsp_flags |= GM_CLI_BIN_RSP_NOT_EXEC;
+        ret = -1;
+    }
+    gm_cli_mgr.p_sink = gm_cli_mgr.bin_sink.next;
+
+    gm_cli_bin_send(seq, ret);
+}
+
+/* 二进制帧模式下解析一个字符 */
+static void gm_cli_bin_parse_char(const char ch)
+{
+    unsigned int len;
+
+    if (gm_cli_mgr.bin_rx_len == 0)
+    {
+        /* 等待帧头，其他字符丢弃 */
+        if ((unsigned char)ch == GM_CLI_BIN_REQ_SOF)
+        {
+            gm_cli_mgr.bin_rx_len = 1;
+        }
+        return;
+    }
+
+    gm_cli_mgr.bin_rx[gm_cli_mgr.bin_rx_len - 1] = (unsigned char)ch;
+    gm_cli_mgr.bin_rx_len++;
+    if (gm_cli_mgr.bin_rx_len < 6)
+    {
+        return;
+    }
+
+    len = gm_cli_mgr.bin_rx[3] | ((unsigned int)gm_cli_mgr.bin_rx[4] << 8);
+    if (len > GM_CLI_BIN_FRAME_MAX)
+    {
+        /* 过长，回复错误后重新同步 */
+        gm_cli_mgr.bin_rx_len = 0;
+        gm_cli_mgr.bin_rsp_len = 0;
+        gm_cli_mgr.bin_rsp_flags = GM_CLI_BIN_RSP_BAD_FRAME;
+        gm_cli_bin_send(gm_cli_mgr.bin_rx[1] | ((unsigned int)gm_cli_mgr.bin_rx[2] << 8), -1);
+        return;
+    }
+    if (gm_cli_mgr.bin_rx_len == len + 8)
+    {
+        gm_cli_mgr.bin_rx_len = 0;
+        gm_cli_bin_process();
+    }
+}
+
+/* 检测进入二进制帧模式的序列，返回：0 - 属于序列的字符，-1 - 其他字符 */
+static int gm_cli_bin_check_magic(const char ch)
+{
+    if ((unsigned char)ch == gm_cli_bin_magic[gm_cli_mgr.bin_match])
+    {
+        if (++gm_cli_mgr.bin_match == sizeof(gm_cli_bin_magic))
+        {
+            /* 丢弃未完成的输入，进入二进制帧模式 */
+#if GM_CLI_OUT_SCHED_EN
+            /* 未发送的命令输出不能插在响应帧中间 */
+            gm_cli_out_send(GM_CLI_OUT_BULK_BUF_SIZE);
+            gm_cli_mgr.out_prompt = 0;
+            gm_cli_mgr.out_dirty = 0;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+            gm_cli_mgr.bin_match = 0;
+            gm_cli_mgr.bin_mode = 1;
+            gm_cli_mgr.bin_rx_len = 0;
+            gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
+            gm_cli_line_clear();
+            gm_cli_bin_send_mode();
+        }
+        return 0;
+    }
+    gm_cli_mgr.bin_match = ((unsigned char)ch == gm_cli_bin_magic[0]) ? 1 : 0;
+    return gm_cli_mgr.bin_match ? 0 : -1;
+}
+#endif  /* GM_CLI_BIN_EN */
+
+/* 解析一个字符 */
+static void gm_cli_parse_char_in(const char ch)
+{
+#if GM_CLI_BIN_EN
+    /* 二进制帧模式，所有字符都是帧数据 */
+    if (gm_cli_mgr.bin_mode)
+    {
+        gm_cli_bin_parse_char(ch);
+        return;
+    }
+    if (gm_cli_bin_check_magic(ch) == 0)
+    {
+        return;
+    }
+#endif  /* GM_CLI_BIN_EN */
+
+    /* 过滤无效字符 */
+    if ((ch == (char)0x00) ||
+        (ch == (char)0xFF))
+    {
+        return;
+    }
+
+#if GM_CLI_BRACKETED_PASTE_EN
+    /* 粘贴模式，粘贴内容中的Ctrl-C等控制字符都是数据 */
+    if (gm_cli_mgr.paste_mode)
+    {
+        gm_cli_parse_paste_char(ch);
+        return;
+    }
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+
+#if GM_CLI_OUT_SCHED_EN
+    /* Ctrl-C */
+    if (ch == (char)0x03)
+    {
+        gm_cli_out_cancel();
+        return;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+
+#if GM_CLI_WATCH_EN
+    /* 前台周期命令运行时，任意按键停止，功能键照常处理，其它按键不作为输入 */
+    if ((gm_cli_watch_stop_fg() == 0) && (ch != (char)0x1B))
+    {
+        return;
+    }
+#endif  /* GM_CLI_WATCH_EN */
+
+    /* 功能码 */
+    if (gm_cli_parse_func_key(ch) == 0)
+    {
+        GM_CLI_TRACE(GM_CLI_TRACE_ESC, gm_cli_mgr.input_status);
+        return;
+    }
+
+    /* 字符解析 */
+    if (ch == '\t')
+    {
+        /* Tab */
+        GM_CLI_TRACE(GM_CLI_TRACE_TAB | GM_CLI_TRACE_BEGIN, 0);
+        gm_cli_parse_tab_key();
+        GM_CLI_TRACE(GM_CLI_TRACE_TAB | GM_CLI_TRACE_END, 0);
+    }
+    else if ((ch == (char)0x7F) || (ch == (char)0x08))
+    {
+        /* 退格 */
+        gm_cli_parse_backspace_key();
+    }
+    if ((ch == '\r') || (ch == '\n'))
+    {
+        /* 回车或换行 */
+        GM_CLI_TRACE(GM_CLI_TRACE_ENTER | GM_CLI_TRACE_BEGIN, 0);
+        gm_cli_parse_enter_key();
+        GM_CLI_TRACE(GM_CLI_TRACE_ENTER | GM_CLI_TRACE_END, 0);
+    }
+    else if ((ch >= ' ') && (ch <= '~'))
+    {
+        gm_cli_parse_common_char(ch);
+    }
+}
+
+#if GM_CLI_BUDGET_EN
+/* 命令执行期间预解析收到的字符，是中断键时请求中止 */
+int gm_cli_peek_char(const char ch)
+{
+#if GM_CLI_BRACKETED_PASTE_EN
+    static const char paste_begin[] = "\x1b[200~";
+    static const char paste_end[] = "\x1b[201~";
+    const char* p_seq;
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+
+    if (!gm_cli_atomic_load(&gm_cli_mgr.run_active)
+#if GM_CLI_BATCH_EN
+        && !gm_cli_atomic_load(&gm_cli_batch_active)
+#endif  /* GM_CLI_BATCH_EN */
+       )
+    {
+        return 0;
+    }
+#if GM_CLI_BIN_EN
+    /* 二进制帧模式下和进入二进制帧模式的序列中的字符都是帧数据 */
+    if (gm_cli_mgr.peek_bin)
+    {
+        return 0;
+    }
+    if ((unsigned char)ch == gm_cli_bin_magic[gm_cli_mgr.peek_bin_match])
+    {
+        if (++gm_cli_mgr.peek_bin_match == sizeof(gm_cli_bin_magic))
+        {
+            gm_cli_mgr.peek_bin = 1;
+        }
+        return 0;
+    }
+    gm_cli_mgr.peek_bin_match = ((unsigned char)ch == gm_cli_bin_magic[0]) ? 1 : 0;
+    if (gm_cli_mgr.peek_bin_match)
+    {
+        return 0;
+    }
+#endif  /* GM_CLI_BIN_EN */
+#if GM_CLI_BRACKETED_PASTE_EN
+    /* 跟踪粘贴开始和结束序列，粘贴的内容都是数据 */
+    p_seq = gm_cli_mgr.peek_paste ? paste_end : paste_begin;
+    if (ch == p_seq[gm_cli_mgr.peek_seq])
+    {
+        if (++gm_cli_mgr.peek_seq == sizeof(paste_begin) - 1)
+        {
+            gm_cli_mgr.peek_paste = !gm_cli_mgr.peek_paste;
+            gm_cli_mgr.peek_seq = 0;
+        }
+        return 0;
+    }
+    gm_cli_mgr.peek_seq = (ch == (char)0x1B) ? 1 : 0;
+    if (gm_cli_mgr.peek_paste)
+    {
+        return 0;
+    }
+#endif  /* GM_CLI_BRACKETED_PASTE_EN */
+    if (ch != (char)0x03)
+    {
+        return 0;
+    }
+    return (gm_cli_request_abort() == 0) ? 1 : 0;
+}
+#endif  /* GM_CLI_BUDGET_EN */
+
+/* 解析一个字符 */
+void gm_cli_parse_char(const char ch)
+{
+#if GM_CLI_OUT_SCHED_EN
+    unsigned int out_class = gm_cli_mgr.out_class;
+
+    /* 按键处理的输出为交互输出，执行的命令输出在gm_cli_exec中切换为批量输出 */
+    gm_cli_mgr.out_class = GM_CLI_OUT_INTERACTIVE;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    GM_CLI_TRACE(GM_CLI_TRACE_CHAR | GM_CLI_TRACE_BEGIN, (unsigned char)ch);
+#if GM_CLI_REC_EN
+    gm_cli_rec_put(GM_CLI_REC_IN, &ch, 1);
+#endif  /* GM_CLI_REC_EN */
+    gm_cli_parse_char_in(ch);
+    GM_CLI_TRACE(GM_CLI_TRACE_CHAR | GM_CLI_TRACE_END, 0);
+#if GM_CLI_OUT_SCHED_EN
+    gm_cli_mgr.out_class = out_class;
+#endif  /* GM_CLI_OUT_SCHED_EN */
+}
+
+#if GM_CLI_CMD_REG_BY_CC_SECTION
+/* 编译器命令导出方式可以防耦合，将函数声明为局部函数 */
+#define CMD_CB_CALL_PREFIX  static
+#else
+/* 静态注册方式需要导出默认命令函数，不能加static */
+#define CMD_CB_CALL_PREFIX
+#endif  /* GM_CLI_CMD_REG_BY_CC_SECTION */
+
+/* 内部命令-help */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_help(int argc, char* argv[])
+{
+    const gm_cli_cmd_t* p_temp;
+    const gm_cli_cmd_t* p_temp1;
+    int   found_flag = 0;
+
+    if (argc == 1)
+    {
+        p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+
+        gm_cli_put_str("System all command:\r\n");
+        while (p_temp != NULL)
+        {
+            gm_cli_put_str("    ");
+            gm_cli_put_str(p_temp->name);
+            if (p_temp->link != NULL)
+            {
+                gm_cli_put_str(" -> ");
+                p_temp1 = p_temp->link;
+                gm_cli_put_str(p_temp1->name);
+            }
+            gm_cli_put_str("\r\n");
+            p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+        }
+    }
+    else if (argc == 2)
+    {
+        p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+        found_flag = 0;
+        while (p_temp != NULL)
+        {
+            if (strcmp(p_temp->name, argv[1]) == 0)
+            {
+                gm_cli_put_str("command:");
+                gm_cli_put_str(p_temp->name);
+                if (p_temp->link != NULL)
+                {
+                    gm_cli_put_str(" -> ");
+                    p_temp = p_temp->link;
+                    gm_cli_put_str(p_temp->name);
+                }
+                gm_cli_put_str("\r\n  usage:");
+                gm_cli_put_str(p_temp->usage);
+                gm_cli_put_str("\r\n");
+                found_flag = 1;
+                break;
+            }
+            p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+        }
+        if (found_flag == 0)
+        {
+            gm_cli_put_not_found(argv[1]);
+        }
+    }
+    else
+    {
+        gm_cli_put_str("Too many args! Only support less then 2 args\r\n");
+    }
+
+    return 0;
+}
+/* 导出help命令 */
+GM_CLI_CMD_EXPORT(help,
+                  "help [cmd-name] -- list the command and usage",
+                  gm_cli_internal_cmd_help);
+/* 设置help的别名'?' */
+GM_CLI_CMD_ALIAS(help, "?");
+
+/* 内部命令-history */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_history(int argc, char* argv[])
+{
+    unsigned int i, count, num;
+
+    if (argc == 1)
+    {
+        num = gm_cli_mgr.history_total;
+    }
+    else if (argc == 2)
+    {
+        count = atoi(argv[1]);
+        if (gm_cli_mgr.history_total > count)
+        {
+            num = count;
+        }
+        else
+        {
+            num = gm_cli_mgr.history_total;
+        }
+    }
+    else
+    {
+        gm_cli_put_str("Too many args! Only support less then 2 args\r\n");
+        return 0;
+    }
+
+    for (i = 0, count = gm_cli_mgr.history_index; i < num; i++)
+    {
+        if (count == 0)
+        {
+            count = GM_CLI_HISTORY_LINE_MAX - 1;
+        }
+        else
+        {
+            count--;
+        }
+        gm_cli_put_str("    ");
+        gm_cli_history_put(count);
+        gm_cli_put_str("\r\n");
+    }
+
+    return 0;
+}
+/* 导出history命令 */
+GM_CLI_CMD_EXPORT(history,
+                  "history [num] -- list the history command",
+                  gm_cli_internal_cmd_history);
+
+/* 内部命令-test */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_test(int argc, char* argv[])
+{
+    gm_cli_printf("cmd  -> %s\r\n", argv[0]);
+    for (int i = 1; i < argc; i++)
+    {
+        gm_cli_printf("arg%d -> %s\r\n", i, argv[i]);
+    }
+    return 0;
+}
+/* 导出test命令 */
+GM_CLI_CMD_EXPORT(test,
+                  "test [args] -- test the cli",
+                  gm_cli_internal_cmd_test);
+
+#if GM_CLI_EMIT_EN
+/* 内部命令-format */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_format(int argc, char* argv[])
+{
+    unsigned int i;
+
+    if (argc == 1)
+    {
+        gm_cli_put_str(gm_cli_fmt_name[gm_cli_mgr.emit_fmt]);
+        gm_cli_put_str("\r\n");
+        return 0;
+    }
+    if (argc == 2)
+    {
+        for (i = 0; i < sizeof(gm_cli_fmt_name) / sizeof(gm_cli_fmt_name[0]); i++)
+        {
+            if (strcmp(argv[1], gm_cli_fmt_name[i]) == 0)
+            {
+                gm_cli_set_output_fmt((gm_cli_fmt_t)i);
+                return 0;
+            }
+        }
+    }
+    gm_cli_put_str("Usage: format [text|json|cbor]\r\n");
+    return -1;
+}
+/* 导出format命令 */
+GM_CLI_CMD_EXPORT(format,
+                  "format [text|json|cbor] -- show or set the structured output format",
+                  gm_cli_internal_cmd_format);
+#endif  /* GM_CLI_EMIT_EN */
+
+#if GM_CLI_CACHE_EN
+/* 内部命令-cache */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_cache(int argc, char* argv[])
+{
+    unsigned int i, used = 0;
+
+    if (argc == 1)
+    {
+        for (i = 0; i < GM_CLI_CACHE_ENTRY_NUM; i++)
+        {
+            if (gm_cli_cache[i].valid)
+            {
+                used++;
+            }
+        }
+        gm_cli_printf("hit: %lu\r\nmiss: %lu\r\nentries: %u/%u\r\n",
+                      gm_cli_mgr.cache_hit, gm_cli_mgr.cache_miss,
+                      used, (unsigned int)GM_CLI_CACHE_ENTRY_NUM);
+        return 0;
+    }
+    if ((argc <= 3) && (strcmp(argv[1], "clear") == 0))
+    {
+        gm_cli_cache_invalidate((argc == 3) ? argv[2] : NULL);
+        if (argc == 2)
+        {
+            gm_cli_mgr.cache_hit = 0;
+            gm_cli_mgr.cache_miss = 0;
+        }
+        return 0;
+    }
+    gm_cli_put_str("Usage: cache [clear [cmd]]\r\n");
+    return -1;
+}
+/* 导出cache命令 */
+GM_CLI_CMD_EXPORT(cache,
+                  "cache [clear [cmd]] -- show output cache statistics or clear the cache",
+                  gm_cli_internal_cmd_cache);
+#endif  /* GM_CLI_CACHE_EN */
+
+#if GM_CLI_WATCH_EN
+/* 内部命令-watch */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_watch(int argc, char* argv[])
+{
+    gm_cli_watch_t* p_watch = NULL;
+    const gm_cli_cmd_t* p_cmd;
+    unsigned long ms = 1000;
+    unsigned int flags = GM_CLI_WATCH_FLAG_FG, pos = 0, len, i;
+    char* p_end;
+    int n;
+
+    /* 列出全部周期命令 */
+    if (argc == 1)
+    {
+        for (i = 0; i < GM_CLI_WATCH_NUM; i++)
+        {
+            p_watch = &gm_cli_watch[i];
+            if (p_watch->p_cmd == NULL)
+            {
+                continue;
+            }
+            gm_cli_printf("[%u] %lums %s runs %lu:", i + 1,
+                          p_watch->interval * GM_CLI_WATCH_TICK_MS,
+                          (p_watch->flags & GM_CLI_WATCH_FLAG_FG) ? "fg" : "bg",
+                          p_watch->runs);
+            for (n = 0; n < p_watch->argc; n++)
+            {
+                gm_cli_put_char(' ');
+                gm_cli_put_str(p_watch->argv[n]);
+            }
+            gm_cli_put_str("\r\n");
+        }
+        return 0;
+    }
+
+    /* 停止周期命令，all表示全部 */
+    if ((argc == 3) && (strcmp(argv[1], "-k") == 0))
+    {
+        len = 0;
+        if (strcmp(argv[2], "all") != 0)
+        {
+            len = (unsigned int)strtoul(argv[2], &p_end, 10);
+            if ((*p_end != '\0') || (len == 0) || (len > GM_CLI_WATCH_NUM) ||
+                (gm_cli_watch[len - 1].p_cmd == NULL))
+            {
+                gm_cli_put_str("No such watch!\r\n");
+                return -1;
+            }
+        }
+        for (i = 0; i < GM_CLI_WATCH_NUM; i++)
+        {
+            if ((gm_cli_watch[i].p_cmd != NULL) && ((len == 0) || (len == i + 1)))
+            {
+                gm_cli_watch_kill(&gm_cli_watch[i]);
+            }
+        }
+        return 0;
+    }
+
+    for (n = 1; (n < argc) && (argv[n][0] == '-'); n++)
+    {
+        if ((strcmp(argv[n], "-n") == 0) && (n + 1 < argc))
+        {
+            ms = strtoul(argv[++n], &p_end, 10);
+            if ((*p_end != '\0') || (ms == 0))
+            {
+                break;
+            }
+        }
+        else if (strcmp(argv[n], "-r") == 0)
+        {
+            flags |= GM_CLI_WATCH_FLAG_REDRAW;
+        }
+        else if (strcmp(argv[n], "-b") == 0)
+        {
+            flags &= ~GM_CLI_WATCH_FLAG_FG;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if ((n >= argc) || (argv[n][0] == '-'))
+    {
+        gm_cli_put_str("Usage: watch [-n ms] [-r] [-b] cmd [args] or watch -k id|all\r\n");
+        return -1;
+    }
+
+    if (gm_cli_mgr.pf_tick == NULL)
+    {
+        gm_cli_put_str("No tick source, call gm_cli_set_tick_cb first!\r\n");
+        return -1;
+    }
+#if GM_CLI_BIN_EN
+    if (gm_cli_mgr.bin_mode)
+    {
+        gm_cli_put_str("Not supported in binary frame mode!\r\n");
+        return -1;
+    }
+#endif  /* GM_CLI_BIN_EN */
+
+    /* 命令只查找一次 */
+    p_cmd = gm_cli_search_cmd(argv[n]);
+    if (p_cmd == NULL)
+    {
+        gm_cli_put_not_found(argv[n]);
+        return -1;
+    }
+    if (p_cmd->link != NULL)
+    {
+        p_cmd = p_cmd->link;
+    }
+    if (p_cmd->cb == gm_cli_internal_cmd_watch)
+    {
+        gm_cli_put_str("Can not watch itself!\r\n");
+        return -1;
+    }
+    if (p_cmd->flags & GM_CLI_CMD_FLAG_MACRO)
+    {
+        gm_cli_put_str("Can not watch an alias!\r\n");
+        return -1;
+    }
+
+    for (i = 0; i < GM_CLI_WATCH_NUM; i++)
+    {
+        if (gm_cli_watch[i].p_cmd == NULL)
+        {
+            p_watch = &gm_cli_watch[i];
+            break;
+        }
+    }
+    if (p_watch == NULL)
+    {
+        gm_cli_put_str("Too many watches!\r\n");
+        return -1;
+    }
+
+    /* 参数复制一次，以后每次执行直接使用 */
+    for (p_watch->argc = 0; n < argc; n++)
+    {
+        len = (unsigned int)strlen(argv[n]) + 1;
+        if (pos + len > GM_CLI_WATCH_LINE_MAX)
+        {
+            gm_cli_put_str("Command too long!\r\n");
+            return -1;
+        }
+        memcpy(&p_watch->line[pos], argv[n], len);
+        p_watch->argv[p_watch->argc++] = &p_watch->line[pos];
+        pos += len;
+    }
+
+    if (gm_cli_mgr.watch_num == 0)
+    {
+        /* 时间轮从当前时间开始计时 */
+        gm_cli_mgr.wheel_ms = gm_cli_mgr.pf_tick();
+    }
+    gm_cli_mgr.watch_num++;
+    if (flags & GM_CLI_WATCH_FLAG_FG)
+    {
+        gm_cli_mgr.watch_fg_num++;
+    }
+    p_watch->p_cmd = p_cmd;
+    p_watch->flags = flags;
+    p_watch->runs = 0;
+    p_watch->lines = 0;
+    p_watch->interval = (ms + GM_CLI_WATCH_TICK_MS - 1) / GM_CLI_WATCH_TICK_MS;
+    /* 下一个节拍执行第一次 */
+    p_watch->expire = gm_cli_mgr.wheel_tick + 1;
+    gm_cli_watch_insert(p_watch);
+
+    if (!(flags & GM_CLI_WATCH_FLAG_FG))
+    {
+        gm_cli_printf("[%u]\r\n", i + 1);
+    }
+    return 0;
+}
+/* 导出watch命令 */
+GM_CLI_CMD_EXPORT(watch,
+                  "watch [-n ms] [-r] [-b] cmd [args] -- run cmd periodically, "
+                  "-r redraw in place, -b in background, watch -k id|all to stop",
+                  gm_cli_internal_cmd_watch);
+#endif  /* GM_CLI_WATCH_EN */
+
+#if GM_CLI_ALIAS_EN
+/* 内部命令-alias */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_alias(int argc, char* argv[])
+{
+    const gm_cli_cmd_t* p_cmd;
+    unsigned int i;
+
+    if (argc == 1)
+    {
+        for (i = 0; i < GM_CLI_ALIAS_NUM; i++)
+        {
+            if (gm_cli_alias[i].cmd.name != NULL)
+            {
+                gm_cli_alias_put(&gm_cli_alias[i]);
+                gm_cli_put_str("\r\n");
+            }
+        }
         return 0;
     }
-    else if (gm_cli_mgr.input_status == GM_CLI_INPUT_WAIT_FUNC_KEY1)
+    if (argc != 2)
     {
-        gm_cli_mgr.input_status = GM_CLI_INPUT_WAIT_NORMAL;
-        if (ch == (char)0x48)         /* 上 */
+        gm_cli_put_str("Usage: alias [name[='cmd [args][; cmd [args]]']]\r\n");
+        return -1;
+    }
+
+    /* 只有名字时显示定义 */
+    if (strchr(argv[1], '=') == NULL)
+    {
+        p_cmd = gm_cli_search_cmd(argv[1]);
+        if ((p_cmd == NULL) || !(p_cmd->flags & GM_CLI_CMD_FLAG_MACRO))
         {
-            gm_cli_parse_up_key();
-            return 0;
+            gm_cli_put_str("No such alias!\r\n");
+            return -1;
         }
-        else if (ch == (char)0x50)    /* 下 */
+        gm_cli_alias_put((const gm_cli_alias_t*)p_cmd);
+        gm_cli_put_str("\r\n");
+        return 0;
+    }
+
+    /* 执行中的别名参数在存储区中，不能修改 */
+    if (gm_cli_mgr.alias_running)
+    {
+        gm_cli_put_str("Can not change alias while running an alias!\r\n");
+        return -1;
+    }
+    return gm_cli_alias_define(argv[1]);
+}
+/* 导出alias命令 */
+GM_CLI_CMD_EXPORT(alias,
+                  "alias [name[='cmd [args][; cmd [args]]']] -- list, show or define an alias",
+                  gm_cli_internal_cmd_alias);
+
+/* 内部命令-unalias */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_unalias(int argc, char* argv[])
+{
+    const gm_cli_cmd_t* p_cmd;
+    unsigned int i;
+
+    if (argc != 2)
+    {
+        gm_cli_put_str("Usage: unalias name|-a\r\n");
+        return -1;
+    }
+    if (gm_cli_mgr.alias_running)
+    {
+        gm_cli_put_str("Can not change alias while running an alias!\r\n");
+        return -1;
+    }
+    if (strcmp(argv[1], "-a") == 0)
+    {
+        for (i = 0; i < GM_CLI_ALIAS_NUM; i++)
         {
-            gm_cli_parse_down_key();
-            return 0;
+            if (gm_cli_alias[i].cmd.name != NULL)
+            {
+                gm_cli_alias_del(&gm_cli_alias[i]);
+            }
         }
-        else if (ch == (char)0x4B)    /* 左 */
+        return 0;
+    }
+    p_cmd = gm_cli_search_cmd(argv[1]);
+    if ((p_cmd == NULL) || !(p_cmd->flags & GM_CLI_CMD_FLAG_MACRO))
+    {
+        gm_cli_put_str("No such alias!\r\n");
+        return -1;
+    }
+    gm_cli_alias_del((gm_cli_alias_t*)p_cmd);
+    return 0;
+}
+/* 导出unalias命令 */
+GM_CLI_CMD_EXPORT(unalias,
+                  "unalias name|-a -- remove an alias or all aliases",
+                  gm_cli_internal_cmd_unalias);
+#endif  /* GM_CLI_ALIAS_EN */
+
+#if GM_CLI_VAR_EN
+/* 内部命令-set */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_set(int argc, char* argv[])
+{
+    char value[GM_CLI_VAR_VALUE_MAX];
+    unsigned int len = 0, n;
+    unsigned int i;
+    int index;
+
+    if (argc == 1)
+    {
+        for (i = 0; i < GM_CLI_VAR_NUM; i++)
         {
-            gm_cli_parse_left_key();
-            return 0;
+            if (gm_cli_var[i].state == GM_CLI_VAR_USED)
+            {
+                gm_cli_var_put(&gm_cli_var[i]);
+                gm_cli_put_str("\r\n");
+            }
         }
-        else if (ch == (char)0x4D)    /* 右 */
+        return 0;
+    }
+
+    /* 只有名字时显示值 */
+    if (argc == 2)
+    {
+        index = gm_cli_var_find(argv[1], (unsigned int)strlen(argv[1]));
+        if (index < 0)
         {
-            gm_cli_parse_right_key();
-            return 0;
+            gm_cli_put_str("No such variable!\r\n");
+            return -1;
         }
+        gm_cli_put_buf(gm_cli_var[index].value, gm_cli_var[index].len);
+        gm_cli_put_str("\r\n");
+        return 0;
     }
-#endif  /* _MSC_VER */
-
-    return -1;
-}
 
-/* 判断字符串是否空，返回：0 - 空，-1 - 非空 */
-static int gm_cli_str_empty_check(const char* const str)
-{
-    const char* p_tmp = str;
-    while (*p_tmp)
+    /* 多个参数以空格连接为值 */
+    for (i = 2; i < (unsigned int)argc; i++)
     {
-        if ((*p_tmp) != ' ')
+        n = (unsigned int)strlen(argv[i]);
+        if (len + n + (i > 2) >= sizeof(value))
         {
+            gm_cli_put_str("Variable value too long!\r\n");
             return -1;
         }
-        p_tmp++;
+        if (i > 2)
+        {
+            value[len++] = ' ';
+        }
+        memcpy(&value[len], argv[i], n);
+        len += n;
     }
-    return 0;
+    value[len] = '\0';
+    return gm_cli_var_set(argv[1], value);
 }
+/* 导出set命令 */
+GM_CLI_CMD_EXPORT(set,
+                  "set [name [value]] -- list, show or set a variable, $name or ${name} is replaced",
+                  gm_cli_internal_cmd_set);
 
-/* 字符串匹配 */
-static int gm_cli_str_completion(const char* const str, const char* const substr)
+/* 内部命令-unset */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_unset(int argc, char* argv[])
 {
-    unsigned int len1 = (unsigned int)strlen(str);
-    unsigned int len2 = (unsigned int)strlen(substr);
-    unsigned int i = 0;
+    unsigned int i;
+    int index;
 
-    if (len2 > len1)
+    if (argc != 2)
     {
+        gm_cli_put_str("Usage: unset name|-a\r\n");
         return -1;
     }
-    for (i = 0; i < len2; i++)
+    if (strcmp(argv[1], "-a") == 0)
     {
-        if (str[i] != substr[i])
+        for (i = 0; i < GM_CLI_VAR_NUM; i++)
         {
-            return -1;
+            if (gm_cli_var[i].state == GM_CLI_VAR_USED)
+            {
+                gm_cli_var_del(&gm_cli_var[i]);
+            }
         }
+        return 0;
     }
+    index = gm_cli_var_find(argv[1], (unsigned int)strlen(argv[1]));
+    if (index < 0)
+    {
+        gm_cli_put_str("No such variable!\r\n");
+        return -1;
+    }
+    gm_cli_var_del(&gm_cli_var[index]);
     return 0;
 }
+/* 导出unset命令 */
+GM_CLI_CMD_EXPORT(unset,
+                  "unset name|-a -- remove a variable or all variables",
+                  gm_cli_internal_cmd_unset);
+#endif  /* GM_CLI_VAR_EN */
 
-/* 删除开头的空格 */
-static const char* gm_cli_delete_start_space(const char* const str)
+#if GM_CLI_LOOP_EN
+/* 丢弃输出的通道，循环命令-q时使用 */
+static void gm_cli_loop_null_write(gm_cli_sink_t* p_sink, const char* buf, unsigned int len)
 {
-    unsigned int i = 0;
-    unsigned int len = (unsigned int)strlen(str);
-    while ((str[i] == ' ') && (str[i] != '\0') && (i < len))
-    {
-        i++;
-    }
-    return (const char*)(str + i);
+    (void)p_sink;
+    (void)buf;
+    (void)len;
 }
 
-/* tab键处理 */
-static void gm_cli_parse_tab_key(void)
+/* 计数值换算为ns，cpms为每ms的计数，分两步计算避免溢出 */
+static unsigned long gm_cli_loop_ns(const unsigned long cycles, const unsigned long cpms)
 {
-    const gm_cli_cmd_t *p_temp, *p_find_first_cmd = NULL;
-    unsigned int find_count = 0, len;
-    const char *p_line_start;
+    unsigned long rem = (cycles % cpms) * 1000ul;
 
-    /* 检测是否是空白行 */
-    if (gm_cli_str_empty_check(gm_cli_mgr.line) == 0)
+    return (cycles / cpms) * 1000000ul + (rem / cpms) * 1000ul + ((rem % cpms) * 1000ul) / cpms;
+}
+
+/* 输出一个耗时，能换算时单位为us */
+static void gm_cli_loop_put_time(const unsigned long cycles, const unsigned long cpms)
+{
+    unsigned long ns;
+
+    if (cpms == 0)
     {
+        gm_cli_printf("%lu", cycles);
         return;
     }
+    ns = gm_cli_loop_ns(cycles, cpms);
+    gm_cli_printf("%lu.%03lu", ns / 1000ul, ns % 1000ul);
+}
 
-    /* 取消前面的空白 */
-    p_line_start = gm_cli_delete_start_space(gm_cli_mgr.line);
+/* 执行循环，循环体argv只分割和查找一次，p_var不为NULL时为for循环，循环变量从first开始
+ * 每次加step，引用变量的循环体每次按模板展开，输出执行速率和命令耗时，
+ * 返回：0 - 全部成功，-1 - 命令失败或被中止 */
+static int gm_cli_loop_run(const char* const p_var, long first, const long step, const unsigned long count,
+                           const int quiet, const int argc, char* argv[])
+{
+    gm_cli_sink_t null_sink = { gm_cli_loop_null_write, NULL };
+    char* args[GM_CLI_CMD_ARGS_NUM_MAX];
+    const gm_cli_cmd_t* p_cmd;
+    unsigned long runs = 0, start_ms = 0, ms = 0, cpms = 0;
+    unsigned long begin, cycles, lat, lat_min = ~0ul, lat_max = 0;
+    unsigned long long lat_total = 0;
+    int ret = 0, stop = 0;
+#if GM_CLI_VAR_EN
+    char buf[GM_CLI_LINE_CHAR_MAX];
+    char value[24];
+    gm_cli_tmpl_t tmpl;
+    int expand = 0;
+    unsigned long val;
+    unsigned int pos;
+#endif  /* GM_CLI_VAR_EN */
 
-    p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
+#if !GM_CLI_VAR_EN
+    (void)p_var;
+    (void)first;
+    (void)step;
+#endif  /* !GM_CLI_VAR_EN */
+    if (strchr(argv[0], '$') != NULL)
+    {
+        gm_cli_put_str("Command name can not be a variable!\r\n");
+        return -1;
+    }
+    p_cmd = gm_cli_search_cmd(argv[0]);
+    if (p_cmd == NULL)
+    {
+        gm_cli_put_not_found(argv[0]);
+        return -1;
+    }
+    if (p_cmd->link != NULL)
+    {
+        p_cmd = p_cmd->link;
+    }
 
-    /* 查询命令 */
-    while (p_temp != NULL)
+    if (gm_cli_mgr.pf_tick != NULL)
     {
-        if (gm_cli_str_completion(p_temp->name, p_line_start) == 0)
+        start_ms = gm_cli_mgr.pf_tick();
+    }
+    begin = (unsigned long)GM_CLI_TRACE_CYCLES();
+    while (runs < count)
+    {
+#if GM_CLI_VAR_EN
+        if (p_var != NULL)
         {
-            if (find_count == 0)
+            /* 循环变量转为十进制，删除过变量时模板展开时重新编译 */
+            val = (first < 0) ? (0ul - (unsigned long)first) : (unsigned long)first;
+            pos = sizeof(value) - 1;
+            value[pos] = '\0';
+            do
             {
-                p_find_first_cmd = p_temp;
+                value[--pos] = (char)('0' + val % 10);
+                val /= 10;
+            } while (val > 0);
+            if (first < 0)
+            {
+                value[--pos] = '-';
             }
-            else if (find_count == 1)
+            if (gm_cli_var_set(p_var, &value[pos]) != 0)
             {
-                gm_cli_put_str("\r\n");
-                gm_cli_put_str(p_find_first_cmd->name);
-                gm_cli_put_str("\r\n");
-                gm_cli_put_str(p_temp->name);
-                gm_cli_put_str("\r\n");
+                ret = -1;
+                break;
             }
-            else
+            first += step;
+        }
+        if (runs == 0)
+        {
+            /* 循环变量定义后再编译 */
+            if (gm_cli_tmpl_compile(&tmpl, argv, (unsigned int)argc, 1) != 0)
             {
-                gm_cli_put_str(p_temp->name);
-                gm_cli_put_str("\r\n");
+                ret = -1;
+                break;
             }
-            find_count++;
+            expand = gm_cli_tmpl_has_var(&tmpl);
+        }
+        if (expand)
+        {
+            if (gm_cli_tmpl_expand(&tmpl, buf, sizeof(buf), args) < 0)
+            {
+                ret = -1;
+                break;
+            }
+        }
+        else
+#endif  /* GM_CLI_VAR_EN */
+        {
+            /* 命令可能修改参数数组，使用副本 */
+            memcpy(args, argv, (unsigned int)argc * sizeof(args[0]));
         }
-        p_temp = gm_cli_get_next_cmd((const int*)p_temp);
-    }
 
-    if (find_count == 1)
-    {
-        /* 删除当前行内容 */
-        len = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
-        for (unsigned int i = 0; i < len; i++)
+        if (quiet)
+        {
+            null_sink.next = gm_cli_mgr.p_sink;
+            gm_cli_mgr.p_sink = &null_sink;
+        }
+        cycles = (unsigned long)GM_CLI_TRACE_CYCLES();
+#if GM_CLI_ALIAS_EN
+        if (p_cmd->flags & GM_CLI_CMD_FLAG_MACRO)
+        {
+            ret = gm_cli_alias_run(p_cmd, argc, args);
+        }
+        else
+#endif  /* GM_CLI_ALIAS_EN */
         {
-            gm_cli_put_char(' ');
+            ret = gm_cli_call_cmd(p_cmd, argc, args);
         }
-        for (unsigned int i = 0; i < gm_cli_mgr.input_count; i++)
+        lat = (unsigned long)GM_CLI_TRACE_CYCLES() - cycles;
+        if (quiet)
         {
-            gm_cli_put_str("\b \b");
+            gm_cli_mgr.p_sink = null_sink.next;
         }
 
-        /* 自动填充行 */
-        memset(gm_cli_mgr.line, '\0', sizeof(gm_cli_mgr.line));
-        memcpy(gm_cli_mgr.line, p_find_first_cmd->name, strlen(p_find_first_cmd->name));
-        /* 重新更新坐标 */
-        gm_cli_mgr.input_count = (unsigned int)strlen(gm_cli_mgr.line);
-        gm_cli_mgr.input_cusor = gm_cli_mgr.input_count;
-        /* 显示输入行 */
-        gm_cli_put_str(gm_cli_mgr.line);
+        runs++;
+        lat_total += lat;
+        lat_min = (lat < lat_min) ? lat : lat_min;
+        lat_max = (lat > lat_max) ? lat : lat_max;
+        if (ret != 0)
+        {
+            break;
+        }
+#if GM_CLI_BUDGET_EN
+        if (gm_cli_should_abort())
+        {
+            stop = 1;
+            break;
+        }
+#endif  /* GM_CLI_BUDGET_EN */
     }
-    else if (find_count > 1)
+    cycles = (unsigned long)GM_CLI_TRACE_CYCLES() - begin;
+    if (gm_cli_mgr.pf_tick != NULL)
     {
-        /* 显示提示符 */
-        gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
-        /* 重新更新坐标 */
-        gm_cli_mgr.input_count = (unsigned int)strlen(gm_cli_mgr.line);
-        gm_cli_mgr.input_cusor = gm_cli_mgr.input_count;
-        /* 显示输入行 */
-        gm_cli_put_str(gm_cli_mgr.line);
+        ms = gm_cli_mgr.pf_tick() - start_ms;
+        /* 用时基校准计数器，时间太短时误差大，直接输出计数值 */
+        if (ms >= 10)
+        {
+            cpms = cycles / ms;
+        }
+    }
+
+    if (runs == 0)
+    {
+        return -1;
+    }
+    if (ret != 0)
+    {
+        gm_cli_printf("Stopped at run %lu, return %d\r\n", runs, ret);
+    }
+    else if (stop)
+    {
+        gm_cli_printf("Stopped at run %lu, aborted\r\n", runs);
     }
+    gm_cli_printf("%lu runs", runs);
+    if (gm_cli_mgr.pf_tick != NULL)
+    {
+        gm_cli_printf(" in %lu ms", ms);
+        if (ms > 0)
+        {
+            gm_cli_printf(", %lu runs/s", (unsigned long)((unsigned long long)runs * 1000u / ms));
+        }
+    }
+    gm_cli_put_str(", latency min/avg/max ");
+    gm_cli_loop_put_time(lat_min, cpms);
+    gm_cli_put_char('/');
+    gm_cli_loop_put_time((unsigned long)(lat_total / runs), cpms);
+    gm_cli_put_char('/');
+    gm_cli_loop_put_time(lat_max, cpms);
+    gm_cli_printf(" %s\r\n", (cpms != 0) ? "us" : GM_CLI_TRACE_CLOCK_NAME);
+
+    return ((ret != 0) || stop) ? -1 : 0;
 }
 
-/* 退格键处理 */
-static void gm_cli_parse_backspace_key(void)
+/* 内部命令-repeat */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_repeat(int argc, char* argv[])
 {
-    int i, count;
+    unsigned long count;
+    char* p_end;
+    int n = 1;
 
-    if (gm_cli_mgr.input_cusor == 0)
+    if ((argc > 1) && (strcmp(argv[1], "-q") == 0))
     {
-        /* 未输入，直接跳过 */
-        return;
+        n++;
+    }
+    if (argc < n + 2)
+    {
+        gm_cli_put_str("Usage: repeat [-q] count cmd [args]\r\n");
+        return -1;
     }
+    count = strtoul(argv[n], &p_end, 10);
+    if ((*p_end != '\0') || (count == 0))
+    {
+        gm_cli_put_str("Invalid count!\r\n");
+        return -1;
+    }
+    return gm_cli_loop_run(NULL, 0, 0, count, n > 1, argc - n - 1, &argv[n + 1]);
+}
+/* 导出repeat命令 */
+GM_CLI_CMD_EXPORT_EX(repeat,
+                     "repeat [-q] count cmd [args] -- run cmd count times and report the rate "
+                     "and latency, -q drops the output",
+                     gm_cli_internal_cmd_repeat, GM_CLI_CMD_FLAG_RAW, 0);
 
-    /* 更新位置 */
-    gm_cli_mgr.input_cusor--;
-    gm_cli_mgr.input_count--;
+#if GM_CLI_VAR_EN
+/* 内部命令-for */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_for(int argc, char* argv[])
+{
+    long first, last;
+    char* p_end;
+    int n = 1;
 
-    if (gm_cli_mgr.input_cusor == gm_cli_mgr.input_count)
+    if ((argc > 1) && (strcmp(argv[1], "-q") == 0))
     {
-        /* 末尾置0 */
-        gm_cli_mgr.line[gm_cli_mgr.input_count] = '\0';
-        /* 光标在最后 */
-        gm_cli_put_str("\b \b");
+        n++;
     }
-    else
+    if ((argc < n + 4) || (strcmp(argv[n + 1], "in") != 0))
     {
-        /* 计算需要搬移的字符数 */
-        count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
-        /* 搬移 */
-        for (i = 0; i < count; i++)
-        {
-            gm_cli_mgr.line[gm_cli_mgr.input_cusor + i] = gm_cli_mgr.line[gm_cli_mgr.input_cusor + i + 1];
-        }
-        /* 末尾置0 */
-        gm_cli_mgr.line[gm_cli_mgr.input_count] = '\0';
-        /* 重新刷新显示 */
-        gm_cli_put_char('\b');
-        gm_cli_put_str(&gm_cli_mgr.line[gm_cli_mgr.input_cusor]);
-        gm_cli_put_str(" \b");
-        /* 光标回位 */
-        for (i = 0; i < count; i++)
-        {
-            gm_cli_put_char('\b');
-        }
+        gm_cli_put_str("Usage: for [-q] var in first..last cmd [args with $var]\r\n");
+        return -1;
+    }
+    first = strtol(argv[n + 2], &p_end, 10);
+    if ((p_end == argv[n + 2]) || (strncmp(p_end, "..", 2) != 0))
+    {
+        gm_cli_put_str("Invalid range! Usage: first..last\r\n");
+        return -1;
+    }
+    argv[n + 2] = p_end + 2;
+    last = strtol(argv[n + 2], &p_end, 10);
+    if ((p_end == argv[n + 2]) || (*p_end != '\0'))
+    {
+        gm_cli_put_str("Invalid range! Usage: first..last\r\n");
+        return -1;
+    }
+    /* 先检查变量名，循环中不再重复提示 */
+    if ((gm_cli_var_name_len(argv[n]) == 0) || (argv[n][gm_cli_var_name_len(argv[n])] != '\0'))
+    {
+        gm_cli_put_str("Invalid variable name!\r\n");
+        return -1;
+    }
+    if (first <= last)
+    {
+        return gm_cli_loop_run(argv[n], first, 1, (unsigned long)(last - first) + 1,
+                               n > 1, argc - n - 3, &argv[n + 3]);
     }
+    return gm_cli_loop_run(argv[n], first, -1, (unsigned long)(first - last) + 1,
+                           n > 1, argc - n - 3, &argv[n + 3]);
 }
+/* 导出for命令 */
+GM_CLI_CMD_EXPORT_EX(for,
+                     "for [-q] var in first..last cmd [args with $var] -- run cmd for each value "
+                     "and report the rate and latency, -q drops the output",
+                     gm_cli_internal_cmd_for, GM_CLI_CMD_FLAG_RAW, 0);
+#endif  /* GM_CLI_VAR_EN */
+#endif  /* GM_CLI_LOOP_EN */
 
-/* 回车换行键处理 */
-static void gm_cli_parse_enter_key(void)
+#if GM_CLI_PLUGIN_EN
+/* 内部命令-plugin */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_plugin(int argc, char* argv[])
 {
     unsigned int i;
-    int argc = 0;
-    char* argv[GM_CLI_CMD_ARGS_NUM_MAX];
-    const gm_cli_cmd_t* p_cmd;
 
-    /* 回车，处理命令时可能有输出 */
-    gm_cli_put_str("\r\n");
+    if (argc == 1)
+    {
+        for (i = 0; i < GM_CLI_PLUGIN_NUM; i++)
+        {
+            if (gm_cli_plugin[i].handle != NULL)
+            {
+                gm_cli_printf("[%u] %s: %u commands\r\n", i + 1, gm_cli_plugin[i].path,
+                              (unsigned int)(gm_cli_plugin[i].p_end - gm_cli_plugin[i].p_start));
+            }
+        }
+        return 0;
+    }
+    if ((argc == 3) && (strcmp(argv[1], "load") == 0))
+    {
+        return gm_cli_plugin_load(argv[2]);
+    }
+    if ((argc == 3) && (strcmp(argv[1], "unload") == 0))
+    {
+        return gm_cli_plugin_unload(argv[2]);
+    }
+    gm_cli_put_str("Usage: plugin [load path | unload id|path]\r\n");
+    return -1;
+}
+/* 导出plugin命令 */
+GM_CLI_CMD_EXPORT(plugin,
+                  "plugin [load path | unload id|path] -- load or unload command plugins, "
+                  "list them without arguments",
+                  gm_cli_internal_cmd_plugin);
+#endif  /* GM_CLI_PLUGIN_EN */
+
+#if GM_CLI_MEM_EN
+/* 解析内存命令的宽度选项和数值参数，宽度默认为字，返回数值参数个数，-1为参数错误 */
+static int gm_cli_mem_parse_args(int argc, char* argv[], unsigned int* const p_width,
+                                 uintptr_t val[], const int max)
+{
+    unsigned long long num;
+    char* p_end;
+    int n = 1, i;
 
-    if (gm_cli_mgr.input_count > 0)
+    *p_width = 4;
+    if ((argc > 1) && (argv[1][0] == '-'))
     {
-        /* 备份进入历史记录 */
-        memcpy(gm_cli_mgr.history_str[gm_cli_mgr.history_index++], gm_cli_mgr.line, sizeof(gm_cli_mgr.line));
-        gm_cli_mgr.history_index %= GM_CLI_HISTORY_LINE_MAX;
-        if (gm_cli_mgr.history_total < GM_CLI_HISTORY_LINE_MAX)
+        if ((argv[1][1] == '\0') || (argv[1][2] != '\0'))
         {
-            gm_cli_mgr.history_total++;
+            return -1;
         }
-        gm_cli_mgr.history_inquire_index = 0;
-        gm_cli_mgr.history_inquire_count = 0;
-
-        /* 分析字符串 */
-        for (i = 0; i < gm_cli_mgr.input_count;)
+        switch (argv[1][1])
         {
-            /* 跳过空格并替换为0 */
-            while ((gm_cli_mgr.line[i] == ' ') && (i < gm_cli_mgr.input_count))
-            {
-                gm_cli_mgr.line[i++] = '\0';
-            }
-            if (i >= gm_cli_mgr.input_count)
-            {
-                break;
-            }
-
-            if (argc >= GM_CLI_CMD_ARGS_NUM_MAX)
-            {
-                gm_cli_put_str("Too many args! Line will replace follow:\r\n  < ");
-                for (int j = 0; j < argc; j++)
-                {
-                    gm_cli_put_str(argv[j]);
-                    gm_cli_put_char(' ');
-                }
-                gm_cli_put_str(">\r\n");
-                break;
-            }
-
-            argv[argc++] = &gm_cli_mgr.line[i];
-            /* 跳过中间的字符串 */
-            while ((gm_cli_mgr.line[i] != ' ') && (i < gm_cli_mgr.input_count))
-            {
-                i++;
-            }
-            if (i >= gm_cli_mgr.input_count)
-            {
-                break;
-            }
+        case 'b':
+            *p_width = 1;
+            break;
+        case 'h':
+            *p_width = 2;
+            break;
+        case 'w':
+            *p_width = 4;
+            break;
+        default:
+            return -1;
         }
-
-        if (argc > 0)
+        n++;
+    }
+    for (i = 0; n < argc; n++, i++)
+    {
+        if ((i >= max) || (argv[n][0] == '-'))
         {
-            p_cmd = gm_cli_search_cmd(argv[0]);
-            if (p_cmd != NULL)
-            {
-                if (p_cmd->link != NULL)
-                {
-                    p_cmd = p_cmd->link;
-                }
-                if (p_cmd->cb)
-                {
-                    p_cmd->cb(argc, argv);
-                }
-            }
-            else
-            {
-                gm_cli_put_str("Not found command \"");
-                gm_cli_put_str(argv[0]);
-                gm_cli_put_str("\"\r\n");
-            }
+            return -1;
+        }
+        num = strtoull(argv[n], &p_end, 0);
+        if ((p_end == argv[n]) || (*p_end != '\0') || ((uintptr_t)num != num))
+        {
+            return -1;
         }
+        val[i] = (uintptr_t)num;
     }
+    return i;
+}
 
-    /* 清空行，为下一次输入准备 */
-    gm_cli_put_str(gm_cli_mgr.p_cmd_notice);
-    memset(gm_cli_mgr.line, 0, sizeof(gm_cli_mgr.line));
-    gm_cli_mgr.input_cusor = gm_cli_mgr.input_count = 0;
+/* 检查地址按宽度对齐，长度按宽度向上取整后不超出地址空间，返回：0 - 合法，-1 - 不合法 */
+static int gm_cli_mem_check(const uintptr_t addr, uintptr_t* const p_len, const unsigned int width)
+{
+    if (addr & (width - 1))
+    {
+        gm_cli_put_str("Unaligned address!\r\n");
+        return -1;
+    }
+    *p_len = (*p_len + width - 1) & ~(uintptr_t)(width - 1);
+    if ((*p_len == 0) || (*p_len - 1 > (uintptr_t)-1 - addr))
+    {
+        gm_cli_put_str("Invalid length!\r\n");
+        return -1;
+    }
+    return 0;
 }
 
-/* 通用可显示字符处理 */
-static void gm_cli_parse_common_char(const char ch)
+/* 内部命令-md */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_md(int argc, char* argv[])
 {
-    int i, count;
+    uintptr_t val[2] = { 0, 64 };
+    unsigned int width;
+    int num = gm_cli_mem_parse_args(argc, argv, &width, val, 2);
 
-    if (gm_cli_mgr.input_count > (GM_CLI_LINE_CHAR_MAX - 1))
+    if (num < 1)
     {
-        return;
+        gm_cli_put_str("Usage: md [-b|-h|-w] addr [len]\r\n");
+        return -1;
     }
-    if (gm_cli_mgr.input_cusor == gm_cli_mgr.input_count)
+    if (gm_cli_mem_check(val[0], &val[1], width) != 0)
     {
-        /* 光标在最后 */
-        gm_cli_mgr.line[gm_cli_mgr.input_cusor++] = ch;
-        gm_cli_mgr.input_count++;
-        gm_cli_put_char(ch);
+        return -1;
     }
-    else
+#if GM_CLI_OUT_SCHED_EN
+    /* 直接输出到终端时只输出第一块，剩余的由gm_cli_poll按发送进度继续输出 */
+    if (gm_cli_mgr.p_sink == &gm_cli_mgr.term_sink)
     {
-        /* 光标不在最后，计算需要搬移的字符数 */
-        count = gm_cli_mgr.input_count - gm_cli_mgr.input_cusor;
-        /* 搬移 */
-        for (i = count; i > 0; i--)
+        gm_cli_mem_flush();
+        gm_cli_mem_dump_chunk(&val[0], &val[1], width);
+        if (val[1] > 0)
         {
-            gm_cli_mgr.line[gm_cli_mgr.input_cusor + i] = gm_cli_mgr.line[gm_cli_mgr.input_cusor + i - 1];
+            gm_cli_mgr.mem_addr = val[0];
+            gm_cli_mgr.mem_left = val[1];
+            gm_cli_mgr.mem_width = width;
         }
-        gm_cli_mgr.line[gm_cli_mgr.input_cusor] = ch;
-        gm_cli_put_char(ch);
-        gm_cli_mgr.input_count++;
-        gm_cli_mgr.input_cusor++;
-        gm_cli_put_str(&gm_cli_mgr.line[gm_cli_mgr.input_cusor]);
-        /* 光标回位 */
-        for (i = 0; i < count; i++)
+        return 0;
+    }
+#endif  /* GM_CLI_OUT_SCHED_EN */
+    while (val[1] > 0)
+    {
+        gm_cli_mem_dump_chunk(&val[0], &val[1], width);
+#if GM_CLI_BUDGET_EN
+        if ((val[1] > 0) && gm_cli_should_abort())
         {
-            gm_cli_put_char('\b');
+            return -1;
         }
+#endif  /* GM_CLI_BUDGET_EN */
     }
+    return 0;
 }
+/* 导出md命令 */
+GM_CLI_CMD_EXPORT(md,
+                  "md [-b|-h|-w] addr [len] -- dump len bytes of memory (default 64) "
+                  "as bytes, halfwords or words (default)",
+                  gm_cli_internal_cmd_md);
 
-/* 解析一个字符 */
-void gm_cli_parse_char(const char ch)
+/* 内部命令-mw */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_mw(int argc, char* argv[])
 {
-    /* 过滤无效字符 */
-    if ((ch == (char)0x00) ||
-        (ch == (char)0xFF))
+    uintptr_t val[3] = { 0, 0, 1 };
+    unsigned int width;
+    int num = gm_cli_mem_parse_args(argc, argv, &width, val, 3);
+
+    if (num < 2)
     {
-        return;
+        gm_cli_put_str("Usage: mw [-b|-h|-w] addr value [count]\r\n");
+        return -1;
     }
-
-    /* 功能码 */
-    if (gm_cli_parse_func_key(ch) == 0)
+    if ((width < sizeof(val[1])) && (val[1] >> (width * 8)))
     {
-        return;
+        gm_cli_put_str("Value too large!\r\n");
+        return -1;
     }
-
-    /* 字符解析 */
-    if (ch == '\t')
+    if (val[2] > (uintptr_t)-1 / width)
     {
-        /* Tab */
-        gm_cli_parse_tab_key();
+        gm_cli_put_str("Invalid length!\r\n");
+        return -1;
     }
-    else if ((ch == (char)0x7F) || (ch == (char)0x08))
+    val[2] *= width;
+    if (gm_cli_mem_check(val[0], &val[2], width) != 0)
     {
-        /* 退格 */
-        gm_cli_parse_backspace_key();
+        return -1;
     }
-    if ((ch == '\r') || (ch == '\n'))
+    while (val[2] > 0)
     {
-        /* 回车或换行 */
-        gm_cli_parse_enter_key();
+        gm_cli_mem_store(val[0], width, (uint32_t)val[1]);
+        val[0] += width;
+        val[2] -= width;
+#if GM_CLI_BUDGET_EN
+        if (((val[2] % (GM_CLI_MEM_CHUNK_ROWS * 16u)) == 0) && (val[2] > 0) &&
+            gm_cli_should_abort())
+        {
+            return -1;
+        }
+#endif  /* GM_CLI_BUDGET_EN */
     }
-    else if ((ch >= ' ') && (ch <= '~'))
+    return 0;
+}
+/* 导出mw命令 */
+GM_CLI_CMD_EXPORT(mw,
+                  "mw [-b|-h|-w] addr value [count] -- write value to count bytes, "
+                  "halfwords or words (default) of memory",
+                  gm_cli_internal_cmd_mw);
+
+/* 内部命令-mcmp */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_mcmp(int argc, char* argv[])
+{
+    static const char* const unit_name[] = { "bytes", "halfwords", "", "words" };
+    uintptr_t val[3], pos, len;
+    unsigned long diff = 0;
+    uint32_t v1, v2;
+    unsigned int width, n;
+    char buf[sizeof(void*) * 4 + 16 + 8];
+    int num = gm_cli_mem_parse_args(argc, argv, &width, val, 3);
+
+    if (num != 3)
     {
-        gm_cli_parse_common_char(ch);
+        gm_cli_put_str("Usage: mcmp [-b|-h|-w] addr1 addr2 len\r\n");
+        return -1;
+    }
+    len = val[2];
+    if ((gm_cli_mem_check(val[0], &len, width) != 0) ||
+        (gm_cli_mem_check(val[1], &val[2], width) != 0))
+    {
+        return -1;
+    }
+    for (pos = 0; pos < len; pos += width)
+    {
+        v1 = gm_cli_mem_load(val[0] + pos, width, NULL);
+        v2 = gm_cli_mem_load(val[1] + pos, width, NULL);
+        if ((v1 != v2) && (++diff <= GM_CLI_MEM_DIFF_MAX))
+        {
+            /* addr1: v1 != addr2: v2，一次写入输出通道 */
+            n = gm_cli_mem_hex(buf, val[0] + pos, sizeof(void*));
+            buf[n++] = ':';
+            buf[n++] = ' ';
+            n += gm_cli_mem_hex(&buf[n], v1, width);
+            memcpy(&buf[n], " != ", 4);
+            n += 4;
+            n += gm_cli_mem_hex(&buf[n], val[1] + pos, sizeof(void*));
+            buf[n++] = ':';
+            buf[n++] = ' ';
+            n += gm_cli_mem_hex(&buf[n], v2, width);
+            buf[n++] = '\r';
+            buf[n++] = '\n';
+            gm_cli_put_buf(buf, n);
+        }
+#if GM_CLI_BUDGET_EN
+        if ((((pos + width) % (GM_CLI_MEM_CHUNK_ROWS * 16u)) == 0) && (pos + width < len) &&
+            gm_cli_should_abort())
+        {
+            return -1;
+        }
+#endif  /* GM_CLI_BUDGET_EN */
     }
+    gm_cli_printf("%lu of %lu %s differ\r\n", diff, (unsigned long)(len / width),
+                  unit_name[width - 1]);
+    return (diff > 0) ? -1 : 0;
 }
+/* 导出mcmp命令 */
+GM_CLI_CMD_EXPORT(mcmp,
+                  "mcmp [-b|-h|-w] addr1 addr2 len -- compare len bytes of memory as bytes, "
+                  "halfwords or words (default) and list the differences",
+                  gm_cli_internal_cmd_mcmp);
+#endif  /* GM_CLI_MEM_EN */
 
-#if GM_CLI_CMD_REG_BY_CC_SECTION
-/* 编译器命令导出方式可以防耦合，将函数声明为局部函数 */
-#define CMD_CB_CALL_PREFIX  static
-#else
-/* 静态注册方式需要导出默认命令函数，不能加static */
-#define CMD_CB_CALL_PREFIX
-#endif  /* GM_CLI_CMD_REG_BY_CC_SECTION */
+#if GM_CLI_CALL_EN
+/* call最多传入的参数个数，和gm_cli_call_fn_t一致 */
+#define GM_CLI_CALL_ARGS_MAX        6
 
-/* 内部命令-help */
-CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_help(int argc, char* argv[])
+/* call调用函数的类型，参数和返回值都按机器字传递，整数和指针参数都适用，
+ * 参数由调用者清理，函数实际的参数比传入的少时多余的参数不影响函数 */
+typedef uintptr_t gm_cli_call_fn_t(uintptr_t, uintptr_t, uintptr_t, uintptr_t, uintptr_t, uintptr_t);
+
+/* 内部命令-call */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_call(int argc, char* argv[])
 {
-    const gm_cli_cmd_t* p_temp;
-    const gm_cli_cmd_t* p_temp1;
-    int   found_flag = 0;
+    uintptr_t arg[GM_CLI_CALL_ARGS_MAX] = { 0 };
+    const gm_cli_sym_t* p_sym;
+    const gm_cli_sym_t* p_ref;
+    unsigned long begin, cycles;
+    unsigned int i, len;
+    uintptr_t ret;
+    char* p_end;
+    int n;
 
-    if (argc == 1)
+    /* 列出符号，有前缀时在排序的符号表中从第一个匹配处开始 */
+    if ((argc >= 2) && (argc <= 3) && (strcmp(argv[1], "-l") == 0))
     {
-        p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
-
-        gm_cli_put_str("System all command:\r\n");
-        while (p_temp != NULL)
+        len = (argc == 3) ? (unsigned int)strlen(argv[2]) : 0;
+        for (i = (argc == 3) ? gm_cli_sym_lower_bound(argv[2]) : 0; i < gm_cli_mgr.sym_num; i++)
         {
-            gm_cli_put_str("    ");
-            gm_cli_put_str(p_temp->name);
-            if (p_temp->link != NULL)
+            p_sym = &gm_cli_mgr.p_sym_table[i];
+            if ((len > 0) && (strncmp(p_sym->name, argv[2], len) != 0))
             {
-                gm_cli_put_str(" -> ");
-                p_temp1 = p_temp->link;
-                gm_cli_put_str(p_temp1->name);
+                break;
             }
-            gm_cli_put_str("\r\n");
-            p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+            gm_cli_printf("0x%lx  %s\r\n", (unsigned long)(uintptr_t)p_sym->addr,
+                          (p_sym->sig != NULL) ? p_sym->sig : p_sym->name);
         }
+        return 0;
     }
-    else if (argc == 2)
+    if ((argc < 2) || (argv[1][0] == '-') || (argc - 2 > GM_CLI_CALL_ARGS_MAX))
     {
-        p_temp = (gm_cli_cmd_t*)gm_cli_mgr.p_cmd_start;
-        found_flag = 0;
-        while (p_temp != NULL)
+        gm_cli_put_str("Usage: call func [args] or call -l [prefix]\r\n");
+        return -1;
+    }
+    p_sym = gm_cli_sym_find(argv[1]);
+    if (p_sym == NULL)
+    {
+        gm_cli_printf("No such function: %s\r\n", argv[1]);
+        return -1;
+    }
+
+    /* 参数依次按符号地址、整数和字符串指针转换 */
+    for (n = 2; n < argc; n++)
+    {
+        if (argv[n][0] == '&')
         {
-            if (strcmp(p_temp->name, argv[1]) == 0)
+            p_ref = gm_cli_sym_find(&argv[n][1]);
+            if (p_ref == NULL)
             {
-                gm_cli_put_str("command:");
-                gm_cli_put_str(p_temp->name);
-                if (p_temp->link != NULL)
-                {
-                    gm_cli_put_str(" -> ");
-                    p_temp = p_temp->link;
-                    gm_cli_put_str(p_temp->name);
-                }
-                gm_cli_put_str("\r\n  usage:");
-                gm_cli_put_str(p_temp->usage);
-                gm_cli_put_str("\r\n");
-                found_flag = 1;
-                break;
+                gm_cli_printf("No such function: %s\r\n", &argv[n][1]);
+                return -1;
             }
-            p_temp = gm_cli_get_next_cmd((const int*)p_temp);
+            arg[n - 2] = (uintptr_t)p_ref->addr;
+            continue;
         }
-        if (found_flag == 0)
+        if (argv[n][0] == '-')
         {
-            gm_cli_put_str("Not found command \"");
-            gm_cli_put_str(argv[1]);
-            gm_cli_put_str("\"\r\n");
+            arg[n - 2] = (uintptr_t)strtoll(argv[n], &p_end, 0);
+        }
+        else
+        {
+            arg[n - 2] = (uintptr_t)strtoull(argv[n], &p_end, 0);
+        }
+        if ((p_end == argv[n]) || (*p_end != '\0'))
+        {
+            arg[n - 2] = (uintptr_t)argv[n];
         }
     }
+
+    begin = (unsigned long)GM_CLI_TRACE_CYCLES();
+    ret = ((gm_cli_call_fn_t*)p_sym->addr)(arg[0], arg[1], arg[2], arg[3], arg[4], arg[5]);
+    cycles = (unsigned long)GM_CLI_TRACE_CYCLES() - begin;
+
+    /* 原型为void的函数没有返回值，返回int的函数只有低位有效 */
+    if ((p_sym->sig != NULL) && (strncmp(p_sym->sig, "void ", 5) == 0))
+    {
+        gm_cli_printf("%s returned in %lu %s\r\n", p_sym->name, cycles, GM_CLI_TRACE_CLOCK_NAME);
+    }
     else
     {
-        gm_cli_put_str("Too many args! Only support less then 2 args\r\n");
+        if ((p_sym->sig != NULL) && (strncmp(p_sym->sig, "int ", 4) == 0))
+        {
+            ret = (uintptr_t)(long)(int)ret;
+        }
+        gm_cli_printf("%s returned %ld (0x%lx) in %lu %s\r\n", p_sym->name, (long)ret,
+                      (unsigned long)ret, cycles, GM_CLI_TRACE_CLOCK_NAME);
     }
-
     return 0;
 }
-/* 导出help命令 */
-GM_CLI_CMD_EXPORT(help,
-                  "help [cmd-name] -- list the command and usage",
-                  gm_cli_internal_cmd_help);
-/* 设置help的别名'?' */
-GM_CLI_CMD_ALIAS(help, "?");
+/* 导出call命令 */
+GM_CLI_CMD_EXPORT(call,
+                  "call func [args] -- call a function from the symbol table with integer, "
+                  "&func or string arguments and time it, call -l [prefix] to list functions",
+                  gm_cli_internal_cmd_call);
+#endif  /* GM_CLI_CALL_EN */
 
-/* 内部命令-history */
-CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_history(int argc, char* argv[])
+#if GM_CLI_TRACE_EN
+/* 内部命令-trace */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_trace(int argc, char* argv[])
 {
-    unsigned int i, count, num;
+    const gm_cli_trace_event_t* p_event;
+    unsigned int pos, num, code;
+    int on = gm_cli_mgr.trace_on;
 
+    num = (gm_cli_mgr.trace_pos < GM_CLI_TRACE_NUM) ? gm_cli_mgr.trace_pos : GM_CLI_TRACE_NUM;
     if (argc == 1)
     {
-        num = gm_cli_mgr.history_total;
+        gm_cli_printf("%s, %u/%u events, clock %s\r\n", on ? "on" : "off",
+                      num, (unsigned int)GM_CLI_TRACE_NUM, GM_CLI_TRACE_CLOCK_NAME);
+        return 0;
     }
-    else if (argc == 2)
+    if (argc == 2)
     {
-        count = atoi(argv[1]);
-        if (gm_cli_mgr.history_total > count)
+        if (strcmp(argv[1], "on") == 0)
         {
-            num = count;
+            gm_cli_mgr.trace_on = 1;
+            return 0;
         }
-        else
+        if (strcmp(argv[1], "off") == 0)
         {
-            num = gm_cli_mgr.history_total;
+            gm_cli_mgr.trace_on = 0;
+            return 0;
         }
-    }
-    else
-    {
-        gm_cli_put_str("Too many args! Only support less then 2 args\r\n");
-        return 0;
-    }
-
-    for (i = 0, count = gm_cli_mgr.history_index; i < num; i++)
-    {
-        if (count == 0)
+        if (strcmp(argv[1], "clear") == 0)
         {
-            count = GM_CLI_HISTORY_LINE_MAX - 1;
+            gm_cli_mgr.trace_pos = 0;
+            return 0;
         }
-        else
+        if (strcmp(argv[1], "dump") == 0)
         {
-            count--;
+            /* 输出过程中不记录，避免覆盖正在输出的事件 */
+            gm_cli_mgr.trace_on = 0;
+            gm_cli_printf("# gm_cli trace %u events, clock %s\r\n", num, GM_CLI_TRACE_CLOCK_NAME);
+            for (pos = gm_cli_mgr.trace_pos - num; pos != gm_cli_mgr.trace_pos; pos++)
+            {
+                p_event = &gm_cli_trace_ring[pos & (GM_CLI_TRACE_NUM - 1)];
+                code = p_event->id & ~(GM_CLI_TRACE_BEGIN | GM_CLI_TRACE_END);
+                gm_cli_printf("%lu %c %s %u\r\n", (unsigned long)p_event->ts,
+                              (p_event->id & GM_CLI_TRACE_BEGIN) ? 'B' :
+                              ((p_event->id & GM_CLI_TRACE_END) ? 'E' : 'I'),
+                              (code < sizeof(gm_cli_trace_name) / sizeof(gm_cli_trace_name[0])) ?
+                              gm_cli_trace_name[code] : "?",
+                              (unsigned int)p_event->arg);
+            }
+            gm_cli_mgr.trace_on = on;
+            return 0;
         }
-        gm_cli_put_str("    ");
-        gm_cli_put_str(gm_cli_mgr.history_str[count]);
-        gm_cli_put_str("\r\n");
     }
-
-    return 0;
+    gm_cli_put_str("Usage: trace [on|off|clear|dump]\r\n");
+    return -1;
 }
-/* 导出history命令 */
-GM_CLI_CMD_EXPORT(history,
-                  "history [num] -- list the history command",
-                  gm_cli_internal_cmd_history);
+/* 导出trace命令 */
+GM_CLI_CMD_EXPORT(trace,
+                  "trace [on|off|clear|dump] -- show, control or dump the internal trace ring",
+                  gm_cli_internal_cmd_trace);
+#endif  /* GM_CLI_TRACE_EN */
 
-/* 内部命令-test */
-CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_test(int argc, char* argv[])
+#if GM_CLI_BUDGET_EN
+/* 内部命令-wdog，查看或清除命令执行时间统计 */
+CMD_CB_CALL_PREFIX int gm_cli_internal_cmd_wdog(int argc, char* argv[])
 {
-    gm_cli_printf("cmd  -> %s\r\n", argv[0]);
-    for (int i = 1; i < argc; i++)
+    if (argc == 1)
     {
-        gm_cli_printf("arg%d -> %s\r\n", i, argv[i]);
+        gm_cli_printf("Default budget: %u ms\r\n", (unsigned int)GM_CLI_CMD_BUDGET_MS);
+        gm_cli_printf("Overruns: %lu, aborts: %lu, longest run: %lu ms\r\n",
+                      gm_cli_mgr.wdog_overruns, gm_cli_mgr.wdog_aborts, gm_cli_mgr.wdog_max_ms);
+        if (gm_cli_mgr.wdog_last_name[0] != '\0')
+        {
+            gm_cli_printf("Last overrun: \"%s\" %lu/%lu ms\r\n", gm_cli_mgr.wdog_last_name,
+                          gm_cli_mgr.wdog_last_ms, gm_cli_mgr.wdog_last_budget);
+        }
+        return 0;
     }
-    return 0;
+    if ((argc == 2) && (strcmp(argv[1], "clear") == 0))
+    {
+        gm_cli_mgr.wdog_overruns = 0;
+        gm_cli_mgr.wdog_aborts = 0;
+        gm_cli_mgr.wdog_max_ms = 0;
+        gm_cli_mgr.wdog_last_name[0] = '\0';
+        return 0;
+    }
+    gm_cli_put_str("Usage: wdog [clear]\r\n");
+    return -1;
 }
-/* 导出test命令 */
-GM_CLI_CMD_EXPORT(test,
-                  "test [args] -- test the cli",
-                  gm_cli_internal_cmd_test);
+/* 导出wdog命令 */
+GM_CLI_CMD_EXPORT(wdog, "wdog [clear] -- show or clear command run time statistics",
+                  gm_cli_internal_cmd_wdog);
+#endif  /* GM_CLI_BUDGET_EN */
@@ -15,6 +15,64 @@
 **                                                             <Tom Free 付瑞彪>
 **           2021-06-17 -> 增加自动命令注册和静态注册选项
 **                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加定长数据打印接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加行存储区设置接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加批量输出回调函数
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加非交互执行接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加结构化输出接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 命令增加标志和缓存时间，增加时基回调和输出缓存接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加后台处理接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加运行时别名和会话保存恢复接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 补充精简配置下行存储区和打印函数的说明
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加trace内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加后台日志接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出调度说明
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加会话录制接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 命令增加执行时间预算，增加中止查询和请求接口、wdog内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加可重入命令标志和批量并行执行接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加set和unset内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令自行替换变量标志和repeat、for内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令插件加载卸载接口和plugin内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加共享内存控制通道接口
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内存命令md、mw和mcmp
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加函数符号表和call命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> extern "C"移到文件开头，C++中可以引用内部命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_log_str
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_stop，退出时关闭括号粘贴模式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 格式选项只对带EMIT标志的命令在末尾解析，嵌套超限报错
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 会话记录增加后台处理记录，回放按记录执行后台处理
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_peek_char判断Ctrl-C，执行状态改用原子操作
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 修复批量执行的命令不计预算、无法中止的问题，增加GM_CLI_CMD_EXPORT_EX_BUDGET
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 会话保存改由GM_CLI_SESSION_EN控制
+**                                                             <Tom Free 付瑞彪>
 **
 **              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
 **
@@ -25,11 +83,26 @@
 
 #include "gm_cli_cfg.h"
 
+/* 静态命令表和内部命令也需要C链接，C++中才能放入命令表 */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* 输出字符回调函数 */
 typedef void gm_cli_out_char_cb_t(const char);
+/* 批量输出回调函数 */
+typedef void gm_cli_out_buf_cb_t(const char*, unsigned int);
 /* 命令执行回调函数 */
 typedef int gm_cli_cmd_cb_t(int, char*[]);
 
+/* 结构化输出格式 */
+typedef enum
+{
+    GM_CLI_FMT_TEXT,                /* 文本，每个字段一行"name: value" */
+    GM_CLI_FMT_JSON,                /* 紧凑JSON，每个最外层值一行 */
+    GM_CLI_FMT_CBOR,                /* CBOR，容器采用不定长编码 */
+} gm_cli_fmt_t;
+
 /* 命令结构定义 */
 typedef struct _gm_cli_cmd_t
 {
@@ -37,8 +110,35 @@ typedef struct _gm_cli_cmd_t
     char* usage;                  /* 使用简洁说明 */
     gm_cli_cmd_cb_t *cb;          /* 命令执行函数 */
     struct _gm_cli_cmd_t *link;   /* 链接到的命令，用于命令别名 */
+    unsigned int flags;           /* 命令标志，GM_CLI_CMD_FLAG_XXX */
+    unsigned int ttl_ms;          /* 输出缓存有效时间，单位ms，0表示不缓存 */
+    unsigned int budget_ms;       /* 执行时间预算，单位ms，0表示使用默认预算 */
 } gm_cli_cmd_t;
 
+/* 命令标志：幂等命令，相同参数的输出在ttl_ms内不变，可以直接使用缓存 */
+#define GM_CLI_CMD_FLAG_IDEMPOTENT      0x01u
+/* 命令标志：运行时别名，由CLI内部使用 */
+#define GM_CLI_CMD_FLAG_MACRO           0x02u
+/* 命令标志：可重入命令，只通过gm_cli_put_xxx和gm_cli_printf输出，不使用其他CLI状态，
+ * 批量执行时可以和其他可重入命令在不同线程中同时执行 */
+#define GM_CLI_CMD_FLAG_REENTRANT       0x04u
+/* 命令标志：命令行不做变量替换，参数中的$name由命令自己展开，如循环命令 */
+#define GM_CLI_CMD_FLAG_RAW             0x08u
+/* 命令标志：使用结构化输出，命令行末尾的--text、--json和--cbor指定本次的输出格式，
+ * 不传给命令回调 */
+#define GM_CLI_CMD_FLAG_EMIT            0x10u
+
+/* 时基回调函数，返回毫秒计数，允许回绕 */
+typedef unsigned long gm_cli_tick_cb_t(void);
+
+/* 函数符号，call命令按名称查找后调用 */
+typedef struct
+{
+    const char* name;             /* 函数名 */
+    void (*addr)(void);           /* 函数地址，调用时按实际参数个数传参 */
+    const char* sig;              /* 函数原型，只用于显示，可以为NULL */
+} gm_cli_sym_t;
+
 /* 编译器支持列举 */
 #define GM_CLI_CC_NULL              0x00u   /* 不支持的编译器 */
 #define GM_CLI_CC_MDK_ARM           0x01u   /* MDK for ARM (Keil) */
@@ -116,6 +216,44 @@ typedef struct _gm_cli_cmd_t
                 .cb      = cmd_cb,                                             \
                 .link    = NULL,                                               \
             };
+/* 导出带标志的命令，cmd_ttl为输出缓存有效时间，单位ms */
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)  \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .ttl_ms  = cmd_ttl,                                            \
+            };
+/* 导出带执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)     \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .budget_ms = cmd_budget,                                       \
+            };
+/* 导出带标志和执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget) \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .budget_ms = cmd_budget,                                       \
+            };
 /* 命令命别名 */
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)                     \
         __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
@@ -151,6 +289,44 @@ typedef struct _gm_cli_cmd_t
                 .cb      = cmd_cb,                                             \
                 .link    = NULL,                                               \
             };
+/* 导出带标志的命令，cmd_ttl为输出缓存有效时间，单位ms */
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)  \
+        _Pragma("location = \".gm_cli_cmd_section\"")                          \
+            static __root const gm_cli_cmd_t                                   \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .ttl_ms  = cmd_ttl,                                            \
+            };
+/* 导出带执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)     \
+        _Pragma("location = \".gm_cli_cmd_section\"")                          \
+            static __root const gm_cli_cmd_t                                   \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .budget_ms = cmd_budget,                                       \
+            };
+/* 导出带标志和执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget) \
+        _Pragma("location = \".gm_cli_cmd_section\"")                          \
+            static __root const gm_cli_cmd_t                                   \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .budget_ms = cmd_budget,                                       \
+            };
         /* 命令命别名 */
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)                     \
         _Pragma("location = \".gm_cli_cmd_section\"")                          \
@@ -172,10 +348,52 @@ typedef struct _gm_cli_cmd_t
 #endif  /* GM_CLI_CC == GM_CLI_CC_IAR_AVR */
 
 /* GCC for Linux */
+/* 命令结构大于32字节时GCC会把段内的命令按32字节对齐，命令之间出现空隙，因此
+ * GCC下均指定按指针大小对齐，保证命令在段内连续存放 */
 #if (GM_CLI_CC == GM_CLI_CC_GCC_LINUX)
 /* 导出命令 */
 #define GM_CLI_CMD_EXPORT(cmd_name, cmd_usage, cmd_cb)                         \
         __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+            };
+/* 导出带标志的命令，cmd_ttl为输出缓存有效时间，单位ms */
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)  \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .ttl_ms  = cmd_ttl,                                            \
+            };
+/* 导出带执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)     \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .budget_ms = cmd_budget,                                       \
+            };
+/* 导出带标志和执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget) \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))                                \
             static const gm_cli_cmd_t                                          \
             GM_CLI_STR_CONNECT2(gm_cli_cmd_, cmd_name) =                       \
             {                                                                  \
@@ -183,10 +401,13 @@ typedef struct _gm_cli_cmd_t
                 .usage   = cmd_usage,                                          \
                 .cb      = cmd_cb,                                             \
                 .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .budget_ms = cmd_budget,                                       \
             };
 /* 命令命别名 */
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)                     \
         __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))                                \
             static const gm_cli_cmd_t                                          \
             GM_CLI_STR_CONNECT3(gm_cli_cmd_, cmd_name##_, num) =               \
             {                                                                  \
@@ -198,6 +419,15 @@ typedef struct _gm_cli_cmd_t
 /* 命令别名 */
 #define GM_CLI_CMD_ALIAS(cmd_name, cmd_alias_str)                              \
         GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, __LINE__)
+/* 命令插件中以段方式导出命令时使用一次，导出段的起止位置，链接器只在段的起止符号
+ * 被引用时才生成它们 */
+#define GM_CLI_PLUGIN_SECTION_EXPORT()                                         \
+        extern const gm_cli_cmd_t __start_gm_cli_cmd_section[];                \
+        extern const gm_cli_cmd_t __stop_gm_cli_cmd_section[];                 \
+        const gm_cli_cmd_t* const gm_cli_plugin_section[2] =                   \
+        {                                                                      \
+            __start_gm_cli_cmd_section, __stop_gm_cli_cmd_section              \
+        }
 #endif  /* GM_CLI_CC == GM_CLI_CC_GCC_LINUX */
 
 /* MinGW，Windows系统下的GCC */
@@ -205,16 +435,56 @@ typedef struct _gm_cli_cmd_t
 /* 导出命令 */
 #define GM_CLI_CMD_EXPORT(cmd_name, cmd_usage, cmd_cb)                         \
         __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+            };
+/* 导出带标志的命令，cmd_ttl为输出缓存有效时间，单位ms */
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)  \
+        __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .flags   = cmd_flags,                                          \
+                .ttl_ms  = cmd_ttl,                                            \
+            };
+/* 导出带执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)     \
+        __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))                                \
             static const gm_cli_cmd_t                                          \
             GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
             {                                                                  \
                 .name    = #cmd_name,                                          \
                 .usage   = cmd_usage,                                          \
                 .cb      = cmd_cb,                                             \
+                .budget_ms = cmd_budget,                                       \
+            };
+/* 导出带标志和执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget) \
+        __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))                                \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .flags   = cmd_flags,                                          \
+                .budget_ms = cmd_budget,                                       \
             };
 /* 命令命别名，需要指定一个编号来区分名称 */
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)                     \
         __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))                                \
             static const gm_cli_cmd_t                                          \
             GM_CLI_STR_CONNECT3(gm_cli_ex_cmd_, cmd_name##_, num) =            \
             {                                                                  \
@@ -245,6 +515,44 @@ typedef struct _gm_cli_cmd_t
                 .cb      = cmd_cb,                                             \
                 .link    = NULL,                                               \
             };
+/* 导出带标志的命令，cmd_ttl为输出缓存有效时间，单位ms */
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)  \
+        __declspec(allocate(".gm_cli_cmd_section$b"))                          \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .ttl_ms  = cmd_ttl,                                            \
+            };
+/* 导出带执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)     \
+        __declspec(allocate(".gm_cli_cmd_section$b"))                          \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .budget_ms = cmd_budget,                                       \
+            };
+/* 导出带标志和执行时间预算的命令，cmd_budget单位ms */
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget) \
+        __declspec(allocate(".gm_cli_cmd_section$b"))                          \
+            static const gm_cli_cmd_t                                          \
+            GM_CLI_STR_CONNECT2(gm_cli_ex_cmd_, cmd_name) =                    \
+            {                                                                  \
+                .name    = #cmd_name,                                          \
+                .usage   = cmd_usage,                                          \
+                .cb      = cmd_cb,                                             \
+                .link    = NULL,                                               \
+                .flags   = cmd_flags,                                          \
+                .budget_ms = cmd_budget,                                       \
+            };
 /* 命令命别名，需要指定一个编号来区分名称 */
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)                     \
         __declspec(allocate(".gm_cli_cmd_section$b"))                          \
@@ -265,6 +573,9 @@ typedef struct _gm_cli_cmd_t
 #if (GM_CLI_CC == GM_CLI_CC_ANY)
 /* 以下宏用于兼容导出方式，免得需要手动删除代码 */
 #define GM_CLI_CMD_EXPORT(cmd_name, cmd_usage, cmd_cb)
+#define GM_CLI_CMD_EXPORT_EX(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_ttl)
+#define GM_CLI_CMD_EXPORT_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_budget)
+#define GM_CLI_CMD_EXPORT_EX_BUDGET(cmd_name, cmd_usage, cmd_cb, cmd_flags, cmd_budget)
 #define GM_CLI_CMD_ALIAS_NUM(cmd_name, cmd_alias_str, num)
 #define GM_CLI_CMD_ALIAS(cmd_name, cmd_alias_str)
 
@@ -278,12 +589,35 @@ int gm_cli_internal_cmd_help(int argc, char* argv[]);
 int gm_cli_internal_cmd_history(int argc, char* argv[]);
 /* 内部命令-test */
 int gm_cli_internal_cmd_test(int argc, char* argv[]);
+/* 内部命令-format，GM_CLI_EMIT_EN为1时可用 */
+int gm_cli_internal_cmd_format(int argc, char* argv[]);
+/* 内部命令-cache，GM_CLI_CACHE_EN为1时可用 */
+int gm_cli_internal_cmd_cache(int argc, char* argv[]);
+/* 内部命令-watch，GM_CLI_WATCH_EN为1时可用 */
+int gm_cli_internal_cmd_watch(int argc, char* argv[]);
+/* 内部命令-alias和unalias，GM_CLI_ALIAS_EN为1时可用 */
+int gm_cli_internal_cmd_alias(int argc, char* argv[]);
+int gm_cli_internal_cmd_unalias(int argc, char* argv[]);
+/* 内部命令-set和unset，GM_CLI_VAR_EN为1时可用 */
+int gm_cli_internal_cmd_set(int argc, char* argv[]);
+int gm_cli_internal_cmd_unset(int argc, char* argv[]);
+/* 内部命令-repeat和for，GM_CLI_LOOP_EN为1时可用，for还需要GM_CLI_VAR_EN为1 */
+int gm_cli_internal_cmd_repeat(int argc, char* argv[]);
+int gm_cli_internal_cmd_for(int argc, char* argv[]);
+/* 内部命令-plugin，GM_CLI_PLUGIN_EN为1时可用 */
+int gm_cli_internal_cmd_plugin(int argc, char* argv[]);
+/* 内部命令-md、mw和mcmp，GM_CLI_MEM_EN为1时可用 */
+int gm_cli_internal_cmd_md(int argc, char* argv[]);
+int gm_cli_internal_cmd_mw(int argc, char* argv[]);
+int gm_cli_internal_cmd_mcmp(int argc, char* argv[]);
+/* 内部命令-call，GM_CLI_CALL_EN为1时可用 */
+int gm_cli_internal_cmd_call(int argc, char* argv[]);
+/* 内部命令-trace，GM_CLI_TRACE_EN为1时可用 */
+int gm_cli_internal_cmd_trace(int argc, char* argv[]);
+/* 内部命令-wdog，GM_CLI_BUDGET_EN为1时可用 */
+int gm_cli_internal_cmd_wdog(int argc, char* argv[]);
 #endif  /* GM_CLI_CC == GM_CLI_CC_ANY */
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
 /*******************************************************************************
 ** 函数名称：gm_cli_mgr_init
 ** 函数作用：初始化CLI管理器
@@ -304,6 +638,27 @@ void gm_cli_mgr_init(void);
 *******************************************************************************/
 void gm_cli_set_out_char_cb(gm_cli_out_char_cb_t *out_char_cb);
 
+/*******************************************************************************
+** 函数名称：gm_cli_set_out_buf_cb
+** 函数作用：设置批量输出回调函数
+** 输入参数：out_buf_cb - 批量输出回调函数，NULL表示不使用
+** 输出参数：无
+** 使用范例：gm_cli_set_out_buf_cb(fun_out_buf);
+** 函数备注：设置后输出优先使用此回调，一段数据只调用一次，适合DMA或系统调用
+**           等单次开销较大的输出方式
+*******************************************************************************/
+void gm_cli_set_out_buf_cb(gm_cli_out_buf_cb_t *out_buf_cb);
+
+/*******************************************************************************
+** 函数名称：gm_cli_set_tick_cb
+** 函数作用：设置时基回调函数
+** 输入参数：tick_cb - 时基回调函数，返回毫秒计数，NULL表示不使用
+** 输出参数：无
+** 使用范例：gm_cli_set_tick_cb(fun_get_ms);
+** 函数备注：命令输出缓存等需要计时的功能依赖此回调，未设置时不生效
+*******************************************************************************/
+void gm_cli_set_tick_cb(gm_cli_tick_cb_t *tick_cb);
+
 /*******************************************************************************
 ** 函数名称：gm_cli_set_cmd_prompt
 ** 函数作用：设置命令提示符
@@ -314,6 +669,22 @@ void gm_cli_set_out_char_cb(gm_cli_out_char_cb_t *out_char_cb);
 *******************************************************************************/
 void gm_cli_set_cmd_prompt(const char* const p_notice);
 
+/*******************************************************************************
+** 函数名称：gm_cli_set_line_arena
+** 函数作用：设置行存储区
+** 输入参数：p_arena    - 存储区，需要一直有效，一般为静态数组
+**           arena_size - 存储区大小，至少为行长度的3倍
+**           line_size  - 一行的最大输入字符数，包括一个'\0'
+** 输出参数：0 - 设置成功，-1 - 参数错误
+** 使用范例：static char arena[2048];
+**           gm_cli_set_line_arena(arena, sizeof(arena), 256);
+** 函数备注：存储区依次分配给行缓存、备份行和历史记录存储池，历史记录会被清空，
+**           gm_cli_mgr_init会恢复为默认存储区，需要在其之后调用，
+**           GM_CLI_PACKED_EN为1时存储区不能超过65535字节
+*******************************************************************************/
+int gm_cli_set_line_arena(char* const p_arena, const unsigned int arena_size,
+                          const unsigned int line_size);
+
 /*******************************************************************************
 ** 函数名称：gm_cli_start
 ** 函数作用：启动CLI
@@ -324,6 +695,17 @@ void gm_cli_set_cmd_prompt(const char* const p_notice);
 *******************************************************************************/
 void gm_cli_start(void);
 
+/*******************************************************************************
+** 函数名称：gm_cli_stop
+** 函数作用：停止CLI
+** 输入参数：无
+** 输出参数：无
+** 使用范例：gm_cli_stop();
+** 函数备注：发送未发送完的命令输出，GM_CLI_BRACKETED_PASTE_EN为1时关闭终端的括号
+**           粘贴模式，退出程序或把终端交给其他程序之前调用
+*******************************************************************************/
+void gm_cli_stop(void);
+
 /*******************************************************************************
 ** 函数名称：gm_cli_put_char
 ** 函数作用：打印字符
@@ -334,6 +716,17 @@ void gm_cli_start(void);
 *******************************************************************************/
 void gm_cli_put_char(const char ch);
 
+/*******************************************************************************
+** 函数名称：gm_cli_put_buf
+** 函数作用：打印指定长度的数据
+** 输入参数：buf - 数据
+**           len - 数据长度
+** 输出参数：无
+** 使用范例：gm_cli_put_buf("hello\r\n", 7);
+** 函数备注：数据可以不以'\0'结尾，批量输出时比逐个字符打印效率更高
+*******************************************************************************/
+void gm_cli_put_buf(const char* const buf, const unsigned int len);
+
 /*******************************************************************************
 ** 函数名称：gm_cli_put_str
 ** 函数作用：打印字符串
@@ -351,7 +744,8 @@ void gm_cli_put_str(const char* const str);
 **           ... - 可变参数
 ** 输出参数：无
 ** 使用范例：gm_cli_printf("%d\r\n", 123);
-** 函数备注：
+** 函数备注：超出GM_CLI_PRINTF_BUF_MAX的部分截断，GM_CLI_PRINTF_BUF_MAX为0时使用
+**           内置的精简格式化，支持的格式见gm_cli_cfg.h
 *******************************************************************************/
 void gm_cli_printf(const char* const fmt, ...);
 
@@ -365,6 +759,347 @@ void gm_cli_printf(const char* const fmt, ...);
 *******************************************************************************/
 void gm_cli_parse_char(const char ch);
 
+/*******************************************************************************
+** 函数名称：gm_cli_exec
+** 函数作用：非交互执行一行命令
+** 输入参数：line  - 命令行，执行时会被修改
+**           p_ret - 命令回调的返回值，可为NULL
+** 输出参数：0 - 已执行，-1 - 未执行（命令不存在或命令行格式错误）
+** 使用范例：char line[] = "test 1 2";
+**           gm_cli_exec(line, &ret);
+** 函数备注：不回显、不记录历史、不输出提示符，支持管道和重定向，
+**           命令输出和错误提示都输出到当前输出通道
+*******************************************************************************/
+int gm_cli_exec(char* const line, int* const p_ret);
+
+#if GM_CLI_BATCH_EN
+/*******************************************************************************
+** 函数名称：gm_cli_batch
+** 函数作用：批量执行脚本，连续的可重入命令并行执行
+** 输入参数：script  - 脚本，每行一条命令，空行和'#'开头的行忽略，执行时会被修改
+**           threads - 线程数，为0或1时在当前线程中逐条执行
+**           p_line  - 失败时输出失败的行号（从1开始），可为NULL
+** 输出参数：0 - 全部成功，-1 - 有命令不存在或返回值不为0，之后的命令不再执行
+** 使用范例：gm_cli_batch(script, 8, &line);
+** 函数备注：带GM_CLI_CMD_FLAG_REENTRANT标志且没有管道、重定向和变量替换的命令在
+**           线程池中执行，各自计算执行时间预算，输出先捕获，按命令顺序输出；其他命令
+**           作为屏障，等之前的命令全部完成后在当前线程中执行；失败时已经开始执行的
+**           后续命令会执行完，输出被丢弃
+*******************************************************************************/
+int gm_cli_batch(char* const script, unsigned int threads, unsigned int* const p_line);
+#endif  /* GM_CLI_BATCH_EN */
+
+#if GM_CLI_PLUGIN_EN
+/*******************************************************************************
+** 函数名称：gm_cli_plugin_load
+** 函数作用：加载命令插件
+** 输入参数：path - 共享库路径，按dlopen的规则查找
+** 输出参数：0 - 成功，-1 - 失败，原因输出到当前输出通道
+** 使用范例：gm_cli_plugin_load("/usr/lib/gw/diag.so");
+** 函数备注：插件导出以name为NULL结束的命令表gm_cli_plugin_cmds，或以段方式导出命令
+**           并使用GM_CLI_PLUGIN_SECTION_EXPORT()，命令名和已有命令重复时不加载；
+**           查找索引在另一份中重建后原子切换，不会看到建了一半的索引；
+**           需要在命令行线程中调用，宿主程序链接时加-rdynamic，插件才能调用
+**           gm_cli_printf等接口
+*******************************************************************************/
+int gm_cli_plugin_load(const char* const path);
+
+/*******************************************************************************
+** 函数名称：gm_cli_plugin_unload
+** 函数作用：卸载命令插件
+** 输入参数：name - 插件序号（从1开始）或加载时的路径
+** 输出参数：0 - 成功，-1 - 插件不存在或正在使用
+** 使用范例：gm_cli_plugin_unload("1");
+** 函数备注：先从索引中去掉插件的命令并切换索引，停止插件命令的周期执行，清除其输出
+**           缓存，等待正在执行的命令全部结束后再dlclose；需要在命令行线程中调用，
+**           不能在嵌套执行的命令中卸载
+*******************************************************************************/
+int gm_cli_plugin_unload(const char* const name);
+#endif  /* GM_CLI_PLUGIN_EN */
+
+#if GM_CLI_SHM_EN
+/*******************************************************************************
+** 函数名称：gm_cli_shm_open
+** 函数作用：创建共享内存控制通道
+** 输入参数：name - 共享内存名称，按shm_open的规则，如"/gm_cli"
+** 输出参数：0 - 成功，-1 - 失败
+** 使用范例：gm_cli_shm_open("/gm_cli");
+** 函数备注：同名的共享内存已存在时重新初始化，请求由gm_cli_poll执行，
+**           客户端接口和共享内存布局见gm_cli_shm.h
+*******************************************************************************/
+int gm_cli_shm_open(const char* const name);
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_close
+** 函数作用：关闭并删除共享内存控制通道
+** 输入参数：无
+** 输出参数：无
+** 使用范例：gm_cli_shm_close();
+** 函数备注：
+*******************************************************************************/
+void gm_cli_shm_close(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_poll
+** 函数作用：执行共享内存通道中的请求
+** 输入参数：无
+** 输出参数：执行的请求数
+** 使用范例：gm_cli_shm_poll();
+** 函数备注：每次最多执行GM_CLI_SHM_BURST条，gm_cli_poll中已调用；命令通过
+**           gm_cli_exec执行，输出直接写入应答缓存，客户端不取走应答时暂停执行
+*******************************************************************************/
+int gm_cli_shm_poll(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_wait
+** 函数作用：等待共享内存通道中有可以执行的请求
+** 输入参数：ms - 最长等待时间，单位ms
+** 输出参数：1 - 有请求可以执行，0 - 超时，-1 - 通道未打开
+** 使用范例：while (1) { gm_cli_shm_wait(10); gm_cli_poll(); }
+** 函数备注：在futex上等待，客户端提交时唤醒，用于只服务控制通道的线程或主循环
+*******************************************************************************/
+int gm_cli_shm_wait(const unsigned int ms);
+#endif  /* GM_CLI_SHM_EN */
+
+#if GM_CLI_CALL_EN
+/* tools/gm_cli_symgen.sh生成的函数符号表和符号数 */
+extern const gm_cli_sym_t gm_cli_sym_table[];
+extern const unsigned int gm_cli_sym_num;
+
+/*******************************************************************************
+** 函数名称：gm_cli_set_sym_table
+** 函数作用：设置call命令使用的函数符号表
+** 输入参数：p_table - 符号表，需要一直有效，按名称的字节序严格递增
+**           num     - 符号数
+** 输出参数：0 - 设置成功，-1 - 参数错误或没有排序
+** 使用范例：gm_cli_set_sym_table(gm_cli_sym_table, gm_cli_sym_num);
+** 函数备注：查找使用二分查找，gm_cli_mgr_init会清除符号表，需要在其之后调用
+*******************************************************************************/
+int gm_cli_set_sym_table(const gm_cli_sym_t* const p_table, const unsigned int num);
+#endif  /* GM_CLI_CALL_EN */
+
+/*******************************************************************************
+** 函数名称：gm_cli_poll
+** 函数作用：CLI后台处理，发送批量输出，执行到期的周期命令，输出后台日志等
+** 输入参数：无
+** 输出参数：无
+** 使用范例：while (1) { if (_kbhit()) gm_cli_parse_char(_getch()); gm_cli_poll(); }
+** 函数备注：在主循环或CLI任务中周期调用，调用间隔不大于GM_CLI_WATCH_TICK_MS时
+**           周期命令的定时最准确，不能在中断中调用；输出调度使能时命令输出
+**           由此函数分块发送，批量输出没有发送完时不执行周期命令和输出日志
+*******************************************************************************/
+void gm_cli_poll(void);
+
+#if GM_CLI_LOG_EN
+/*******************************************************************************
+** 函数名称：gm_cli_log
+** 函数作用：输出一行后台日志
+** 输入参数：fmt - 格式化字符串
+**           ... - 可变参数
+** 输出参数：0 - 已放入队列，-1 - 队列已满，日志被丢弃
+** 使用范例：gm_cli_log("adc ch%d = %d", ch, val);
+** 函数备注：可在任意线程中调用，不等待终端，日志由gm_cli_poll批量输出，输出前擦除
+**           输入行，输出后重绘，行尾的换行自动添加；格式化使用调用者的栈，
+**           中断中使用gm_cli_log_str
+*******************************************************************************/
+int gm_cli_log(const char* const fmt, ...);
+
+/*******************************************************************************
+** 函数名称：gm_cli_log_str
+** 函数作用：输出一行已格式化的后台日志
+** 输入参数：str - 日志字符串
+** 输出参数：0 - 已放入队列，-1 - 队列已满，日志被丢弃
+** 使用范例：gm_cli_log_str("uart overrun");
+** 函数备注：只复制字符串，不调用格式化函数，可在中断中调用，编译器不是GCC、Clang
+**           或VC时需要配置GM_CLI_LOG_LOCK为关中断
+*******************************************************************************/
+int gm_cli_log_str(const char* const str);
+#endif  /* GM_CLI_LOG_EN */
+
+#if GM_CLI_REC_EN
+/*******************************************************************************
+** 函数名称：gm_cli_rec_start
+** 函数作用：开始录制会话
+** 输入参数：write_cb - 会话记录写入函数
+** 输出参数：0 - 成功，-1 - 参数错误或已在录制
+** 使用范例：gm_cli_rec_start(rec_file_write);
+** 函数备注：之后每个交给gm_cli_parse_char的字符、每段终端输出和有输入输出的
+**           gm_cli_poll都带时间戳写入记录，时间戳来自时基回调，需要先设置；写入
+**           函数中不能再调用CLI的输出函数
+*******************************************************************************/
+int gm_cli_rec_start(gm_cli_out_buf_cb_t* const write_cb);
+
+/*******************************************************************************
+** 函数名称：gm_cli_rec_stop
+** 函数作用：停止录制会话
+** 输入参数：无
+** 输出参数：无
+** 使用范例：gm_cli_rec_stop();
+** 函数备注：写入缓存中的数据和结束记录
+*******************************************************************************/
+void gm_cli_rec_stop(void);
+#endif  /* GM_CLI_REC_EN */
+
+#if GM_CLI_BUDGET_EN
+/*******************************************************************************
+** 函数名称：gm_cli_should_abort
+** 函数作用：查询正在执行的命令是否应该中止
+** 输入参数：无
+** 输出参数：1 - 超过执行时间预算或被请求中止，0 - 继续执行
+** 使用范例：while (!peripheral_ready()) { if (gm_cli_should_abort()) return -1; }
+** 函数备注：在命令的长循环中调用，只读取标志和时基，开销很小，批量执行的工作线程中
+**           查询的是本线程正在执行的命令
+*******************************************************************************/
+int gm_cli_should_abort(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_request_abort
+** 函数作用：请求中止正在执行的命令
+** 输入参数：无
+** 输出参数：0 - 已请求，-1 - 没有正在执行的命令
+** 使用范例：gm_cli_request_abort();
+** 函数备注：可在其他线程或中断中调用，命令通过gm_cli_should_abort查询到后自行返回，
+**           按键中止使用gm_cli_peek_char，粘贴或二进制帧中的0x03不会中止命令；
+**           批量执行中请求时中止所有工作线程中的命令，并且不再执行后续命令
+*******************************************************************************/
+int gm_cli_request_abort(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_peek_char
+** 函数作用：命令执行期间预解析收到的字符，是Ctrl-C时请求中止正在执行的命令
+** 输入参数：ch - 收到的字符
+** 输出参数：1 - 是Ctrl-C，已请求中止，0 - 其他字符或没有正在执行的命令
+** 使用范例：串口接收中断中 gm_cli_peek_char(ch); 再把ch放入接收队列
+** 函数备注：按收到的顺序对每个字符调用，从命令开始时解析器的状态跟踪粘贴和二进制
+**           帧模式，只有普通输入中的0x03才是Ctrl-C；只判断不解析，字符仍需在命令
+**           返回后交给gm_cli_parse_char；只能在一个线程或中断中调用
+*******************************************************************************/
+int gm_cli_peek_char(const char ch);
+
+/*******************************************************************************
+** 函数名称：gm_cli_watchdog_poll
+** 函数作用：检查正在执行的命令是否超过执行时间预算
+** 输入参数：无
+** 输出参数：-1 - 没有正在执行的命令，0 - 在预算内，1 - 已超过预算
+** 使用范例：在定时器中断或看门狗线程中周期调用 gm_cli_watchdog_poll();
+** 函数备注：可在其他线程或中断中调用，超过预算时设置中止标志，命令不查询
+**           gm_cli_should_abort时也能知道命令卡住了
+*******************************************************************************/
+int gm_cli_watchdog_poll(void);
+#endif  /* GM_CLI_BUDGET_EN */
+
+#if GM_CLI_SESSION_EN
+/*******************************************************************************
+** 函数名称：gm_cli_session_save
+** 函数作用：保存会话状态，包括输出格式、运行时别名和历史记录
+** 输入参数：buf - 保存位置
+**           size - 保存位置大小
+** 输出参数：保存的长度，-1表示空间不足
+** 使用范例：len = gm_cli_session_save(flash_buf, sizeof(flash_buf));
+** 函数备注：保存内容为文本，每行一条
+*******************************************************************************/
+int gm_cli_session_save(char* const buf, const unsigned int size);
+
+/*******************************************************************************
+** 函数名称：gm_cli_session_restore
+** 函数作用：恢复gm_cli_session_save保存的会话状态
+** 输入参数：buf - 保存的数据
+**           len - 保存的数据长度
+** 输出参数：0 - 成功，-1 - 有无法恢复的行
+** 使用范例：gm_cli_session_restore(flash_buf, len);
+** 函数备注：同名的别名被覆盖，历史记录追加在现有记录之后，恢复过程不输出
+*******************************************************************************/
+int gm_cli_session_restore(const char* const buf, const unsigned int len);
+#endif  /* GM_CLI_SESSION_EN */
+
+#if GM_CLI_CACHE_EN
+/*******************************************************************************
+** 函数名称：gm_cli_cache_invalidate
+** 函数作用：使命令的输出缓存失效
+** 输入参数：name - 命令名，NULL表示全部命令
+** 输出参数：无
+** 使用范例：gm_cli_cache_invalidate("route");
+** 函数备注：命令输出依赖的数据被修改后调用，下次执行时重新执行命令
+*******************************************************************************/
+void gm_cli_cache_invalidate(const char* const name);
+
+/*******************************************************************************
+** 函数名称：gm_cli_cache_get_stats
+** 函数作用：读取输出缓存的命中和未命中次数
+** 输入参数：p_hit - 命中次数存放地址，可为NULL
+**           p_miss - 未命中次数存放地址，可为NULL
+** 输出参数：无
+** 使用范例：gm_cli_cache_get_stats(&hit, &miss);
+** 函数备注：
+*******************************************************************************/
+void gm_cli_cache_get_stats(unsigned long* const p_hit, unsigned long* const p_miss);
+#endif  /* GM_CLI_CACHE_EN */
+
+#if GM_CLI_EMIT_EN
+/*******************************************************************************
+** 函数名称：gm_cli_set_output_fmt
+** 函数作用：设置会话默认的结构化输出格式
+** 输入参数：fmt - 输出格式
+** 输出参数：无
+** 使用范例：gm_cli_set_output_fmt(GM_CLI_FMT_JSON);
+** 函数备注：带GM_CLI_CMD_FLAG_EMIT标志的命令末尾加--text、--json或--cbor可以单独
+**           指定本次执行的格式
+*******************************************************************************/
+void gm_cli_set_output_fmt(const gm_cli_fmt_t fmt);
+
+/*******************************************************************************
+** 函数名称：gm_cli_get_output_fmt
+** 函数作用：读取当前命令的结构化输出格式
+** 输入参数：无
+** 输出参数：输出格式
+** 使用范例：if (gm_cli_get_output_fmt() == GM_CLI_FMT_TEXT) { ... }
+** 函数备注：
+*******************************************************************************/
+gm_cli_fmt_t gm_cli_get_output_fmt(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_emit_begin_object/gm_cli_emit_begin_array
+** 函数作用：开始一个对象或数组
+** 输入参数：name - 名字，在数组中或作为最外层时可为NULL
+** 输出参数：无
+** 使用范例：gm_cli_emit_begin_object(NULL);
+**           gm_cli_emit_field_uint("rx", rx_count);
+**           gm_cli_emit_begin_array("ports");
+**           gm_cli_emit_field_str(NULL, "eth0");
+**           gm_cli_emit_end_array();
+**           gm_cli_emit_end_object();
+** 函数备注：边调用边输出，不在内存中构建文档，命令返回时未结束的容器自动结束，
+**           嵌套超过GM_CLI_EMIT_DEPTH_MAX层时超出的容器不输出，命令返回后报错
+*******************************************************************************/
+void gm_cli_emit_begin_object(const char* const name);
+void gm_cli_emit_begin_array(const char* const name);
+
+/*******************************************************************************
+** 函数名称：gm_cli_emit_end_object/gm_cli_emit_end_array
+** 函数作用：结束当前的对象或数组
+** 输入参数：无
+** 输出参数：无
+** 使用范例：gm_cli_emit_end_object();
+** 函数备注：
+*******************************************************************************/
+void gm_cli_emit_end_object(void);
+void gm_cli_emit_end_array(void);
+
+/*******************************************************************************
+** 函数名称：gm_cli_emit_field_xxx
+** 函数作用：输出一个字段
+** 输入参数：name - 字段名，在数组中时为NULL
+**           val/str - 字段值
+** 输出参数：无
+** 使用范例：gm_cli_emit_field_int("temp", -12);
+** 函数备注：
+*******************************************************************************/
+void gm_cli_emit_field_int(const char* const name, const long val);
+void gm_cli_emit_field_uint(const char* const name, const unsigned long val);
+void gm_cli_emit_field_str(const char* const name, const char* const str);
+void gm_cli_emit_field_bool(const char* const name, const int val);
+#endif  /* GM_CLI_EMIT_EN */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,361 @@
+/*******************************************************************************
+** 文件名称：gm_cli.hpp
+** 文件作用：通用命令行接口C++封装
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：只有头文件，需要C++17，命令回调可以是普通函数或lambda，参数按回调
+**           的参数类型自动解析，命令表在编译期生成并按命令名排序，运行时不需要
+**           注册，和C命令一样由gm_cli.c查找、建立索引和补全
+**
+**           支持的参数类型：整数（十进制、0x十六进制、0八进制）、bool（1/0、
+**           true/false、on/off）、float和double、const char*、std::string_view，
+**           最后一个参数为gm_cli::rest时接收剩余的全部参数；返回值为void时命令
+**           返回0，为整数时作为命令返回值，参数个数或格式错误时命令返回-1
+**
+**           段方式注册（GM_CLI_CMD_REG_BY_CC_SECTION为1）时，命令表和C中
+**           GM_CLI_CMD_EXPORT导出的命令放在同一个段：
+**           static int add(int a, int b) { gm_cli_printf("%d\r\n", a + b); return 0; }
+**           static constexpr auto led = [](bool on) { board_led(on); };
+**           GM_CLI_CPP_EXPORT(app_cmds,
+**               gm_cli::cmd<add>("add", "add a b -- print a + b"),
+**               gm_cli::cmd<led>("led", "led on|off -- switch the led"));
+**
+**           静态注册时命令直接放入gm_cli_static_cmds，C命令用第三个参数给出回调：
+**           const gm_cli_cmd_t gm_cli_static_cmds[] =
+**           {
+**               gm_cli::cmd("help", "help [cmd-name] -- list the command and usage",
+**                           gm_cli_internal_cmd_help),
+**               gm_cli::cmd<add>("add", "add a b -- print a + b"),
+**               {},
+**           };
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     C++17
+*******************************************************************************/
+#ifndef __GM_CLI_HPP__
+#define __GM_CLI_HPP__
+
+#if ((defined(_MSVC_LANG) ? _MSVC_LANG : __cplusplus) < 201703L)
+#error "gm_cli.hpp requires C++17"
+#endif
+
+#include "gm_cli.h"
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gm_cli
+{
+
+/* 剩余参数，只能作为最后一个参数 */
+struct rest
+{
+    int    argc;                  /* 剩余参数个数 */
+    char** argv;                  /* 剩余参数 */
+};
+
+namespace detail
+{
+
+/* 编译期比较字符串 */
+constexpr int str_cmp(const char* a, const char* b)
+{
+    while ((*a != '\0') && (*a == *b))
+    {
+        a++;
+        b++;
+    }
+    return (int)(unsigned char)*a - (int)(unsigned char)*b;
+}
+
+/* 命令名重复，只声明不定义，编译期生成命令表时调用会报错 */
+void duplicate_command_name();
+
+/* 回调的函数类型，lambda取operator()的参数表 */
+template <typename T>
+struct sig : sig<decltype(&T::operator())> {};
+template <typename R, typename... A>
+struct sig<R(A...)> { using type = R(A...); };
+template <typename R, typename... A>
+struct sig<R(A...) noexcept> { using type = R(A...); };
+template <typename R, typename... A>
+struct sig<R(*)(A...)> { using type = R(A...); };
+template <typename R, typename... A>
+struct sig<R(*)(A...) noexcept> { using type = R(A...); };
+template <typename C, typename R, typename... A>
+struct sig<R(C::*)(A...) const> { using type = R(A...); };
+template <typename C, typename R, typename... A>
+struct sig<R(C::*)(A...) const noexcept> { using type = R(A...); };
+
+/* 参数存放的类型 */
+template <typename T>
+using arg_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+/* 最后一个参数是否为rest */
+template <typename... A>
+struct last_is_rest : std::false_type {};
+template <typename T>
+struct last_is_rest<T> : std::is_same<arg_t<T>, rest> {};
+template <typename T, typename U, typename... A>
+struct last_is_rest<T, U, A...> : last_is_rest<U, A...> {};
+
+/* 解析一个参数，返回：true - 成功，false - 格式错误或超出范围 */
+template <typename T>
+bool parse(char* const str, T& val)
+{
+    char* end = str;
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        std::string_view s(str);
+
+        val = ((s == "1") || (s == "true") || (s == "on"));
+        return val || (s == "0") || (s == "false") || (s == "off");
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+        long long v;
+
+        errno = 0;
+        v = std::strtoll(str, &end, 0);
+        val = (T)v;
+        return (end != str) && (*end == '\0') && (errno == 0) && ((long long)val == v);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        unsigned long long v;
+
+        errno = 0;
+        v = std::strtoull(str, &end, 0);
+        val = (T)v;
+        return (str[0] != '-') && (end != str) && (*end == '\0') && (errno == 0) &&
+               ((unsigned long long)val == v);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        val = (T)std::strtod(str, &end);
+        return (end != str) && (*end == '\0');
+    }
+    else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                       std::is_same_v<T, std::string_view>)
+    {
+        val = str;
+        return true;
+    }
+    else
+    {
+        static_assert(sizeof(T) == 0, "unsupported gm_cli command argument type");
+        return false;
+    }
+}
+
+/* 命令回调，解析参数后调用F */
+template <auto& F, typename S = typename sig<std::remove_cv_t<std::remove_reference_t<decltype(F)>>>::type>
+struct thunk;
+
+template <auto& F, typename R, typename... A>
+struct thunk<F, R(A...)>
+{
+    /* 参数个数，最后一个参数为rest时不计入 */
+    static constexpr bool has_rest = last_is_rest<A...>::value;
+    static constexpr int fixed = (int)sizeof...(A) - (has_rest ? 1 : 0);
+
+    static_assert(std::is_void_v<R> || std::is_integral_v<R>,
+                  "gm_cli command must return void or an integer");
+
+    /* 解析第I个参数，失败时输出提示 */
+    template <std::size_t I, typename T>
+    static bool parse_at(int argc, char* argv[], T& val)
+    {
+        if constexpr (std::is_same_v<T, rest>)
+        {
+            val.argc = argc - 1 - fixed;
+            val.argv = &argv[1 + fixed];
+            return true;
+        }
+        else
+        {
+            if (parse(argv[1 + I], val))
+            {
+                return true;
+            }
+            gm_cli_printf("%s: invalid argument %d \"%s\"\r\n", argv[0], (int)(I + 1), argv[1 + I]);
+            return false;
+        }
+    }
+
+    template <std::size_t... I>
+    static int invoke(int argc, char* argv[], std::index_sequence<I...>)
+    {
+        std::tuple<arg_t<A>...> vals;
+
+        (void)argc;
+        (void)argv;
+        if (!(parse_at<I>(argc, argv, std::get<I>(vals)) && ...))
+        {
+            return -1;
+        }
+        if constexpr (std::is_void_v<R>)
+        {
+            F(std::get<I>(vals)...);
+            return 0;
+        }
+        else
+        {
+            return (int)F(std::get<I>(vals)...);
+        }
+    }
+
+    static int call(int argc, char* argv[])
+    {
+        if ((argc - 1 < fixed) || (!has_rest && (argc - 1 > fixed)))
+        {
+            gm_cli_printf("%s: expected %s%d arguments, got %d, see help %s\r\n", argv[0],
+                          has_rest ? "at least " : "", fixed, argc - 1, argv[0]);
+            return -1;
+        }
+        return invoke(argc, argv, std::index_sequence_for<A...>{});
+    }
+};
+
+} /* namespace detail */
+
+/* 生成命令，F为函数或constexpr的lambda，参数按F的参数类型解析 */
+template <auto& F>
+constexpr gm_cli_cmd_t cmd(const char* const name, const char* const usage,
+                           const unsigned int flags = 0, const unsigned int ttl_ms = 0,
+                           const unsigned int budget_ms = 0)
+{
+    gm_cli_cmd_t c{};
+
+    c.name = const_cast<char*>(name);
+    c.usage = const_cast<char*>(usage);
+    c.cb = &detail::thunk<F>::call;
+    c.flags = flags;
+    c.ttl_ms = ttl_ms;
+    c.budget_ms = budget_ms;
+    return c;
+}
+
+/* 生成C回调的命令，用于把C命令放入C++命令表 */
+constexpr gm_cli_cmd_t cmd(const char* const name, const char* const usage,
+                           gm_cli_cmd_cb_t* const cb, const unsigned int flags = 0,
+                           const unsigned int ttl_ms = 0, const unsigned int budget_ms = 0)
+{
+    gm_cli_cmd_t c{};
+
+    c.name = const_cast<char*>(name);
+    c.usage = const_cast<char*>(usage);
+    c.cb = cb;
+    c.flags = flags;
+    c.ttl_ms = ttl_ms;
+    c.budget_ms = budget_ms;
+    return c;
+}
+
+/* 编译期生成的命令表，按命令名排序，只含命令数组，可以直接放入命令段 */
+template <std::size_t N>
+struct table
+{
+    gm_cli_cmd_t cmd[N];
+
+    constexpr std::size_t size() const { return N; }
+    constexpr const gm_cli_cmd_t* begin() const { return &cmd[0]; }
+    constexpr const gm_cli_cmd_t* end() const { return &cmd[0] + N; }
+
+    /* 二分查找命令，没有时返回nullptr */
+    constexpr const gm_cli_cmd_t* find(const char* const name) const
+    {
+        std::size_t lo = 0, hi = N, mid = 0;
+        int diff = 0;
+
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            diff = detail::str_cmp(cmd[mid].name, name);
+            if (diff == 0)
+            {
+                return &cmd[mid];
+            }
+            if (diff < 0)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/* 生成命令表，按命令名排序，命令名重复时编译报错 */
+template <typename... C>
+constexpr table<sizeof...(C)> make_table(const C&... cmds)
+{
+    static_assert(sizeof...(C) > 0, "empty gm_cli command table");
+    table<sizeof...(C)> t{ { cmds... } };
+    gm_cli_cmd_t tmp{};
+    std::size_t i = 0, j = 0;
+
+    /* 命令数不多，插入排序 */
+    for (i = 1; i < sizeof...(C); i++)
+    {
+        tmp = t.cmd[i];
+        for (j = i; (j > 0) && (detail::str_cmp(t.cmd[j - 1].name, tmp.name) > 0); j--)
+        {
+            t.cmd[j] = t.cmd[j - 1];
+        }
+        t.cmd[j] = tmp;
+    }
+    for (i = 1; i < sizeof...(C); i++)
+    {
+        if (detail::str_cmp(t.cmd[i - 1].name, t.cmd[i].name) == 0)
+        {
+            detail::duplicate_command_name();
+        }
+    }
+    return t;
+}
+
+} /* namespace gm_cli */
+
+/* 命令表放入命令段的属性，和gm_cli.h中GM_CLI_CMD_EXPORT的段一致 */
+#if (GM_CLI_CC == GM_CLI_CC_MDK_ARM)
+#define GM_CLI_CPP_SECTION                                                     \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))
+#elif ((GM_CLI_CC == GM_CLI_CC_IAR_STM8) || (GM_CLI_CC == GM_CLI_CC_IAR_ARM))
+#define GM_CLI_CPP_SECTION                                                     \
+        _Pragma("location = \".gm_cli_cmd_section\"") __root
+#elif (GM_CLI_CC == GM_CLI_CC_GCC_LINUX)
+#define GM_CLI_CPP_SECTION                                                     \
+        __attribute__((used)) __attribute__((section("gm_cli_cmd_section")))   \
+        __attribute__((aligned(sizeof(void*))))
+#elif (GM_CLI_CC == GM_CLI_CC_MINGW)
+#define GM_CLI_CPP_SECTION                                                     \
+        __attribute__((used)) __attribute__((section(".gm_cli_cmd_section$b")))\
+        __attribute__((aligned(sizeof(void*))))
+#elif (GM_CLI_CC == GM_CLI_CC_VS)
+#define GM_CLI_CPP_SECTION                                                     \
+        __declspec(allocate(".gm_cli_cmd_section$b"))
+#endif
+
+/* 段方式注册时导出命令表，静态注册时命令直接放入gm_cli_static_cmds */
+#ifdef GM_CLI_CPP_SECTION
+#define GM_CLI_CPP_EXPORT(tbl_name, ...)                                       \
+        GM_CLI_CPP_SECTION static constexpr auto tbl_name =                    \
+            ::gm_cli::make_table(__VA_ARGS__)
+#endif  /* GM_CLI_CPP_SECTION */
+
+#endif  /* __GM_CLI_HPP__ */
@@ -10,6 +10,64 @@
 **                                                             <Tom Free 付瑞彪>
 **           2021-06-17 -> 增加自动命令注册和静态注册选项
 **                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加管道配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出重定向配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加行存储区配置，行长度可运行时修改
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加括号粘贴模式配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加二进制帧协议模式配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加结构化输出配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令输出缓存配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加周期命令配置选项，默认参数个数改为10
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令查找索引和运行时别名配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加精简配置和紧凑位宽选项，配置项均可在编译选项中覆盖
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内部跟踪配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令提示配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加后台日志配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加输出调度配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加会话录制配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令执行时间预算配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加批量并行执行配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加变量配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加循环命令配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加命令插件配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加共享内存控制通道配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内存命令配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加函数调用命令配置选项
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 内存命令默认关闭
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 格式选项只对带EMIT标志的命令在末尾解析，嵌套超限报错
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> GM_CLI_VAR_SEG_MAX改为按一级命令的参数计算
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 默认配置关闭全部可选功能，增加完整配置和会话保存开关
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加GM_CLI_WDOG_NAME_MAX
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 精简格式化说明增加ll修饰和不支持的转换的处理
+**                                                             <Tom Free 付瑞彪>
 **
 **              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
 **
@@ -18,27 +76,515 @@
 #ifndef __GM_CLI_CFG_H__
 #define __GM_CLI_CFG_H__
 
+/* 默认配置和加入可选功能之前的资源占用相当：可选功能全部关闭，行长度64，参数最多5个，
+ * 需要的功能在编译选项中单独打开，以下所有配置项都可以在编译选项中单独定义
+ * （如-DGM_CLI_WATCH_EN=1u）来覆盖默认值，各项资源占用见README */
+
+/* 是否使用完整配置，用于Linux宿主程序或资源充足的平台，打开管道、重定向、括号粘贴、
+ * 二进制帧、结构化输出、输出缓存、周期命令、命令索引、别名、变量、循环命令、命令
+ * 建议、日志、执行时间预算和会话保存，加大行缓存和参数个数 */
+#ifndef GM_CLI_PROFILE_FULL
+#define GM_CLI_PROFILE_FULL             0u
+#endif
+
+/* 是否使用精简配置，用于RAM只有几KB的单片机，在默认配置的基础上缩小行存储区和历史
+ * 记录，打印函数不使用缓存，状态变量使用紧凑的位宽 */
+#ifndef GM_CLI_PROFILE_COMPACT
+#define GM_CLI_PROFILE_COMPACT          0u
+#endif
+
+#if GM_CLI_PROFILE_FULL && GM_CLI_PROFILE_COMPACT
+#error "GM_CLI_PROFILE_FULL and GM_CLI_PROFILE_COMPACT can not be used together"
+#endif
+
+#if GM_CLI_PROFILE_FULL
+#ifndef GM_CLI_LINE_CHAR_MAX
+#define GM_CLI_LINE_CHAR_MAX            128u
+#endif
+#ifndef GM_CLI_LINE_ARENA_SIZE
+#define GM_CLI_LINE_ARENA_SIZE          1024u
+#endif
+#ifndef GM_CLI_CMD_ARGS_NUM_MAX
+#define GM_CLI_CMD_ARGS_NUM_MAX         10u
+#endif
+#ifndef GM_CLI_PIPE_EN
+#define GM_CLI_PIPE_EN                  1u
+#endif
+#ifndef GM_CLI_REDIRECT_EN
+#define GM_CLI_REDIRECT_EN              1u
+#endif
+#ifndef GM_CLI_BRACKETED_PASTE_EN
+#define GM_CLI_BRACKETED_PASTE_EN       1u
+#endif
+#ifndef GM_CLI_BIN_EN
+#define GM_CLI_BIN_EN                   1u
+#endif
+#ifndef GM_CLI_EMIT_EN
+#define GM_CLI_EMIT_EN                  1u
+#endif
+#ifndef GM_CLI_CACHE_EN
+#define GM_CLI_CACHE_EN                 1u
+#endif
+#ifndef GM_CLI_WATCH_EN
+#define GM_CLI_WATCH_EN                 1u
+#endif
+#ifndef GM_CLI_CMD_INDEX_SIZE
+#define GM_CLI_CMD_INDEX_SIZE           64u
+#endif
+#ifndef GM_CLI_ALIAS_EN
+#define GM_CLI_ALIAS_EN                 1u
+#endif
+#ifndef GM_CLI_VAR_EN
+#define GM_CLI_VAR_EN                   1u
+#endif
+#ifndef GM_CLI_LOOP_EN
+#define GM_CLI_LOOP_EN                  1u
+#endif
+#ifndef GM_CLI_SUGGEST_EN
+#define GM_CLI_SUGGEST_EN               1u
+#endif
+#ifndef GM_CLI_LOG_EN
+#define GM_CLI_LOG_EN                   1u
+#endif
+#ifndef GM_CLI_BUDGET_EN
+#define GM_CLI_BUDGET_EN                1u
+#endif
+#ifndef GM_CLI_SESSION_EN
+#define GM_CLI_SESSION_EN               1u
+#endif
+#endif  /* GM_CLI_PROFILE_FULL */
+
+#if GM_CLI_PROFILE_COMPACT
+#ifndef GM_CLI_LINE_ARENA_SIZE
+#define GM_CLI_LINE_ARENA_SIZE          256u
+#endif
+#ifndef GM_CLI_PRINTF_BUF_MAX
+#define GM_CLI_PRINTF_BUF_MAX           0u
+#endif
+#ifndef GM_CLI_HISTORY_LINE_MAX
+#define GM_CLI_HISTORY_LINE_MAX         4u
+#endif
+#ifndef GM_CLI_PACKED_EN
+#define GM_CLI_PACKED_EN                1u
+#endif
+#endif  /* GM_CLI_PROFILE_COMPACT */
+
 /* 是否通过编译器段自动注册命令
  * 1、如果编译器是系统已配置可以使用的编译器就可以配置此处为1，然后可以使用
  *    EXPORT和ALIAS宏来导出命令，这个也是最好的方式，可以降低文件耦合性，但需要
  *    了解编译器段分配原理和使用方式，目前系统仅支持几个主流编译器；
  * 2、如果编译器是系统未支持的就必须配置此处为0，然后在应用层提供注册的命令表，
  *    此种方式可以支持任意的编译器，但会增加程序耦合性 */
+#ifndef GM_CLI_CMD_REG_BY_CC_SECTION
 #define GM_CLI_CMD_REG_BY_CC_SECTION    0u
+#endif
 
-/* 一行的最大输入字符数，包括一个\0，实际需要减一 */
+/* 默认一行的最大输入字符数，包括一个\0，实际需要减一，
+ * 运行时可通过gm_cli_set_line_arena重新设置 */
+#ifndef GM_CLI_LINE_CHAR_MAX
 #define GM_CLI_LINE_CHAR_MAX            64u
+#endif
+
+/* 默认行存储区大小，依次分配给行缓存、历史翻查时的备份行和历史记录存储池，
+ * 历史记录按实际长度存放，至少需要3倍GM_CLI_LINE_CHAR_MAX */
+#ifndef GM_CLI_LINE_ARENA_SIZE
+#define GM_CLI_LINE_ARENA_SIZE          768u
+#endif
 
 /* 最长的输入命令参数总数，包括命令本身 */
+#ifndef GM_CLI_CMD_ARGS_NUM_MAX
 #define GM_CLI_CMD_ARGS_NUM_MAX         5u
+#endif
 
-/* 打印函数buf大小，需要大于能够打印的最大长度，建议使用打印函数时长度不要过长 */
+/* 打印函数buf大小，超出部分截断，建议使用打印函数时长度不要过长，配置为0时不使用
+ * 缓存和C库的格式化函数，由内置的精简格式化边解析边输出，支持%d %i %u %x %X %c
+ * %s %p %%，支持'-'、'0'、宽度和l、ll、h修饰，%s支持精度，遇到不支持的转换（如%f）
+ * 时无法确定参数大小，从该处开始原样输出格式串的剩余部分 */
+#ifndef GM_CLI_PRINTF_BUF_MAX
 #define GM_CLI_PRINTF_BUF_MAX           128u
+#endif
 
-/* 最大的备份行数，用于历史记录 */
+/* 最大的备份行数，用于历史记录，实际能保存的条数还受历史记录存储池大小限制 */
+#ifndef GM_CLI_HISTORY_LINE_MAX
 #define GM_CLI_HISTORY_LINE_MAX         10u
+#endif
+
+/* 是否使用紧凑的状态变量位宽，行缓存位置和历史记录信息使用16位，历史记录计数使用
+ * 8位，此时行存储区不能超过65535字节，历史记录条数不能超过255 */
+#ifndef GM_CLI_PACKED_EN
+#define GM_CLI_PACKED_EN                0u
+#endif
 
 /* 默认命令提示符 */
+#ifndef GM_CLI_DEFAULT_CMD_PROMPT
 #define GM_CLI_DEFAULT_CMD_PROMPT       "[CLI] > "
+#endif
+
+/* 是否使能管道功能，使能后可使用"cmd | grep xxx | head 5"的形式过滤命令输出 */
+#ifndef GM_CLI_PIPE_EN
+#define GM_CLI_PIPE_EN                  0u
+#endif
+
+/* 一条命令行最多的管道级数，包括命令本身 */
+#ifndef GM_CLI_PIPE_STAGE_MAX
+#define GM_CLI_PIPE_STAGE_MAX           4u
+#endif
+
+/* 管道每一级的行缓存大小，超出此长度的行会被拆分处理 */
+#ifndef GM_CLI_PIPE_LINE_BUF_MAX
+#define GM_CLI_PIPE_LINE_BUF_MAX        128u
+#endif
+
+/* tail过滤器保留的最大字节数，只保留输出末尾的这部分数据 */
+#ifndef GM_CLI_PIPE_TAIL_BUF_MAX
+#define GM_CLI_PIPE_TAIL_BUF_MAX        512u
+#endif
+
+/* 是否使能输出重定向功能，使能后可使用"cmd > file"和"cmd >> file"将输出写入文件，
+ * 依赖POSIX文件接口，仅Linux下有效，其他平台自动忽略此配置 */
+#ifndef GM_CLI_REDIRECT_EN
+#define GM_CLI_REDIRECT_EN              0u
+#endif
+
+/* 输出重定向的文件写缓存大小，输出数据攒满一块再写入文件，建议为页大小的整数倍 */
+#ifndef GM_CLI_REDIRECT_BUF_SIZE
+#define GM_CLI_REDIRECT_BUF_SIZE        4096u
+#endif
+
+/* 是否使能括号粘贴模式，启动时开启终端的括号粘贴模式，粘贴的内容批量插入，
+ * 每行只回显一次，内容中的Tab和控制字符不会触发按键处理，终端不支持时无影响 */
+#ifndef GM_CLI_BRACKETED_PASTE_EN
+#define GM_CLI_BRACKETED_PASTE_EN       0u
+#endif
+
+/* 是否使能二进制帧协议模式，供自动化测试设备使用，收到进入序列后切换为帧收发，
+ * 不回显、不编辑、不输出提示符，帧格式见README */
+#ifndef GM_CLI_BIN_EN
+#define GM_CLI_BIN_EN                   0u
+#endif
+
+/* 二进制帧模式请求帧中命令行的最大长度 */
+#ifndef GM_CLI_BIN_FRAME_MAX
+#define GM_CLI_BIN_FRAME_MAX            256u
+#endif
+
+/* 二进制帧模式响应帧中捕获输出的最大长度，超出部分截断 */
+#ifndef GM_CLI_BIN_RSP_MAX
+#define GM_CLI_BIN_RSP_MAX              1024u
+#endif
+
+/* 是否使能结构化输出接口，命令通过gm_cli_emit_xxx输出，可按文本、JSON或CBOR格式
+ * 输出，带GM_CLI_CMD_FLAG_EMIT标志的命令末尾加--text、--json或--cbor可以单独指定
+ * 本次的格式 */
+#ifndef GM_CLI_EMIT_EN
+#define GM_CLI_EMIT_EN                  0u
+#endif
+
+/* 结构化输出的最大嵌套层数，不能超过16 */
+#ifndef GM_CLI_EMIT_DEPTH_MAX
+#define GM_CLI_EMIT_DEPTH_MAX           8u
+#endif
+
+/* 是否使能命令输出缓存，带GM_CLI_CMD_FLAG_IDEMPOTENT标志的命令在ttl_ms内以相同
+ * 参数执行时直接输出缓存，不再执行命令，需要设置时基回调 */
+#ifndef GM_CLI_CACHE_EN
+#define GM_CLI_CACHE_EN                 0u
+#endif
+
+/* 输出缓存条数 */
+#ifndef GM_CLI_CACHE_ENTRY_NUM
+#define GM_CLI_CACHE_ENTRY_NUM          4u
+#endif
+
+/* 每条缓存的输出数据大小，输出超过此大小的不缓存 */
+#ifndef GM_CLI_CACHE_BUF_SIZE
+#define GM_CLI_CACHE_BUF_SIZE           1024u
+#endif
+
+/* 缓存键（命令及参数）的最大长度 */
+#ifndef GM_CLI_CACHE_KEY_MAX
+#define GM_CLI_CACHE_KEY_MAX            64u
+#endif
+
+/* 是否使能周期命令watch，由gm_cli_poll驱动，需要设置时基回调 */
+#ifndef GM_CLI_WATCH_EN
+#define GM_CLI_WATCH_EN                 0u
+#endif
+
+/* 同时存在的周期命令数量 */
+#ifndef GM_CLI_WATCH_NUM
+#define GM_CLI_WATCH_NUM                4u
+#endif
+
+/* 周期命令及参数的最大长度 */
+#ifndef GM_CLI_WATCH_LINE_MAX
+#define GM_CLI_WATCH_LINE_MAX           64u
+#endif
+
+/* 时间轮节拍，单位ms，周期命令的时间精度 */
+#ifndef GM_CLI_WATCH_TICK_MS
+#define GM_CLI_WATCH_TICK_MS            10u
+#endif
+
+/* 时间轮每层槽数的位数，两层时间轮，最长定时为(1 << (2 * 位数))个节拍，
+ * 超过的分多轮到期 */
+#ifndef GM_CLI_WATCH_WHEEL_BITS
+#define GM_CLI_WATCH_WHEEL_BITS         6u
+#endif
+
+/* 命令查找哈希索引大小，必须为2的幂，应大于命令数量（含运行时别名），不够时自动
+ * 改为逐个查找，0表示不使用索引 */
+#ifndef GM_CLI_CMD_INDEX_SIZE
+#define GM_CLI_CMD_INDEX_SIZE           0u
+#endif
+
+/* 是否使能运行时别名alias，可以绑定参数，多条命令以';'分隔 */
+#ifndef GM_CLI_ALIAS_EN
+#define GM_CLI_ALIAS_EN                 0u
+#endif
+
+/* 运行时别名的最大数量 */
+#ifndef GM_CLI_ALIAS_NUM
+#define GM_CLI_ALIAS_NUM                8u
+#endif
+
+/* 运行时别名存储区大小，存放名字、定义和解析好的参数 */
+#ifndef GM_CLI_ALIAS_ARENA_SIZE
+#define GM_CLI_ALIAS_ARENA_SIZE         512u
+#endif
+
+/* 是否使能会话保存，gm_cli_session_save和gm_cli_session_restore保存和恢复输出格式、
+ * 别名、变量和历史记录 */
+#ifndef GM_CLI_SESSION_EN
+#define GM_CLI_SESSION_EN               0u
+#endif
+
+/* 是否使能变量，set name value定义变量，命令行中的$name和${name}替换为变量值 */
+#ifndef GM_CLI_VAR_EN
+#define GM_CLI_VAR_EN                   0u
+#endif
+
+/* 变量哈希表大小，必须为2的幂，最多存放GM_CLI_VAR_NUM - 1个变量 */
+#ifndef GM_CLI_VAR_NUM
+#define GM_CLI_VAR_NUM                  16u
+#endif
+
+/* 变量名最大长度，含'\0' */
+#ifndef GM_CLI_VAR_NAME_MAX
+#define GM_CLI_VAR_NAME_MAX             16u
+#endif
+
+/* 变量值最大长度，含'\0' */
+#ifndef GM_CLI_VAR_VALUE_MAX
+#define GM_CLI_VAR_VALUE_MAX            32u
+#endif
+
+/* 一级命令的参数编译成模板后的最大段数，原样复制的一段或一个变量各占一段 */
+#ifndef GM_CLI_VAR_SEG_MAX
+#define GM_CLI_VAR_SEG_MAX              16u
+#endif
+
+/* 是否使能循环命令repeat和for，循环体只分割和查找一次，每次直接调用命令，结束时输出
+ * 执行速率和命令耗时，计时使用GM_CLI_TRACE_CYCLES计数器，for需要GM_CLI_VAR_EN */
+#ifndef GM_CLI_LOOP_EN
+#define GM_CLI_LOOP_EN                  0u
+#endif
+
+/* 是否使能内存命令md、mw和mcmp，按字节、半字或字宽度访问任意地址，地址不可访问时
+ * 会触发硬件异常，md用查表的十六进制格式化一次输出一整行；mw可以写任意地址，
+ * 共享内存控制通道等其他输入也能执行，默认关闭，调试时再打开 */
+#ifndef GM_CLI_MEM_EN
+#define GM_CLI_MEM_EN                   0u
+#endif
+
+/* md每次最多格式化的行数，输出调度使能且直接输出到终端时，剩余的行在gm_cli_poll中
+ * 等批量输出发送完后继续格式化；预算使能时每次检查一次是否中止 */
+#ifndef GM_CLI_MEM_CHUNK_ROWS
+#define GM_CLI_MEM_CHUNK_ROWS           16u
+#endif
+
+/* mcmp最多列出的不同之处，超过后只计数 */
+#ifndef GM_CLI_MEM_DIFF_MAX
+#define GM_CLI_MEM_DIFF_MAX             16u
+#endif
+
+/* 是否使能函数调用命令call，在按名称排序的函数符号表中二分查找函数，参数转换为整数、
+ * 符号地址或字符串指针后调用并计时，计时使用GM_CLI_TRACE_CYCLES计数器；符号表由
+ * tools/gm_cli_symgen.sh在编译时生成，用gm_cli_set_sym_table设置 */
+#ifndef GM_CLI_CALL_EN
+#define GM_CLI_CALL_EN                  0u
+#endif
+
+/* 是否使能命令提示，找不到命令时按编辑距离列出相近的命令，初始化时用命令名建立BK树，
+ * 提示时只需要和少量命令比较 */
+#ifndef GM_CLI_SUGGEST_EN
+#define GM_CLI_SUGGEST_EN               0u
+#endif
+
+/* BK树节点数，每个命令占用一个，应不少于命令数量，不够时改为逐个比较，不能超过65535 */
+#ifndef GM_CLI_SUGGEST_NODE_NUM
+#define GM_CLI_SUGGEST_NODE_NUM         128u
+#endif
+
+/* 提示的最大编辑距离，输入不超过3个字符时固定为1 */
+#ifndef GM_CLI_SUGGEST_DIST_MAX
+#define GM_CLI_SUGGEST_DIST_MAX         2u
+#endif
+
+/* 最多提示的命令数 */
+#ifndef GM_CLI_SUGGEST_NUM
+#define GM_CLI_SUGGEST_NUM              3u
+#endif
+
+/* 是否使能后台日志gm_cli_log，其他线程的日志先放入无锁队列，由gm_cli_poll批量输出，
+ * 输出前擦除输入行，输出后重绘，不会打断正在输入的命令 */
+#ifndef GM_CLI_LOG_EN
+#define GM_CLI_LOG_EN                   0u
+#endif
+
+/* 日志队列条数，必须为2的幂，队列满时新的日志被丢弃并计数 */
+#ifndef GM_CLI_LOG_NUM
+#define GM_CLI_LOG_NUM                  16u
+#endif
+
+/* 每条日志的最大长度，包括'\0'，超出部分截断 */
+#ifndef GM_CLI_LOG_LINE_MAX
+#define GM_CLI_LOG_LINE_MAX             96u
+#endif
+
+/* 编译器不是GCC、Clang或VC时，日志队列的原子操作使用此临界区保护，
+ * 单片机上一般为关中断和开中断，默认为空，此时只能在同一个线程中使用 */
+#ifndef GM_CLI_LOG_LOCK
+#define GM_CLI_LOG_LOCK()
+#endif
+#ifndef GM_CLI_LOG_UNLOCK
+#define GM_CLI_LOG_UNLOCK()
+#endif
+
+/* 是否使能命令执行时间预算，命令执行超过预算时gm_cli_should_abort返回1，命令返回后
+ * 提示并计入统计，gm_cli_request_abort可在其他线程或中断中请求中止正在执行的命令，
+ * 需要设置时基回调 */
+#ifndef GM_CLI_BUDGET_EN
+#define GM_CLI_BUDGET_EN                0u
+#endif
+
+/* 命令没有指定预算时使用的默认预算，单位ms，配置为0时不限制 */
+#ifndef GM_CLI_CMD_BUDGET_MS
+#define GM_CLI_CMD_BUDGET_MS            0u
+#endif
+
+/* wdog命令显示的最后一次超过预算的命令名的保存长度，含'\0'，超出部分截断，命令名
+ * 复制保存，插件卸载后仍可显示 */
+#ifndef GM_CLI_WDOG_NAME_MAX
+#define GM_CLI_WDOG_NAME_MAX            16u
+#endif
+
+/* 是否使能批量并行执行gm_cli_batch，脚本中连续的可重入命令由线程池并行执行，输出
+ * 按命令顺序输出，需要POSIX线程和GCC或Clang，一般用于Linux宿主程序 */
+#ifndef GM_CLI_BATCH_EN
+#define GM_CLI_BATCH_EN                 0u
+#endif
+
+/* 批量执行的最大线程数 */
+#ifndef GM_CLI_BATCH_THREAD_MAX
+#define GM_CLI_BATCH_THREAD_MAX         16u
+#endif
+
+/* 同时在执行或等待输出的最大命令数 */
+#ifndef GM_CLI_BATCH_WINDOW
+#define GM_CLI_BATCH_WINDOW             64u
+#endif
+
+/* 并行执行的每条命令的最大输出字节数，超出部分截断 */
+#ifndef GM_CLI_BATCH_OUT_MAX
+#define GM_CLI_BATCH_OUT_MAX            1024u
+#endif
+
+/* 是否使能命令插件，运行时用dlopen加载共享库中的命令，查找索引在另一份中重建后
+ * 原子切换，卸载时等待正在执行的命令结束，需要Linux和GCC或Clang，链接时加-ldl */
+#ifndef GM_CLI_PLUGIN_EN
+#define GM_CLI_PLUGIN_EN                0u
+#endif
+
+/* 同时加载的最大插件数 */
+#ifndef GM_CLI_PLUGIN_NUM
+#define GM_CLI_PLUGIN_NUM               4u
+#endif
+
+/* 插件路径最大长度，包括'\0' */
+#ifndef GM_CLI_PLUGIN_PATH_MAX
+#define GM_CLI_PLUGIN_PATH_MAX          64u
+#endif
+
+/* 是否使能共享内存控制通道，本机其他进程通过共享内存中的环形缓存提交命令和取回输出，
+ * 不经过终端，需要Linux和GCC或Clang，较老的glibc链接时加-lrt */
+#ifndef GM_CLI_SHM_EN
+#define GM_CLI_SHM_EN                   0u
+#endif
+
+/* 请求和应答环形缓存各自的字节数，必须为2的幂 */
+#ifndef GM_CLI_SHM_SIZE
+#define GM_CLI_SHM_SIZE                 65536u
+#endif
+
+/* 每条命令的最大输出字节数，超出部分截断，不能超过GM_CLI_SHM_SIZE的一半 */
+#ifndef GM_CLI_SHM_OUT_MAX
+#define GM_CLI_SHM_OUT_MAX              4096u
+#endif
+
+/* 每次gm_cli_poll最多执行的请求数 */
+#ifndef GM_CLI_SHM_BURST
+#define GM_CLI_SHM_BURST                64u
+#endif
+
+/* 是否使能输出调度，按键回显和控制输出立即发送，命令输出先放入批量缓存，由gm_cli_poll
+ * 按速率分块发送，发送完成后再显示提示符，Ctrl-C丢弃未发送的命令输出，
+ * 使能后需要在主循环中调用gm_cli_poll */
+#ifndef GM_CLI_OUT_SCHED_EN
+#define GM_CLI_OUT_SCHED_EN             0u
+#endif
+
+/* 批量输出缓存大小，缓存满时按终端速度同步发送 */
+#ifndef GM_CLI_OUT_BULK_BUF_SIZE
+#define GM_CLI_OUT_BULK_BUF_SIZE        2048u
+#endif
+
+/* 每次gm_cli_poll最多发送的批量输出字节数 */
+#ifndef GM_CLI_OUT_BULK_CHUNK
+#define GM_CLI_OUT_BULK_CHUNK           64u
+#endif
+
+/* 批量输出速率限制，每ms字节数，需要设置时基回调，配置为0时不限制，
+ * 如115200波特率的串口约为11 */
+#ifndef GM_CLI_OUT_BULK_RATE
+#define GM_CLI_OUT_BULK_RATE            0u
+#endif
+
+/* 是否使能会话录制，gm_cli_rec_start开始后，输入的字符和终端输出带时间戳写入紧凑的
+ * 二进制记录，用于回放对比和性能回归测试 */
+#ifndef GM_CLI_REC_EN
+#define GM_CLI_REC_EN                   0u
+#endif
+
+/* 会话录制合并缓存大小，同一毫秒内同方向的数据合并为一条记录 */
+#ifndef GM_CLI_REC_BUF_SIZE
+#define GM_CLI_REC_BUF_SIZE             64u
+#endif
+
+/* 是否使能内部跟踪，在字符解析、功能码解码、重绘、命令查找、命令回调和终端输出等处
+ * 记录带时间戳的事件到环形缓存，用trace dump命令导出，配置为0时跟踪代码全部去掉 */
+#ifndef GM_CLI_TRACE_EN
+#define GM_CLI_TRACE_EN                 0u
+#endif
+
+/* 跟踪环形缓存的事件数，必须为2的幂，每个事件8字节 */
+#ifndef GM_CLI_TRACE_NUM
+#define GM_CLI_TRACE_NUM                256u
+#endif
+
+/* 跟踪时间戳和循环命令计时的计数器，未定义时Linux x86使用rdtsc，ARM64使用cntvct_el0，其他平台使用
+ * 时基回调（单位ms），只保存低32位，Cortex-M3以上可以使用DWT周期计数器（需先使能）：
+ * #define GM_CLI_TRACE_CYCLES()       (*(volatile unsigned long*)0xE0001004)
+ * #define GM_CLI_TRACE_CLOCK_NAME     "dwt" */
 
 #endif  /* __GM_CLI_CFG_H__ */
@@ -0,0 +1,469 @@
+/*******************************************************************************
+** 文件名称：gm_cli_shm.h
+** 文件作用：通用命令行接口共享内存控制通道
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：服务端（gm_cli.c，GM_CLI_SHM_EN为1）和其他进程中的客户端共用本文件，
+**           客户端只需要包含本文件，不需要链接gm_cli.c，仅Linux下可用
+**
+**           共享内存由服务端gm_cli_shm_open创建，依次为头部、请求缓存和应答缓存，
+**           两个缓存都是单生产者单消费者的环形缓存，位置为不回绕的字节计数，
+**           记录按16字节对齐，末尾放不下时写入填充记录后从头开始；
+**           应答的输出由命令直接写入应答缓存，不经过中间缓存；
+**           等待的一方置位等待标志后在门铃上futex等待，另一方更新位置后敲门铃，
+**           只有发现等待标志时才唤醒，连续提交时没有系统调用
+**
+**           客户端使用范例：
+**           gm_cli_shm_client_t cli;
+**           char out[256];
+**           int ret;
+**           if (gm_cli_shm_client_open(&cli, "/gm_cli") == 0)
+**           {
+**               gm_cli_shm_client_exec(&cli, "test 1 2", out, sizeof(out), &ret, 1000);
+**               gm_cli_shm_client_close(&cli);
+**           }
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     ANSI C Language(C99)
+*******************************************************************************/
+#ifndef __GM_CLI_SHM_H__
+#define __GM_CLI_SHM_H__
+
+/* syscall、clock_gettime等在-std=c99下需要，客户端应首先包含本文件 */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "stdint.h"
+#include "string.h"
+#include "errno.h"
+#include "limits.h"
+#include "signal.h"
+#include "time.h"
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "sys/syscall.h"
+#include "linux/futex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GM_CLI_SHM_MAGIC            0x53434D47u     /* "GMCS" */
+#define GM_CLI_SHM_VERSION          1u              /* 布局版本 */
+#define GM_CLI_SHM_ALIGN            16u             /* 记录对齐 */
+#define GM_CLI_SHM_PAD              0xFFFFFFFFu     /* 填充记录的长度 */
+
+/* 应答标志 */
+#define GM_CLI_SHM_FLAG_FAIL        0x01u   /* 命令未执行，命令不存在或命令行错误 */
+#define GM_CLI_SHM_FLAG_TRUNC       0x02u   /* 输出被截断 */
+
+/* 环形缓存位置，生产者和消费者各占一个缓存行 */
+typedef struct
+{
+    uint32_t               head;                         /* 已写入字节数，生产者更新 */
+    uint32_t               pad0[15];
+    uint32_t               tail;                         /* 已读出字节数，消费者更新 */
+    uint32_t               pad1[15];
+} gm_cli_shm_ring_t;
+
+/* 门铃，对端有新数据或空出空间时加1，等待标志置位时唤醒 */
+typedef struct
+{
+    uint32_t               bell;                         /* 门铃计数，futex等待的位置 */
+    uint32_t               wait;                         /* 是否在等待 */
+    uint32_t               pad[14];
+} gm_cli_shm_bell_t;
+
+/* 共享内存头部，之后依次为请求缓存和应答缓存的数据区 */
+typedef struct
+{
+    uint32_t               magic;                        /* 标识 */
+    uint32_t               version;                      /* 布局版本 */
+    uint32_t               size;                         /* 每个缓存的数据区字节数，2的幂 */
+    uint32_t               out_max;                      /* 每条应答的最大输出字节数 */
+    uint32_t               server;                       /* 服务端进程号 */
+    uint32_t               client;                       /* 占用通道的客户端进程号，0为空闲 */
+    uint32_t               pad[10];
+    gm_cli_shm_bell_t      srv;                          /* 服务端门铃 */
+    gm_cli_shm_bell_t      cli;                          /* 客户端门铃 */
+    gm_cli_shm_ring_t      req;                          /* 请求缓存，客户端写入 */
+    gm_cli_shm_ring_t      rsp;                          /* 应答缓存，服务端写入 */
+} gm_cli_shm_hdr_t;
+
+/* 记录头，之后为命令行或命令输出 */
+typedef struct
+{
+    uint32_t               len;                          /* 数据长度，不含记录头 */
+    uint32_t               seq;                          /* 请求序号，应答中为对应请求的序号 */
+    int32_t                ret;                          /* 应答中为命令返回值 */
+    uint32_t               flags;                        /* 应答标志 */
+} gm_cli_shm_rec_t;
+
+/* 数据区和共享内存大小 */
+#define GM_CLI_SHM_REQ_DATA(p_hdr)  ((unsigned char*)(p_hdr) + sizeof(gm_cli_shm_hdr_t))
+#define GM_CLI_SHM_RSP_DATA(p_hdr)  (GM_CLI_SHM_REQ_DATA(p_hdr) + (p_hdr)->size)
+#define GM_CLI_SHM_MAP_SIZE(size)   (sizeof(gm_cli_shm_hdr_t) + 2 * (size_t)(size))
+
+/* 记录占用的字节数 */
+static inline uint32_t gm_cli_shm_rec_size(const uint32_t len)
+{
+    return (uint32_t)((sizeof(gm_cli_shm_rec_t) + len + GM_CLI_SHM_ALIGN - 1) &
+                      ~(uint32_t)(GM_CLI_SHM_ALIGN - 1));
+}
+
+/* 生产者判断能否写入len字节的记录，返回记录偏移，放不下时返回-1 */
+static inline long gm_cli_shm_space(const gm_cli_shm_ring_t* const p_ring, const uint32_t size,
+                                    const uint32_t len)
+{
+    uint32_t head = p_ring->head;
+    uint32_t used = head - __atomic_load_n(&p_ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t off = head & (size - 1);
+    uint32_t need = gm_cli_shm_rec_size(len);
+
+    /* 末尾放不下时跳过末尾的空间 */
+    if (size - off < need)
+    {
+        return (size - used >= size - off + need) ? 0 : -1;
+    }
+    return (size - used >= need) ? (long)off : -1;
+}
+
+/* 生产者预留len字节的记录，放不下时返回NULL */
+static inline gm_cli_shm_rec_t* gm_cli_shm_reserve(gm_cli_shm_ring_t* const p_ring, unsigned char* const p_data,
+                                                   const uint32_t size, const uint32_t len)
+{
+    long off = gm_cli_shm_space(p_ring, size, len);
+    uint32_t head_off = p_ring->head & (size - 1);
+
+    if (off < 0)
+    {
+        return NULL;
+    }
+    if ((uint32_t)off != head_off)
+    {
+        ((gm_cli_shm_rec_t*)&p_data[head_off])->len = GM_CLI_SHM_PAD;
+    }
+    return (gm_cli_shm_rec_t*)&p_data[off];
+}
+
+/* 生产者发布预留的记录，记录长度可以比预留时小 */
+static inline void gm_cli_shm_commit(gm_cli_shm_ring_t* const p_ring, const unsigned char* const p_data,
+                                     const uint32_t size, const gm_cli_shm_rec_t* const p_rec)
+{
+    uint32_t head = p_ring->head;
+
+    if ((uint32_t)((const unsigned char*)p_rec - p_data) != (head & (size - 1)))
+    {
+        head += size - (head & (size - 1));
+    }
+    __atomic_store_n(&p_ring->head, head + gm_cli_shm_rec_size(p_rec->len), __ATOMIC_RELEASE);
+}
+
+/* 消费者取出最早的记录，跳过填充记录，没有时返回NULL */
+static inline const gm_cli_shm_rec_t* gm_cli_shm_peek(gm_cli_shm_ring_t* const p_ring,
+                                                      const unsigned char* const p_data, const uint32_t size)
+{
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = p_ring->tail;
+    const gm_cli_shm_rec_t* p_rec;
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+    p_rec = (const gm_cli_shm_rec_t*)&p_data[tail & (size - 1)];
+    if (p_rec->len == GM_CLI_SHM_PAD)
+    {
+        /* 填充记录之后一定有从头开始的记录 */
+        __atomic_store_n(&p_ring->tail, tail + size - (tail & (size - 1)), __ATOMIC_RELEASE);
+        p_rec = (const gm_cli_shm_rec_t*)&p_data[0];
+    }
+    return p_rec;
+}
+
+/* 消费者释放取出的记录 */
+static inline void gm_cli_shm_release(gm_cli_shm_ring_t* const p_ring, const gm_cli_shm_rec_t* const p_rec)
+{
+    __atomic_store_n(&p_ring->tail, p_ring->tail + gm_cli_shm_rec_size(p_rec->len), __ATOMIC_RELEASE);
+}
+
+/* 敲门铃，对端在等待时唤醒 */
+static inline void gm_cli_shm_ring_bell(gm_cli_shm_bell_t* const p_bell)
+{
+    __atomic_add_fetch(&p_bell->bell, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p_bell->wait, __ATOMIC_SEQ_CST))
+    {
+        syscall(SYS_futex, &p_bell->bell, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/* 准备等待门铃，返回当前计数，之后需要再检查一次等待的条件 */
+static inline uint32_t gm_cli_shm_bell_arm(gm_cli_shm_bell_t* const p_bell)
+{
+    uint32_t seen = __atomic_load_n(&p_bell->bell, __ATOMIC_SEQ_CST);
+
+    __atomic_store_n(&p_bell->wait, 1, __ATOMIC_SEQ_CST);
+    return seen;
+}
+
+/* 等待门铃，计数变化或超时返回，ms为0时不等待，只清除等待标志 */
+static inline void gm_cli_shm_bell_wait(gm_cli_shm_bell_t* const p_bell, const uint32_t seen,
+                                        const unsigned int ms)
+{
+    struct timespec ts;
+
+    if (ms > 0)
+    {
+        ts.tv_sec = (time_t)(ms / 1000);
+        ts.tv_nsec = (long)(ms % 1000) * 1000000l;
+        syscall(SYS_futex, &p_bell->bell, FUTEX_WAIT, seen, &ts, NULL, 0);
+    }
+    __atomic_store_n(&p_bell->wait, 0, __ATOMIC_SEQ_CST);
+}
+
+/* 客户端 */
+typedef struct
+{
+    gm_cli_shm_hdr_t*      p_hdr;                        /* 共享内存 */
+    size_t                 map_size;                     /* 映射大小 */
+    uint32_t               size;                         /* 每个缓存的数据区字节数 */
+    uint32_t               seq;                          /* 下一个请求序号 */
+} gm_cli_shm_client_t;
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_open
+** 函数作用：连接服务端创建的共享内存通道并占用
+** 输入参数：p_cli - 客户端
+**           name  - 共享内存名称，和服务端gm_cli_shm_open的相同
+** 输出参数：0 - 成功，-1 - 失败，errno为EBUSY时通道被其他存活的客户端占用
+** 使用范例：gm_cli_shm_client_open(&cli, "/gm_cli");
+** 函数备注：同一时间一个通道只能有一个客户端，占用的进程已退出时可以接管；
+**           连接时等待服务端处理完之前的请求，丢弃未取走的应答
+*******************************************************************************/
+static inline int gm_cli_shm_client_open(gm_cli_shm_client_t* const p_cli, const char* const name)
+{
+    gm_cli_shm_hdr_t* p_hdr;
+    struct stat st;
+    uint32_t owner = 0, self = (uint32_t)getpid();
+    unsigned int n;
+    int fd;
+
+    fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(gm_cli_shm_hdr_t)))
+    {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+    p_hdr = (gm_cli_shm_hdr_t*)mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p_hdr == (gm_cli_shm_hdr_t*)MAP_FAILED)
+    {
+        return -1;
+    }
+    if ((p_hdr->magic != GM_CLI_SHM_MAGIC) || (p_hdr->version != GM_CLI_SHM_VERSION) ||
+        (p_hdr->size == 0) || ((p_hdr->size & (p_hdr->size - 1)) != 0) ||
+        (GM_CLI_SHM_MAP_SIZE(p_hdr->size) > (size_t)st.st_size))
+    {
+        munmap(p_hdr, (size_t)st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* 占用通道，之前的客户端已退出时接管 */
+    if (!__atomic_compare_exchange_n(&p_hdr->client, &owner, self, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) &&
+        ((kill((pid_t)owner, 0) == 0) || (errno != ESRCH) ||
+         !__atomic_compare_exchange_n(&p_hdr->client, &owner, self, 0,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)))
+    {
+        munmap(p_hdr, (size_t)st.st_size);
+        errno = EBUSY;
+        return -1;
+    }
+    /* 服务端处理完一条请求才释放它，请求缓存空了之后应答缓存中只有旧的应答 */
+    for (n = 0; (n < 1000) && (__atomic_load_n(&p_hdr->req.head, __ATOMIC_ACQUIRE) !=
+                               __atomic_load_n(&p_hdr->req.tail, __ATOMIC_ACQUIRE)); n++)
+    {
+        usleep(1000);
+    }
+    __atomic_store_n(&p_hdr->rsp.tail, __atomic_load_n(&p_hdr->rsp.head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+
+    p_cli->p_hdr = p_hdr;
+    p_cli->map_size = (size_t)st.st_size;
+    p_cli->size = p_hdr->size;
+    p_cli->seq = 0;
+    return 0;
+}
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_close
+** 函数作用：释放通道并断开
+** 输入参数：p_cli - 客户端
+** 输出参数：无
+** 使用范例：gm_cli_shm_client_close(&cli);
+** 函数备注：
+*******************************************************************************/
+static inline void gm_cli_shm_client_close(gm_cli_shm_client_t* const p_cli)
+{
+    uint32_t self = (uint32_t)getpid();
+
+    __atomic_compare_exchange_n(&p_cli->p_hdr->client, &self, 0, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    munmap(p_cli->p_hdr, p_cli->map_size);
+    p_cli->p_hdr = NULL;
+}
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_submit
+** 函数作用：提交一条命令，不等待执行
+** 输入参数：p_cli - 客户端
+**           line  - 命令行，不需要'\0'结束
+**           len   - 命令行长度
+** 输出参数：请求序号，请求缓存已满时返回-1
+** 使用范例：gm_cli_shm_client_submit(&cli, "test 1 2", 8);
+** 函数备注：可以连续提交多条，应答按提交顺序返回
+*******************************************************************************/
+static inline int gm_cli_shm_client_submit(gm_cli_shm_client_t* const p_cli, const char* const line,
+                                           const uint32_t len)
+{
+    gm_cli_shm_hdr_t* p_hdr = p_cli->p_hdr;
+    gm_cli_shm_rec_t* p_rec;
+
+    if (len > p_cli->size / 2)
+    {
+        return -1;
+    }
+    p_rec = gm_cli_shm_reserve(&p_hdr->req, GM_CLI_SHM_REQ_DATA(p_hdr), p_cli->size, len);
+    if (p_rec == NULL)
+    {
+        return -1;
+    }
+    p_rec->len = len;
+    p_rec->seq = p_cli->seq;
+    p_rec->ret = 0;
+    p_rec->flags = 0;
+    memcpy(p_rec + 1, line, len);
+    gm_cli_shm_commit(&p_hdr->req, GM_CLI_SHM_REQ_DATA(p_hdr), p_cli->size, p_rec);
+    gm_cli_shm_ring_bell(&p_hdr->srv);
+    return (int)(p_cli->seq++ & 0x7FFFFFFFu);
+}
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_reply
+** 函数作用：取出最早的应答
+** 输入参数：p_cli - 客户端
+**           ms    - 没有应答时的最长等待时间，单位ms，0为不等待
+** 输出参数：应答记录，输出紧跟在记录头之后，超时返回NULL
+** 使用范例：p_rec = gm_cli_shm_client_reply(&cli, 1000);
+** 函数备注：输出直接指向共享内存，用完后调用gm_cli_shm_client_release
+*******************************************************************************/
+static inline const gm_cli_shm_rec_t* gm_cli_shm_client_reply(gm_cli_shm_client_t* const p_cli,
+                                                              const unsigned int ms)
+{
+    gm_cli_shm_hdr_t* p_hdr = p_cli->p_hdr;
+    const gm_cli_shm_rec_t* p_rec;
+    uint32_t seen;
+
+    p_rec = gm_cli_shm_peek(&p_hdr->rsp, GM_CLI_SHM_RSP_DATA(p_hdr), p_cli->size);
+    if ((p_rec != NULL) || (ms == 0))
+    {
+        return p_rec;
+    }
+    seen = gm_cli_shm_bell_arm(&p_hdr->cli);
+    p_rec = gm_cli_shm_peek(&p_hdr->rsp, GM_CLI_SHM_RSP_DATA(p_hdr), p_cli->size);
+    gm_cli_shm_bell_wait(&p_hdr->cli, seen, (p_rec == NULL) ? ms : 0);
+    if (p_rec == NULL)
+    {
+        p_rec = gm_cli_shm_peek(&p_hdr->rsp, GM_CLI_SHM_RSP_DATA(p_hdr), p_cli->size);
+    }
+    return p_rec;
+}
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_release
+** 函数作用：释放取出的应答
+** 输入参数：p_cli - 客户端
+**           p_rec - gm_cli_shm_client_reply取出的应答
+** 输出参数：无
+** 使用范例：gm_cli_shm_client_release(&cli, p_rec);
+** 函数备注：
+*******************************************************************************/
+static inline void gm_cli_shm_client_release(gm_cli_shm_client_t* const p_cli,
+                                             const gm_cli_shm_rec_t* const p_rec)
+{
+    gm_cli_shm_release(&p_cli->p_hdr->rsp, p_rec);
+    gm_cli_shm_ring_bell(&p_cli->p_hdr->srv);
+}
+
+/*******************************************************************************
+** 函数名称：gm_cli_shm_client_exec
+** 函数作用：执行一条命令并等待结果
+** 输入参数：p_cli - 客户端
+**           line  - 命令行
+**           out   - 输出缓存，以'\0'结束，超出部分截断，可为NULL
+**           size  - 输出缓存大小
+**           p_ret - 命令返回值，可为NULL
+**           ms    - 最长等待时间，单位ms
+** 输出参数：0 - 已执行，-1 - 未执行（命令不存在或命令行错误）、提交失败或超时
+** 使用范例：gm_cli_shm_client_exec(&cli, "test 1 2", out, sizeof(out), &ret, 1000);
+** 函数备注：之前提交的命令的应答被丢弃
+*******************************************************************************/
+static inline int gm_cli_shm_client_exec(gm_cli_shm_client_t* const p_cli, const char* const line,
+                                         char* const out, const size_t size, int* const p_ret,
+                                         const unsigned int ms)
+{
+    const gm_cli_shm_rec_t* p_rec;
+    uint32_t len;
+    int seq, result;
+
+    seq = gm_cli_shm_client_submit(p_cli, line, (uint32_t)strlen(line));
+    if (seq < 0)
+    {
+        return -1;
+    }
+    for (;;)
+    {
+        p_rec = gm_cli_shm_client_reply(p_cli, ms);
+        if (p_rec == NULL)
+        {
+            return -1;
+        }
+        if (p_rec->seq == (uint32_t)seq)
+        {
+            break;
+        }
+        gm_cli_shm_client_release(p_cli, p_rec);
+    }
+    if ((out != NULL) && (size > 0))
+    {
+        len = (p_rec->len < size - 1) ? p_rec->len : (uint32_t)(size - 1);
+        memcpy(out, p_rec + 1, len);
+        out[len] = '\0';
+    }
+    if (p_ret != NULL)
+    {
+        *p_ret = p_rec->ret;
+    }
+    result = (p_rec->flags & GM_CLI_SHM_FLAG_FAIL) ? -1 : 0;
+    gm_cli_shm_client_release(p_cli, p_rec);
+    return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* __GM_CLI_SHM_H__ */
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+GM_CLI二进制帧协议参考客户端和吞吐量测试工具
+
+请求帧：0xA5 | 标志(1) | 序号(2) | 长度(2) | 命令行 | CRC16(2)
+响应帧：0x5A | 标志(1) | 序号(2) | 返回值(4) | 长度(2) | 输出 | CRC16(2)
+多字节均为小端，CRC16-CCITT（多项式0x1021，初值0xFFFF）从标志开始计算到数据结束
+
+使用范例：
+    # 本地宿主程序，执行命令
+    python3 tools/gm_cli_bin.py --exec ./gm_cli_host "test 1 2" "dump 3"
+    # 串口设备，吞吐量测试，每次发送8帧后再收取响应
+    python3 tools/gm_cli_bin.py --serial /dev/ttyUSB0 --baud 921600 \\
+            --bench 10000 --window 8 "test 1 2"
+"""
+
+import argparse
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+MAGIC = bytes([0xA5, 0xC3, 0x96, 0xF1])
+REQ_SOF = 0xA5
+RSP_SOF = 0x5A
+
+REQ_EXIT = 0x01
+
+RSP_TRUNC = 0x01
+RSP_NOT_EXEC = 0x02
+RSP_BAD_FRAME = 0x04
+RSP_MODE = 0x80
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC16-CCITT，和gm_cli.c中的实现一致"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+class ExecTransport:
+    """通过标准输入输出和本地进程通信"""
+
+    def __init__(self, cmd):
+        self.proc = subprocess.Popen(cmd, shell=True, stdin=subprocess.PIPE,
+                                     stdout=subprocess.PIPE, bufsize=0)
+
+    def write(self, data):
+        self.proc.stdin.write(data)
+
+    def read(self, size):
+        return self.proc.stdout.read1(size) if hasattr(self.proc.stdout, "read1") \
+            else self.proc.stdout.read(1)
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait()
+
+
+class SerialTransport:
+    """串口通信，需要安装pyserial"""
+
+    def __init__(self, dev, baud):
+        import serial
+        self.port = serial.Serial(dev, baud, timeout=5)
+
+    def write(self, data):
+        self.port.write(data)
+
+    def read(self, size):
+        return self.port.read(max(1, min(size, self.port.in_waiting)))
+
+    def close(self):
+        self.port.close()
+
+
+class TcpTransport:
+    """TCP通信，用于串口服务器等"""
+
+    def __init__(self, addr):
+        host, port = addr.rsplit(":", 1)
+        self.sock = socket.create_connection((host, int(port)), timeout=5)
+
+    def write(self, data):
+        self.sock.sendall(data)
+
+    def read(self, size):
+        return self.sock.recv(size)
+
+    def close(self):
+        self.sock.close()
+
+
+class GmCliBin:
+    """二进制帧协议客户端"""
+
+    def __init__(self, transport):
+        self.t = transport
+        self.buf = bytearray()
+        self.seq = 0
+
+    def _fill(self):
+        data = self.t.read(65536)
+        if not data:
+            raise EOFError("connection closed")
+        self.buf += data
+
+    def recv(self):
+        """接收一个响应帧，返回(标志, 序号, 返回值, 输出)，自动跳过非帧数据"""
+        while True:
+            while len(self.buf) < 12:
+                self._fill()
+            if self.buf[0] != RSP_SOF:
+                pos = self.buf.find(bytes([RSP_SOF]))
+                del self.buf[:pos if pos >= 0 else len(self.buf)]
+                continue
+            flags, seq, ret, length = struct.unpack_from("<BHiH", self.buf, 1)
+            while len(self.buf) < 12 + length:
+                self._fill()
+            crc, = struct.unpack_from("<H", self.buf, 10 + length)
+            if crc16(self.buf[1:10 + length]) != crc:
+                # 不是真正的帧头，丢掉一个字节重新同步
+                del self.buf[:1]
+                continue
+            out = bytes(self.buf[10:10 + length])
+            del self.buf[:12 + length]
+            return flags, seq, ret, out
+
+    def enter(self):
+        """发送进入序列，等待模式应答"""
+        self.t.write(MAGIC)
+        while True:
+            flags, _, ret, _ = self.recv()
+            if (flags & RSP_MODE) and ret == 1:
+                return
+
+    def send(self, line, flags=0):
+        """发送一个请求帧，返回序号"""
+        self.seq = (self.seq + 1) & 0xFFFF
+        body = struct.pack("<BHH", flags, self.seq, len(line)) + line
+        self.t.write(bytes([REQ_SOF]) + body + struct.pack("<H", crc16(body)))
+        return self.seq
+
+    def run(self, line):
+        """执行一条命令，返回(返回值, 输出)，命令未执行时抛出异常"""
+        seq = self.send(line.encode() if isinstance(line, str) else line)
+        flags, rseq, ret, out = self.recv()
+        if rseq != seq:
+            raise RuntimeError("sequence mismatch %d != %d" % (rseq, seq))
+        if flags & (RSP_NOT_EXEC | RSP_BAD_FRAME):
+            raise RuntimeError("command not executed (flags 0x%02X): %s"
+                               % (flags, out.decode(errors="replace")))
+        return ret, out
+
+    def exit(self):
+        """退出二进制帧模式"""
+        self.send(b"", REQ_EXIT)
+        while not (self.recv()[0] & RSP_MODE):
+            pass
+
+
+def bench(cli, line, count, window):
+    """吞吐量测试，window为连续发送未应答的帧数"""
+    data = line.encode()
+    lat = []
+    out_bytes = 0
+    pending = {}
+    sent = 0
+    start = time.perf_counter()
+    while sent < count or pending:
+        while sent < count and len(pending) < window:
+            pending[cli.send(data)] = time.perf_counter()
+            sent += 1
+        flags, seq, _, out = cli.recv()
+        if flags & (RSP_NOT_EXEC | RSP_BAD_FRAME):
+            raise RuntimeError("command failed (flags 0x%02X)" % flags)
+        lat.append(time.perf_counter() - pending.pop(seq))
+        out_bytes += len(out)
+    elapsed = time.perf_counter() - start
+    lat.sort()
+
+    def pct(p):
+        return lat[min(len(lat) - 1, int(len(lat) * p / 100))] * 1e6
+
+    print("commands   : %d in %.3f s" % (count, elapsed))
+    print("throughput : %.0f cmd/s, %.0f output bytes/s" % (count / elapsed, out_bytes / elapsed))
+    print("latency us : p50 %.0f  p90 %.0f  p99 %.0f  max %.0f"
+          % (pct(50), pct(90), pct(99), lat[-1] * 1e6))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="GM_CLI binary frame protocol client")
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--exec", help="run a local CLI host and talk over its stdio")
+    link.add_argument("--serial", help="serial device")
+    link.add_argument("--tcp", help="host:port")
+    ap.add_argument("--baud", type=int, default=115200, help="serial baud rate")
+    ap.add_argument("--bench", type=int, default=0, help="run the first command N times")
+    ap.add_argument("--window", type=int, default=1, help="frames in flight during bench")
+    ap.add_argument("commands", nargs="+", help="command lines")
+    args = ap.parse_args()
+
+    if args.exec:
+        transport = ExecTransport(args.exec)
+    elif args.serial:
+        transport = SerialTransport(args.serial, args.baud)
+    else:
+        transport = TcpTransport(args.tcp)
+
+    cli = GmCliBin(transport)
+    cli.enter()
+    rc = 0
+    try:
+        if args.bench > 0:
+            bench(cli, args.commands[0], args.bench, max(1, args.window))
+        else:
+            for line in args.commands:
+                try:
+                    ret, out = cli.run(line)
+                except RuntimeError as e:
+                    print(e, file=sys.stderr)
+                    rc = 1
+                    continue
+                sys.stdout.write(out.decode(errors="replace"))
+                print("[ret %d]" % ret)
+                rc = rc or (ret != 0)
+        cli.exit()
+    finally:
+        transport.close()
+    return rc
+
+
+if __name__ == "__main__":
+    sys.exit(main())
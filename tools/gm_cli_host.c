@@ -0,0 +1,1015 @@
+/*******************************************************************************
+** 文件名称：gm_cli_host.c
+** 文件作用：Linux下的CLI宿主程序
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：从标准输入读取字符交给CLI解析，输出写到标准输出，标准输入为终端时
+**           切换为原始模式，可直接交互使用，也可以作为二进制帧协议客户端、
+**           性能测试工具的被测对象
+**
+**           编译方法（在仓库根目录执行），默认配置不含可选功能，宿主程序使用完整配置：
+**           gcc -O2 -I. -pthread -DGM_CLI_PROFILE_FULL=1 -o gm_cli_host gm_cli.c \
+**               tools/gm_cli_host.c
+**
+**           GM_CLI_REC_EN为1时支持会话录制和回放：
+**           gm_cli_host -r session.rec          交互使用，同时录制会话
+**           gm_cli_host -p session.rec [-f]     按原始节奏（-f为最快速度）回放，
+**                                               输出CPU时间、输出字节数和输出差异
+**
+**           GM_CLI_BATCH_EN为1时支持批量执行脚本文件：
+**           gm_cli_host -b script.txt [-j 8]    可重入命令用8个线程并行执行，
+**                                               输出执行时间和失败的行号
+**
+**           GM_CLI_SHM_EN为1时可作为共享内存控制通道的服务端，由
+**           tools/gm_cli_shm_client.c等其他进程提交命令，Ctrl-C退出：
+**           gm_cli_host -s /gm_cli
+**
+**           GM_CLI_PLUGIN_EN为1时可用plugin命令加载命令插件，编译时加-rdynamic
+**           导出CLI接口给插件使用，较老的glibc还需要加-ldl：
+**           gcc -O2 -I. -pthread -rdynamic -DGM_CLI_PROFILE_FULL=1 -DGM_CLI_PLUGIN_EN=1 \
+**               -o gm_cli_host \
+**               gm_cli.c tools/gm_cli_host.c -ldl
+**
+**           GM_CLI_CALL_EN为1时可用call命令调用示例符号表中的几个C库函数，
+**           如call strlen hello，call -l列出全部函数
+**
+**           GM_CLI_HOST_FILL_CMDS为填充命令数，按64取整，最多4032个，用于
+**           tools/gm_cli_latency.c测试不同命令表大小下的交互延时：
+**           gcc -O2 -I. -pthread -DGM_CLI_PROFILE_FULL=1 -DGM_CLI_HOST_FILL_CMDS=1024 \
+**               -o gm_cli_host1024 \
+**               gm_cli.c tools/gm_cli_host.c
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加会话录制和回放
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加看门狗线程，命令执行中可按Ctrl-C中止，增加sleep命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加批量执行脚本文件，dump和sleep标记为可重入命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加变量和循环命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加plugin命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加共享内存控制通道服务模式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加内存命令md、mw和mcmp
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加call命令和示例符号表
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加填充命令，用于测试不同命令表大小下的延时
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_stop，退出时关闭括号粘贴模式
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 会话记录增加后台处理记录，回放按记录执行后台处理
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加gm_cli_peek_char判断Ctrl-C，执行状态改用原子操作
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 修复批量执行的命令不计预算、无法中止的问题，增加GM_CLI_CMD_EXPORT_EX_BUDGET
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 编译方法改为使用完整配置
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 增加带输出缓存的args命令
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 批量执行返回前调用gm_cli_stop发送全部输出
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     ANSI C Language(C99)
+*******************************************************************************/
+
+#include "gm_cli.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "termios.h"
+#include "time.h"
+#include "poll.h"
+#include "signal.h"
+#if GM_CLI_BUDGET_EN
+#include "pthread.h"
+#endif  /* GM_CLI_BUDGET_EN */
+
+/* 命令输出大量数据，用于测试输出性能，dump [num] */
+static int gm_cli_host_cmd_dump(int argc, char* argv[])
+{
+    int i, num = 100;
+
+    if (argc > 1)
+    {
+        num = atoi(argv[1]);
+    }
+    for (i = 0; i < num; i++)
+    {
+        gm_cli_printf("line %d value 0x%08X\r\n", i, (unsigned int)i * 2654435761u);
+    }
+    return 0;
+}
+
+#if GM_CLI_CACHE_EN
+/* 输出参数和执行次数，带幂等标志，60 s内相同参数直接输出缓存，执行次数不变，
+ * 用于测试输出缓存，args [arg ...] */
+static int gm_cli_host_cmd_args(int argc, char* argv[])
+{
+    static unsigned int runs;
+    int i;
+
+    runs++;
+    gm_cli_printf("run %u, argc %d\r\n", runs, argc);
+    for (i = 1; i < argc; i++)
+    {
+        gm_cli_printf("argv[%d] = \"%s\"\r\n", i, argv[i]);
+    }
+    return 0;
+}
+#endif  /* GM_CLI_CACHE_EN */
+
+#if GM_CLI_BUDGET_EN
+/* 等待指定时间，每ms查询一次是否需要中止，用于测试执行时间预算，sleep ms */
+static int gm_cli_host_cmd_sleep(int argc, char* argv[])
+{
+    struct timespec ts = { 0, 1000000l };
+    long i, ms;
+
+    if (argc != 2)
+    {
+        gm_cli_put_str("Usage: sleep ms\r\n");
+        return -1;
+    }
+    ms = atol(argv[1]);
+    for (i = 0; i < ms; i++)
+    {
+        if (gm_cli_should_abort())
+        {
+            gm_cli_printf("sleep stopped after %ld ms\r\n", i);
+            return -1;
+        }
+        nanosleep(&ts, NULL);
+    }
+    return 0;
+}
+#endif  /* GM_CLI_BUDGET_EN */
+
+#if GM_CLI_CALL_EN
+/* call命令的示例符号表，按名称排序，实际程序用tools/gm_cli_symgen.sh生成 */
+static const gm_cli_sym_t gm_cli_host_syms[] =
+{
+    { "abs",    (void (*)(void))abs,    "int abs(int j)" },
+    { "atoi",   (void (*)(void))atoi,   "int atoi(const char* nptr)" },
+    { "getpid", (void (*)(void))getpid, "int getpid(void)" },
+    { "puts",   (void (*)(void))puts,   "int puts(const char* s)" },
+    { "strlen", (void (*)(void))strlen, "unsigned long strlen(const char* s)" },
+    { "usleep", (void (*)(void))usleep, "int usleep(unsigned int usec)" },
+};
+#endif  /* GM_CLI_CALL_EN */
+
+/* 填充命令数，按64取整 */
+#ifndef GM_CLI_HOST_FILL_CMDS
+#define GM_CLI_HOST_FILL_CMDS       0u
+#endif
+
+#if (GM_CLI_HOST_FILL_CMDS >= 64)
+/* 填充命令，只用于增大命令表 */
+static int gm_cli_host_cmd_fill(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+/* 生成填充命令，命令名为前缀加八进制序号，不同大小的块用不同前缀 */
+#define GM_CLI_HOST_FILL_1(n)       { .name = #n, .usage = "fill -- filler command", \
+                                      .cb = gm_cli_host_cmd_fill, .link = NULL, },
+#define GM_CLI_HOST_FILL_8(p)       GM_CLI_HOST_FILL_1(p##0) GM_CLI_HOST_FILL_1(p##1) \
+                                    GM_CLI_HOST_FILL_1(p##2) GM_CLI_HOST_FILL_1(p##3) \
+                                    GM_CLI_HOST_FILL_1(p##4) GM_CLI_HOST_FILL_1(p##5) \
+                                    GM_CLI_HOST_FILL_1(p##6) GM_CLI_HOST_FILL_1(p##7)
+#define GM_CLI_HOST_FILL_64(p)      GM_CLI_HOST_FILL_8(p##0) GM_CLI_HOST_FILL_8(p##1) \
+                                    GM_CLI_HOST_FILL_8(p##2) GM_CLI_HOST_FILL_8(p##3) \
+                                    GM_CLI_HOST_FILL_8(p##4) GM_CLI_HOST_FILL_8(p##5) \
+                                    GM_CLI_HOST_FILL_8(p##6) GM_CLI_HOST_FILL_8(p##7)
+#define GM_CLI_HOST_FILL_128(p)     GM_CLI_HOST_FILL_64(p##0) GM_CLI_HOST_FILL_64(p##1)
+#define GM_CLI_HOST_FILL_256(p)     GM_CLI_HOST_FILL_128(p##0) GM_CLI_HOST_FILL_128(p##1)
+#define GM_CLI_HOST_FILL_512(p)     GM_CLI_HOST_FILL_256(p##0) GM_CLI_HOST_FILL_256(p##1)
+#define GM_CLI_HOST_FILL_1024(p)    GM_CLI_HOST_FILL_512(p##0) GM_CLI_HOST_FILL_512(p##1)
+#define GM_CLI_HOST_FILL_2048(p)    GM_CLI_HOST_FILL_1024(p##0) GM_CLI_HOST_FILL_1024(p##1)
+#endif  /* GM_CLI_HOST_FILL_CMDS >= 64 */
+
+#if (GM_CLI_CC == GM_CLI_CC_ANY)
+/* 静态命令表 */
+const gm_cli_cmd_t gm_cli_static_cmds[] =
+{
+    {
+        .name  = "help",
+        .usage = "help [cmd-name] -- list the command and usage",
+        .cb    = gm_cli_internal_cmd_help,
+        .link  = NULL,
+    },
+    {
+        .name  = "?",
+        .usage = NULL,
+        .cb    = NULL,
+        .link  = (gm_cli_cmd_t*)&gm_cli_static_cmds[0],
+    },
+    {
+        .name  = "history",
+        .usage = "history [num] -- list the history command",
+        .cb    = gm_cli_internal_cmd_history,
+        .link  = NULL,
+    },
+    {
+        .name  = "test",
+        .usage = "test [args] -- test the cli",
+        .cb    = gm_cli_internal_cmd_test,
+        .link  = NULL,
+    },
+#if GM_CLI_EMIT_EN
+    {
+        .name  = "format",
+        .usage = "format [text|json|cbor] -- show or set the structured output format",
+        .cb    = gm_cli_internal_cmd_format,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_EMIT_EN */
+#if GM_CLI_WATCH_EN
+    {
+        .name  = "watch",
+        .usage = "watch [-n ms] [-r] [-b] cmd [args] -- run cmd periodically",
+        .cb    = gm_cli_internal_cmd_watch,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_WATCH_EN */
+#if GM_CLI_ALIAS_EN
+    {
+        .name  = "alias",
+        .usage = "alias [name[='cmd [args][; cmd [args]]']] -- list, show or define an alias",
+        .cb    = gm_cli_internal_cmd_alias,
+        .link  = NULL,
+    },
+    {
+        .name  = "unalias",
+        .usage = "unalias name|-a -- remove an alias or all aliases",
+        .cb    = gm_cli_internal_cmd_unalias,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_ALIAS_EN */
+#if GM_CLI_VAR_EN
+    {
+        .name  = "set",
+        .usage = "set [name [value]] -- list, show or set a variable, $name or ${name} is replaced",
+        .cb    = gm_cli_internal_cmd_set,
+        .link  = NULL,
+    },
+    {
+        .name  = "unset",
+        .usage = "unset name|-a -- remove a variable or all variables",
+        .cb    = gm_cli_internal_cmd_unset,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_VAR_EN */
+#if GM_CLI_LOOP_EN
+    {
+        .name  = "repeat",
+        .usage = "repeat [-q] count cmd [args] -- run cmd count times and report the rate "
+                 "and latency, -q drops the output",
+        .cb    = gm_cli_internal_cmd_repeat,
+        .link  = NULL,
+        .flags = GM_CLI_CMD_FLAG_RAW,
+    },
+#if GM_CLI_VAR_EN
+    {
+        .name  = "for",
+        .usage = "for [-q] var in first..last cmd [args with $var] -- run cmd for each value "
+                 "and report the rate and latency, -q drops the output",
+        .cb    = gm_cli_internal_cmd_for,
+        .link  = NULL,
+        .flags = GM_CLI_CMD_FLAG_RAW,
+    },
+#endif  /* GM_CLI_VAR_EN */
+#endif  /* GM_CLI_LOOP_EN */
+#if GM_CLI_PLUGIN_EN
+    {
+        .name  = "plugin",
+        .usage = "plugin [load path | unload id|path] -- load or unload command plugins, "
+                 "list them without arguments",
+        .cb    = gm_cli_internal_cmd_plugin,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_PLUGIN_EN */
+#if GM_CLI_MEM_EN
+    {
+        .name  = "md",
+        .usage = "md [-b|-h|-w] addr [len] -- dump len bytes of memory (default 64) "
+                 "as bytes, halfwords or words (default)",
+        .cb    = gm_cli_internal_cmd_md,
+        .link  = NULL,
+    },
+    {
+        .name  = "mw",
+        .usage = "mw [-b|-h|-w] addr value [count] -- write value to count bytes, "
+                 "halfwords or words (default) of memory",
+        .cb    = gm_cli_internal_cmd_mw,
+        .link  = NULL,
+    },
+    {
+        .name  = "mcmp",
+        .usage = "mcmp [-b|-h|-w] addr1 addr2 len -- compare len bytes of memory as bytes, "
+                 "halfwords or words (default) and list the differences",
+        .cb    = gm_cli_internal_cmd_mcmp,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_MEM_EN */
+#if GM_CLI_CALL_EN
+    {
+        .name  = "call",
+        .usage = "call func [args] -- call a function from the symbol table with integer, "
+                 "&func or string arguments and time it, call -l [prefix] to list functions",
+        .cb    = gm_cli_internal_cmd_call,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_CALL_EN */
+#if GM_CLI_TRACE_EN
+    {
+        .name  = "trace",
+        .usage = "trace [on|off|clear|dump] -- show, control or dump the internal trace ring",
+        .cb    = gm_cli_internal_cmd_trace,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_TRACE_EN */
+#if GM_CLI_CACHE_EN
+    {
+        .name  = "cache",
+        .usage = "cache [clear [cmd]] -- show output cache statistics or clear the cache",
+        .cb    = gm_cli_internal_cmd_cache,
+        .link  = NULL,
+    },
+#endif  /* GM_CLI_CACHE_EN */
+#if GM_CLI_BUDGET_EN
+    {
+        .name  = "wdog",
+        .usage = "wdog [clear] -- show or clear command run time statistics",
+        .cb    = gm_cli_internal_cmd_wdog,
+        .link  = NULL,
+    },
+    {
+        .name      = "sleep",
+        .usage     = "sleep ms -- wait, stopped by Ctrl-C or the 5 s budget",
+        .cb        = gm_cli_host_cmd_sleep,
+        .link      = NULL,
+        .flags     = GM_CLI_CMD_FLAG_REENTRANT,
+        .budget_ms = 5000,
+    },
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_CACHE_EN
+    {
+        .name   = "args",
+        .usage  = "args [arg ...] -- print the args and the run count, cached for 60 s",
+        .cb     = gm_cli_host_cmd_args,
+        .link   = NULL,
+        .flags  = GM_CLI_CMD_FLAG_IDEMPOTENT,
+        .ttl_ms = 60000,
+    },
+#endif  /* GM_CLI_CACHE_EN */
+    {
+        .name  = "dump",
+        .usage = "dump [num] -- print num lines",
+        .cb    = gm_cli_host_cmd_dump,
+        .link  = NULL,
+        .flags = GM_CLI_CMD_FLAG_REENTRANT,
+    },
+    /* 填充命令，按二进制位组合出需要的数量 */
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 1)
+    GM_CLI_HOST_FILL_64(fa)
+#endif
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 2)
+    GM_CLI_HOST_FILL_128(fb)
+#endif
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 4)
+    GM_CLI_HOST_FILL_256(fc)
+#endif
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 8)
+    GM_CLI_HOST_FILL_512(fd)
+#endif
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 16)
+    GM_CLI_HOST_FILL_1024(fe)
+#endif
+#if ((GM_CLI_HOST_FILL_CMDS / 64) & 32)
+    GM_CLI_HOST_FILL_2048(ff)
+#endif
+    /* 数组末尾一定要以下面的元素结束 */
+    {
+        .name  = NULL,
+        .usage = NULL,
+        .cb    = NULL,
+        .link  = NULL,
+    },
+};
+#else
+GM_CLI_CMD_EXPORT_EX(dump, "dump [num] -- print num lines", gm_cli_host_cmd_dump,
+                     GM_CLI_CMD_FLAG_REENTRANT, 0);
+#if GM_CLI_BUDGET_EN
+GM_CLI_CMD_EXPORT_EX_BUDGET(sleep, "sleep ms -- wait, stopped by Ctrl-C or the 5 s budget",
+                            gm_cli_host_cmd_sleep, GM_CLI_CMD_FLAG_REENTRANT, 5000);
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_CACHE_EN
+GM_CLI_CMD_EXPORT_EX(args, "args [arg ...] -- print the args and the run count, cached for 60 s",
+                     gm_cli_host_cmd_args, GM_CLI_CMD_FLAG_IDEMPOTENT, 60000);
+#endif  /* GM_CLI_CACHE_EN */
+#endif  /* GM_CLI_CC == GM_CLI_CC_ANY */
+
+#if GM_CLI_REC_EN
+/* 可增长的数据缓存 */
+typedef struct
+{
+    char*         data;
+    unsigned long len;
+    unsigned long size;
+} gm_cli_host_buf_t;
+
+/* 回放时捕获的实际输出，capture为0时输出到标准输出 */
+static int gm_cli_host_capture;
+static gm_cli_host_buf_t gm_cli_host_actual;
+/* 回放时的虚拟时基，为会话记录中的时间 */
+static unsigned long gm_cli_host_vtick;
+/* 会话记录文件 */
+static FILE* gm_cli_host_rec_file;
+
+/* 追加数据 */
+static void gm_cli_host_buf_add(gm_cli_host_buf_t* const p_buf, const char* buf, unsigned long len)
+{
+    if (p_buf->len + len > p_buf->size)
+    {
+        p_buf->size = (p_buf->len + len) * 2 + 4096;
+        p_buf->data = realloc(p_buf->data, p_buf->size);
+        if (p_buf->data == NULL)
+        {
+            exit(1);
+        }
+    }
+    memcpy(&p_buf->data[p_buf->len], buf, len);
+    p_buf->len += len;
+}
+#endif  /* GM_CLI_REC_EN */
+
+/* 批量输出到标准输出 */
+static void gm_cli_host_out_buf(const char* buf, unsigned int len)
+{
+    ssize_t ret;
+
+#if GM_CLI_REC_EN
+    if (gm_cli_host_capture)
+    {
+        gm_cli_host_buf_add(&gm_cli_host_actual, buf, len);
+        return;
+    }
+#endif  /* GM_CLI_REC_EN */
+
+    while (len > 0)
+    {
+        ret = write(STDOUT_FILENO, buf, len);
+        if (ret <= 0)
+        {
+            exit(1);
+        }
+        buf += ret;
+        len -= (unsigned int)ret;
+    }
+}
+
+/* 输出一个字符 */
+static void gm_cli_host_out_char(const char ch)
+{
+    gm_cli_host_out_buf(&ch, 1);
+}
+
+/* 毫秒时基 */
+static unsigned long gm_cli_host_tick(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec * 1000ul + (unsigned long)(ts.tv_nsec / 1000000);
+}
+
+#if GM_CLI_REC_EN
+/* 写入会话记录 */
+static void gm_cli_host_rec_write(const char* buf, unsigned int len)
+{
+    fwrite(buf, 1, len, gm_cli_host_rec_file);
+}
+
+/* 回放时的时基 */
+static unsigned long gm_cli_host_replay_tick(void)
+{
+    return gm_cli_host_vtick;
+}
+
+/* 解码变长整数，返回：0 - 成功，-1 - 数据不完整 */
+static int gm_cli_host_varint(const unsigned char* const buf, const unsigned long len,
+                              unsigned long* const p_pos, unsigned long* const p_val)
+{
+    unsigned long val = 0;
+    unsigned int shift = 0;
+
+    while (*p_pos < len)
+    {
+        val |= (unsigned long)(buf[*p_pos] & 0x7F) << shift;
+        if ((buf[(*p_pos)++] & 0x80) == 0)
+        {
+            *p_val = val;
+            return 0;
+        }
+        shift += 7;
+        if (shift >= sizeof(unsigned long) * 8)
+        {
+            break;
+        }
+    }
+    return -1;
+}
+
+/* 虚拟时基推进到指定时间，realtime为1时按实际时间等待，后台处理按记录执行 */
+static void gm_cli_host_replay_advance(const unsigned long to, const int realtime)
+{
+    struct timespec ts;
+    unsigned long step;
+
+    if (gm_cli_host_vtick >= to)
+    {
+        return;
+    }
+    step = to - gm_cli_host_vtick;
+    if (realtime)
+    {
+        ts.tv_sec = (time_t)(step / 1000);
+        ts.tv_nsec = (long)(step % 1000) * 1000000l;
+        nanosleep(&ts, NULL);
+    }
+    gm_cli_host_vtick = to;
+}
+
+/* 输出一段转义后的数据，用于显示差异 */
+static void gm_cli_host_print_escaped(const char* const buf, const unsigned long len)
+{
+    unsigned long i;
+
+    for (i = 0; i < len; i++)
+    {
+        if ((buf[i] >= ' ') && (buf[i] <= '~') && (buf[i] != '\\'))
+        {
+            putchar(buf[i]);
+        }
+        else
+        {
+            printf("\\x%02X", (unsigned char)buf[i]);
+        }
+    }
+    putchar('\n');
+}
+
+/* 回放会话记录，返回：0 - 输出一致，1 - 输出不一致，2 - 记录错误 */
+static int gm_cli_host_replay(const char* const path, const int realtime)
+{
+    gm_cli_host_buf_t file = { NULL, 0, 0 };
+    gm_cli_host_buf_t expect = { NULL, 0, 0 };
+    unsigned long pos, delta, len, t = 0, in_bytes = 0, records = 0, i, n;
+    const unsigned char* p;
+    struct timespec cpu0, cpu1, wall0, wall1;
+    char buf[4096];
+    FILE* fp;
+    int type;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    {
+        gm_cli_host_buf_add(&file, buf, n);
+    }
+    fclose(fp);
+    p = (const unsigned char*)file.data;
+    if ((file.len < 7) || (memcmp(p, "GMREC\x02", 6) != 0))
+    {
+        fprintf(stderr, "%s: not a gm_cli session record\n", path);
+        return 2;
+    }
+
+    /* 和录制时一样初始化，输出全部捕获 */
+    gm_cli_host_capture = 1;
+    gm_cli_host_vtick = 0;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu0);
+    clock_gettime(CLOCK_MONOTONIC, &wall0);
+    gm_cli_mgr_init();
+    gm_cli_set_out_char_cb(gm_cli_host_out_char);
+    gm_cli_set_out_buf_cb(gm_cli_host_out_buf);
+    if (p[6] & 1)
+    {
+        gm_cli_set_tick_cb(gm_cli_host_replay_tick);
+    }
+    gm_cli_start();
+
+    pos = 7;
+    while (pos < file.len)
+    {
+        type = p[pos++];
+        if ((gm_cli_host_varint(p, file.len, &pos, &delta) != 0) ||
+            (gm_cli_host_varint(p, file.len, &pos, &len) != 0) ||
+            (len > file.len - pos) || (type > 3))
+        {
+            fprintf(stderr, "%s: bad record at offset %lu\n", path, pos);
+            return 2;
+        }
+        records++;
+        t += delta;
+        gm_cli_host_replay_advance(t, realtime);
+        if (type == 0)
+        {
+            for (i = 0; i < len; i++)
+            {
+                gm_cli_parse_char((char)p[pos + i]);
+            }
+            in_bytes += len;
+        }
+        else if (type == 1)
+        {
+            gm_cli_host_buf_add(&expect, (const char*)&p[pos], len);
+        }
+        else if (type == 3)
+        {
+            /* 在录制时执行后台处理的位置执行 */
+            gm_cli_poll();
+        }
+        else
+        {
+            break;
+        }
+        pos += len;
+    }
+    /* 和交互退出时一样发送剩余的输出 */
+    gm_cli_stop();
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu1);
+    clock_gettime(CLOCK_MONOTONIC, &wall1);
+    gm_cli_host_capture = 0;
+
+    printf("records: %lu, input: %lu bytes, session: %lu ms\n", records, in_bytes, t);
+    printf("cpu: %.3f ms, wall: %.3f ms\n",
+           (cpu1.tv_sec - cpu0.tv_sec) * 1e3 + (cpu1.tv_nsec - cpu0.tv_nsec) / 1e6,
+           (wall1.tv_sec - wall0.tv_sec) * 1e3 + (wall1.tv_nsec - wall0.tv_nsec) / 1e6);
+    printf("output: expected %lu bytes, actual %lu bytes\n", expect.len, gm_cli_host_actual.len);
+
+    n = (expect.len < gm_cli_host_actual.len) ? expect.len : gm_cli_host_actual.len;
+    for (i = 0; (i < n) && (expect.data[i] == gm_cli_host_actual.data[i]); i++)
+    {
+    }
+    if ((i == expect.len) && (i == gm_cli_host_actual.len))
+    {
+        printf("output matches\n");
+        return 0;
+    }
+    /* 从差异处往前一点开始显示 */
+    pos = (i > 16) ? i - 16 : 0;
+    printf("output diverges at byte %lu\n", i);
+    printf("  expected: ");
+    gm_cli_host_print_escaped(&expect.data[pos], ((expect.len - pos) < 64) ? (expect.len - pos) : 64);
+    printf("  actual:   ");
+    gm_cli_host_print_escaped(&gm_cli_host_actual.data[pos],
+                              ((gm_cli_host_actual.len - pos) < 64) ? (gm_cli_host_actual.len - pos) : 64);
+    return 1;
+}
+#endif  /* GM_CLI_REC_EN */
+
+#if GM_CLI_BUDGET_EN
+/* 标准输入读取锁，保护命令执行期间读到的输入，主循环和看门狗线程都在锁内读取输入 */
+static pthread_mutex_t gm_cli_host_in_lock = PTHREAD_MUTEX_INITIALIZER;
+/* 命令执行期间读到的输入，命令返回后再交给CLI */
+static char gm_cli_host_pend[4096];
+static size_t gm_cli_host_pend_len;
+/* 标准输入是否为终端，管道输入中的0x03是数据，不作为Ctrl-C */
+static int gm_cli_host_tty;
+
+/* 看门狗线程，检查命令是否超过预算，命令执行期间读取输入，由CLI判断是否为Ctrl-C */
+static void* gm_cli_host_watchdog(void* arg)
+{
+    struct timespec ts = { 0, 10000000l };
+    struct pollfd pfd;
+    ssize_t len, i;
+
+    (void)arg;
+    pfd.fd = STDIN_FILENO;
+    pfd.events = POLLIN;
+    while (1)
+    {
+        nanosleep(&ts, NULL);
+        pthread_mutex_lock(&gm_cli_host_in_lock);
+        /* 锁内再确认命令在执行，此时主线程不会读取输入 */
+        if ((gm_cli_watchdog_poll() >= 0) &&
+            (gm_cli_host_pend_len < sizeof(gm_cli_host_pend)) &&
+            (poll(&pfd, 1, 0) > 0) && (pfd.revents != 0))
+        {
+            len = read(STDIN_FILENO, &gm_cli_host_pend[gm_cli_host_pend_len],
+                       sizeof(gm_cli_host_pend) - gm_cli_host_pend_len);
+            for (i = 0; gm_cli_host_tty && (i < len); i++)
+            {
+                gm_cli_peek_char(gm_cli_host_pend[gm_cli_host_pend_len + (size_t)i]);
+            }
+            if (len > 0)
+            {
+                gm_cli_host_pend_len += (size_t)len;
+            }
+        }
+        pthread_mutex_unlock(&gm_cli_host_in_lock);
+    }
+    return NULL;
+}
+#endif  /* GM_CLI_BUDGET_EN */
+
+#if GM_CLI_BATCH_EN
+/* 批量执行脚本文件，执行时间和结果输出到标准错误，返回进程退出码 */
+static int gm_cli_host_batch(const char* const path, const unsigned int threads)
+{
+    struct timespec t0, t1;
+    FILE* fp;
+    char* script;
+    long size;
+    unsigned int line = 0;
+    int ret;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    script = (size >= 0) ? malloc((size_t)size + 1) : NULL;
+    if ((script == NULL) || (fread(script, 1, (size_t)size, fp) != (size_t)size))
+    {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(fp);
+        free(script);
+        return 2;
+    }
+    fclose(fp);
+    script[size] = '\0';
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ret = gm_cli_batch(script, threads, &line);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    gm_cli_poll();
+    /* 输出调度时批量输出每次只发送一块，退出前全部发送 */
+    gm_cli_stop();
+    free(script);
+
+    fprintf(stderr, "batch: %u threads, %.3f ms\n", threads,
+            (double)(t1.tv_sec - t0.tv_sec) * 1e3 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e6);
+    if (ret != 0)
+    {
+        fprintf(stderr, "batch: failed at line %u\n", line);
+        return 1;
+    }
+    return 0;
+}
+#endif  /* GM_CLI_BATCH_EN */
+
+#if GM_CLI_SHM_EN
+/* 收到退出信号 */
+static volatile sig_atomic_t gm_cli_host_stop;
+
+/* 退出信号处理 */
+static void gm_cli_host_on_signal(int sig)
+{
+    (void)sig;
+    gm_cli_host_stop = 1;
+}
+
+/* 只服务共享内存控制通道，收到SIGINT或SIGTERM时退出，返回进程退出码 */
+static int gm_cli_host_shm(const char* const name)
+{
+    if (gm_cli_shm_open(name) != 0)
+    {
+        perror(name);
+        return 2;
+    }
+    signal(SIGINT, gm_cli_host_on_signal);
+    signal(SIGTERM, gm_cli_host_on_signal);
+    fprintf(stderr, "shm: serving %s\n", name);
+    while (!gm_cli_host_stop)
+    {
+        gm_cli_shm_wait(100);
+        gm_cli_poll();
+    }
+    gm_cli_shm_close();
+    return 0;
+}
+#endif  /* GM_CLI_SHM_EN */
+
+/* 命令行选项 */
+#if GM_CLI_REC_EN
+#define GM_CLI_HOST_OPT_REC         "r:p:f"
+#define GM_CLI_HOST_USAGE_REC       " [-r rec-file] [-p rec-file [-f]]"
+#else
+#define GM_CLI_HOST_OPT_REC         ""
+#define GM_CLI_HOST_USAGE_REC       ""
+#endif  /* GM_CLI_REC_EN */
+#if GM_CLI_BATCH_EN
+#define GM_CLI_HOST_OPT_BATCH       "b:j:"
+#define GM_CLI_HOST_USAGE_BATCH     " [-b script [-j threads]]"
+#else
+#define GM_CLI_HOST_OPT_BATCH       ""
+#define GM_CLI_HOST_USAGE_BATCH     ""
+#endif  /* GM_CLI_BATCH_EN */
+#if GM_CLI_SHM_EN
+#define GM_CLI_HOST_OPT_SHM         "s:"
+#define GM_CLI_HOST_USAGE_SHM       " [-s shm-name]"
+#else
+#define GM_CLI_HOST_OPT_SHM         ""
+#define GM_CLI_HOST_USAGE_SHM       ""
+#endif  /* GM_CLI_SHM_EN */
+
+static struct termios gm_cli_host_tio;
+
+/* 恢复终端设置 */
+static void gm_cli_host_restore_tty(void)
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &gm_cli_host_tio);
+}
+
+int main(int argc, char* argv[])
+{
+    struct termios tio;
+    struct pollfd pfd;
+    char buf[4096];
+    ssize_t len, i;
+    int tty = 0, run = 1;
+#if GM_CLI_BUDGET_EN
+    pthread_t wdog;
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_REC_EN
+    const char* rec_path = NULL;
+    const char* replay_path = NULL;
+    int realtime = 1;
+#endif  /* GM_CLI_REC_EN */
+#if GM_CLI_BATCH_EN
+    const char* batch_path = NULL;
+    unsigned int threads = 1;
+#endif  /* GM_CLI_BATCH_EN */
+#if GM_CLI_SHM_EN
+    const char* shm_name = NULL;
+#endif  /* GM_CLI_SHM_EN */
+    int opt;
+
+    while ((opt = getopt(argc, argv, GM_CLI_HOST_OPT_REC GM_CLI_HOST_OPT_BATCH GM_CLI_HOST_OPT_SHM)) != -1)
+    {
+        switch (opt)
+        {
+#if GM_CLI_REC_EN
+        case 'r':
+            rec_path = optarg;
+            break;
+        case 'p':
+            replay_path = optarg;
+            break;
+        case 'f':
+            realtime = 0;
+            break;
+#endif  /* GM_CLI_REC_EN */
+#if GM_CLI_BATCH_EN
+        case 'b':
+            batch_path = optarg;
+            break;
+        case 'j':
+            threads = (unsigned int)atoi(optarg);
+            break;
+#endif  /* GM_CLI_BATCH_EN */
+#if GM_CLI_SHM_EN
+        case 's':
+            shm_name = optarg;
+            break;
+#endif  /* GM_CLI_SHM_EN */
+        default:
+            fprintf(stderr, "usage: %s" GM_CLI_HOST_USAGE_REC GM_CLI_HOST_USAGE_BATCH
+                    GM_CLI_HOST_USAGE_SHM "\n", argv[0]);
+            return 2;
+        }
+    }
+#if GM_CLI_REC_EN
+    if (replay_path != NULL)
+    {
+        return gm_cli_host_replay(replay_path, realtime);
+    }
+#endif  /* GM_CLI_REC_EN */
+
+    if (isatty(STDIN_FILENO) && (tcgetattr(STDIN_FILENO, &gm_cli_host_tio) == 0))
+    {
+        tty = 1;
+        /* 终端切换为原始模式，由CLI自己回显和编辑 */
+        tio = gm_cli_host_tio;
+        cfmakeraw(&tio);
+        tio.c_oflag |= OPOST;
+        tcsetattr(STDIN_FILENO, TCSANOW, &tio);
+        atexit(gm_cli_host_restore_tty);
+    }
+
+    gm_cli_mgr_init();
+    gm_cli_set_out_char_cb(gm_cli_host_out_char);
+    gm_cli_set_out_buf_cb(gm_cli_host_out_buf);
+    gm_cli_set_tick_cb(gm_cli_host_tick);
+#if GM_CLI_CALL_EN
+    gm_cli_set_sym_table(gm_cli_host_syms, sizeof(gm_cli_host_syms) / sizeof(gm_cli_host_syms[0]));
+#endif  /* GM_CLI_CALL_EN */
+#if GM_CLI_BUDGET_EN
+    /* 批量执行中的命令也由看门狗线程检查预算和Ctrl-C */
+    gm_cli_host_tty = tty;
+    if (pthread_create(&wdog, NULL, gm_cli_host_watchdog, NULL) == 0)
+    {
+        pthread_detach(wdog);
+    }
+#endif  /* GM_CLI_BUDGET_EN */
+#if GM_CLI_BATCH_EN
+    if (batch_path != NULL)
+    {
+        return gm_cli_host_batch(batch_path, threads);
+    }
+#endif  /* GM_CLI_BATCH_EN */
+#if GM_CLI_SHM_EN
+    if (shm_name != NULL)
+    {
+        return gm_cli_host_shm(shm_name);
+    }
+#endif  /* GM_CLI_SHM_EN */
+#if GM_CLI_REC_EN
+    if (rec_path != NULL)
+    {
+        gm_cli_host_rec_file = fopen(rec_path, "wb");
+        if (gm_cli_host_rec_file == NULL)
+        {
+            perror(rec_path);
+            return 2;
+        }
+        gm_cli_rec_start(gm_cli_host_rec_write);
+    }
+#endif  /* GM_CLI_REC_EN */
+    gm_cli_start();
+
+    pfd.fd = STDIN_FILENO;
+    pfd.events = POLLIN;
+    while (run)
+    {
+        len = 0;
+#if GM_CLI_BUDGET_EN
+        /* 先处理命令执行期间看门狗线程读到的输入 */
+        pthread_mutex_lock(&gm_cli_host_in_lock);
+        memcpy(buf, gm_cli_host_pend, gm_cli_host_pend_len);
+        len = (ssize_t)gm_cli_host_pend_len;
+        gm_cli_host_pend_len = 0;
+        pthread_mutex_unlock(&gm_cli_host_in_lock);
+#endif  /* GM_CLI_BUDGET_EN */
+        /* 等待输入的同时按节拍执行后台处理，等待时不持有锁 */
+        if ((len == 0) && (poll(&pfd, 1, 10) > 0) && (pfd.revents != 0))
+        {
+#if GM_CLI_BUDGET_EN
+            pthread_mutex_lock(&gm_cli_host_in_lock);
+#endif  /* GM_CLI_BUDGET_EN */
+            len = read(STDIN_FILENO, buf, sizeof(buf));
+#if GM_CLI_BUDGET_EN
+            pthread_mutex_unlock(&gm_cli_host_in_lock);
+#endif  /* GM_CLI_BUDGET_EN */
+            if (len <= 0)
+            {
+                len = 0;
+                run = 0;
+            }
+        }
+        for (i = 0; i < len; i++)
+        {
+            /* 终端下Ctrl+D退出，管道输入可能是二进制帧，读到结束才退出 */
+            if (tty && (buf[i] == (char)0x04))
+            {
+                gm_cli_put_str("\r\n");
+                run = 0;
+                break;
+            }
+            gm_cli_parse_char(buf[i]);
+        }
+        gm_cli_poll();
+    }
+
+    /* 退出前关闭终端的括号粘贴模式 */
+    gm_cli_stop();
+#if GM_CLI_REC_EN
+    if (gm_cli_host_rec_file != NULL)
+    {
+        gm_cli_rec_stop();
+        fclose(gm_cli_host_rec_file);
+    }
+#endif  /* GM_CLI_REC_EN */
+    return 0;
+}
@@ -0,0 +1,435 @@
+/*******************************************************************************
+** 文件名称：gm_cli_latency.c
+** 文件作用：通过伪终端测试CLI宿主程序的交互延时
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：在伪终端上运行宿主程序，模拟终端逐个按键输入，测量按键到回显、回车到
+**           提示符、Tab补全和上键调出历史命令的延时，输出延时分布，只支持Linux
+**
+**           编译方法（在仓库根目录执行）：
+**           gcc -O2 -o gm_cli_latency tools/gm_cli_latency.c
+**
+**           gm_cli_latency ./gm_cli_host                   测试一个宿主程序
+**           gm_cli_latency -b 0,115200,9600 ./gm_cli_host  模拟不同波特率的串口
+**           gm_cli_latency ./gm_cli_host ./gm_cli_host1024 比较不同命令表大小，
+**                                                          宿主程序编译时用
+**                                                          GM_CLI_HOST_FILL_CMDS
+**                                                          增加填充命令
+**
+**           每轮先输入命令的前几个字符，按Tab补全命令名，再输入剩余字符并回车，
+**           然后按上键调出这条命令再回车，-n为轮数，-c为命令，-t为按Tab前输入的
+**           字符数，-P为提示符，宿主程序参数以shell命令行执行
+**
+**           模拟串口时按键按每字节10位的时间延迟发送，收到的数据按同样的速率
+**           排队，延时以最后一个需要的字节接收完成的时间计算，0为不限速
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     ANSI C Language(C99)
+*******************************************************************************/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif  /* _GNU_SOURCE */
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "unistd.h"
+#include "fcntl.h"
+#include "poll.h"
+#include "signal.h"
+#include "time.h"
+#include "sys/wait.h"
+
+/* 等待输出的超时时间，单位ms */
+#define GM_CLI_LAT_TIMEOUT      5000
+/* 接收缓存大小 */
+#define GM_CLI_LAT_BUF_SIZE     65536u
+/* 最多测试的波特率个数 */
+#define GM_CLI_LAT_BAUD_MAX     8
+
+/* 延时种类 */
+enum
+{
+    GM_CLI_LAT_KEY,             /* 按键到回显 */
+    GM_CLI_LAT_ENTER,           /* 回车到提示符 */
+    GM_CLI_LAT_TAB,             /* Tab到补全的命令名 */
+    GM_CLI_LAT_HIST,            /* 上键到历史命令 */
+    GM_CLI_LAT_NUM,
+};
+
+static const char* const gm_cli_lat_name[GM_CLI_LAT_NUM] = { "key", "enter", "tab", "history" };
+
+/* 延时样本 */
+typedef struct
+{
+    double*       p_us;         /* 样本，单位us */
+    unsigned long num;          /* 样本数 */
+    unsigned long size;         /* 样本空间大小 */
+} gm_cli_lat_stat_t;
+
+/* 测试会话 */
+typedef struct
+{
+    int               fd;                       /* 伪终端主设备 */
+    pid_t             pid;                      /* 宿主进程 */
+    double            byte_us;                  /* 每字节传输时间，0为不限速 */
+    double            busy_us;                  /* 模拟串口接收完已收数据的时间 */
+    unsigned long     len;                      /* 接收缓存中的数据长度 */
+    char              buf[GM_CLI_LAT_BUF_SIZE]; /* 接收缓存 */
+    gm_cli_lat_stat_t stat[GM_CLI_LAT_NUM];     /* 各种延时的样本 */
+} gm_cli_lat_t;
+
+/* 当前时间，单位us */
+static double gm_cli_lat_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+/* 等待到指定时间 */
+static void gm_cli_lat_sleep_until(const double us)
+{
+    struct timespec ts;
+    double left = us - gm_cli_lat_now();
+
+    if (left > 0)
+    {
+        ts.tv_sec = (time_t)(left / 1e6);
+        ts.tv_nsec = (long)((left - (double)ts.tv_sec * 1e6) * 1e3);
+        nanosleep(&ts, NULL);
+    }
+}
+
+/* 增加一个样本 */
+static void gm_cli_lat_add(gm_cli_lat_stat_t* const p_stat, const double us)
+{
+    if (p_stat->num == p_stat->size)
+    {
+        p_stat->size = p_stat->size * 2 + 256;
+        p_stat->p_us = realloc(p_stat->p_us, p_stat->size * sizeof(double));
+        if (p_stat->p_us == NULL)
+        {
+            exit(2);
+        }
+    }
+    p_stat->p_us[p_stat->num++] = us;
+}
+
+/* 样本排序比较 */
+static int gm_cli_lat_cmp(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+
+    return (x > y) - (x < y);
+}
+
+/* 在伪终端上启动宿主程序，返回：0 - 成功，-1 - 失败 */
+static int gm_cli_lat_spawn(gm_cli_lat_t* const p_lat, const char* const cmd)
+{
+    const char* slave;
+    int fd;
+
+    p_lat->fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((p_lat->fd < 0) || (grantpt(p_lat->fd) != 0) || (unlockpt(p_lat->fd) != 0) ||
+        ((slave = ptsname(p_lat->fd)) == NULL))
+    {
+        perror("pty");
+        return -1;
+    }
+    p_lat->pid = fork();
+    if (p_lat->pid < 0)
+    {
+        perror("fork");
+        return -1;
+    }
+    if (p_lat->pid == 0)
+    {
+        /* 子进程以伪终端从设备为控制终端和标准输入输出 */
+        setsid();
+        fd = open(slave, O_RDWR);
+        if (fd < 0)
+        {
+            _exit(127);
+        }
+        dup2(fd, STDIN_FILENO);
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        close(p_lat->fd);
+        execl("/bin/sh", "sh", "-c", cmd, (char*)NULL);
+        _exit(127);
+    }
+    return 0;
+}
+
+/* 结束宿主程序，先发送Ctrl-D，超时后强制结束 */
+static void gm_cli_lat_stop(gm_cli_lat_t* const p_lat)
+{
+    int i;
+
+    if (write(p_lat->fd, "\x04", 1) != 1)
+    {
+        kill(p_lat->pid, SIGKILL);
+    }
+    for (i = 0; (i < 100) && (waitpid(p_lat->pid, NULL, WNOHANG) == 0); i++)
+    {
+        gm_cli_lat_sleep_until(gm_cli_lat_now() + 10000);
+    }
+    if (i == 100)
+    {
+        kill(p_lat->pid, SIGKILL);
+        waitpid(p_lat->pid, NULL, 0);
+    }
+    close(p_lat->fd);
+}
+
+/* 模拟按键，等上一次的输出接收完后开始发送，返回按键时间 */
+static double gm_cli_lat_send(gm_cli_lat_t* const p_lat, const char* const keys)
+{
+    size_t len = strlen(keys);
+    double t0;
+
+    gm_cli_lat_sleep_until(p_lat->busy_us);
+    t0 = gm_cli_lat_now();
+    gm_cli_lat_sleep_until(t0 + p_lat->byte_us * (double)len);
+    if (write(p_lat->fd, keys, len) != (ssize_t)len)
+    {
+        return -1;
+    }
+    /* 只在新的输出中查找 */
+    p_lat->len = 0;
+    return t0;
+}
+
+/* 等待输出中出现指定内容，返回内容接收完成的时间，超时返回-1 */
+static double gm_cli_lat_wait(gm_cli_lat_t* const p_lat, const char* const expect)
+{
+    size_t exp_len = strlen(expect);
+    double deadline = gm_cli_lat_now() + GM_CLI_LAT_TIMEOUT * 1e3;
+    double start, now;
+    struct pollfd pfd;
+    unsigned long from;
+    ssize_t ret;
+    char* p;
+
+    pfd.fd = p_lat->fd;
+    pfd.events = POLLIN;
+    while ((now = gm_cli_lat_now()) < deadline)
+    {
+        if (poll(&pfd, 1, (int)((deadline - now) / 1e3) + 1) <= 0)
+        {
+            continue;
+        }
+        /* 缓存快满时只保留末尾，匹配内容不会超过这个长度 */
+        if (p_lat->len > GM_CLI_LAT_BUF_SIZE / 2)
+        {
+            memmove(p_lat->buf, &p_lat->buf[p_lat->len - 4096], 4096);
+            p_lat->len = 4096;
+        }
+        ret = read(p_lat->fd, &p_lat->buf[p_lat->len], GM_CLI_LAT_BUF_SIZE - p_lat->len - 1);
+        if (ret <= 0)
+        {
+            return -1;
+        }
+        now = gm_cli_lat_now();
+        start = (now > p_lat->busy_us) ? now : p_lat->busy_us;
+        from = p_lat->len;
+        p_lat->len += (unsigned long)ret;
+        p_lat->buf[p_lat->len] = '\0';
+        p_lat->busy_us = start + p_lat->byte_us * (double)ret;
+        p = memmem(p_lat->buf, p_lat->len, expect, exp_len);
+        if (p != NULL)
+        {
+            /* 匹配内容之后的字节不计入延时 */
+            return start + p_lat->byte_us * (double)((unsigned long)(p - p_lat->buf) + exp_len - from);
+        }
+    }
+    return -1;
+}
+
+/* 发送按键并等待输出，记录延时，返回：0 - 成功，-1 - 超时 */
+static int gm_cli_lat_step(gm_cli_lat_t* const p_lat, const char* const keys,
+                           const char* const expect, const int kind)
+{
+    double t0 = gm_cli_lat_send(p_lat, keys);
+    double t1 = (t0 < 0) ? -1 : gm_cli_lat_wait(p_lat, expect);
+
+    if (t1 < 0)
+    {
+        fprintf(stderr, "timeout waiting for \"%s\" after sending \"%s\"\n", expect, keys);
+        return -1;
+    }
+    if (kind >= 0)
+    {
+        gm_cli_lat_add(&p_lat->stat[kind], t1 - t0);
+    }
+    return 0;
+}
+
+/* 逐个字符输入，记录回显延时 */
+static int gm_cli_lat_type(gm_cli_lat_t* const p_lat, const char* const text, const size_t len)
+{
+    char key[2] = { 0, 0 };
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        key[0] = text[i];
+        if (gm_cli_lat_step(p_lat, key, key, GM_CLI_LAT_KEY) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* 测试一轮：输入前缀，Tab补全命令名，输入剩余字符回车，再用上键调出回车 */
+static int gm_cli_lat_round(gm_cli_lat_t* const p_lat, const char* const cmd,
+                            const size_t tab_pos, const char* const word,
+                            const char* const prompt)
+{
+    size_t word_len = strlen(word);
+
+    if ((gm_cli_lat_type(p_lat, cmd, tab_pos) != 0) ||
+        ((tab_pos < word_len) && (gm_cli_lat_step(p_lat, "\t", word, GM_CLI_LAT_TAB) != 0)) ||
+        (gm_cli_lat_type(p_lat, &cmd[word_len], strlen(cmd) - word_len) != 0) ||
+        (gm_cli_lat_step(p_lat, "\r", prompt, GM_CLI_LAT_ENTER) != 0) ||
+        (gm_cli_lat_step(p_lat, "\x1b[A", cmd, GM_CLI_LAT_HIST) != 0) ||
+        (gm_cli_lat_step(p_lat, "\r", prompt, GM_CLI_LAT_ENTER) != 0))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/* 输出延时分布 */
+static void gm_cli_lat_report(gm_cli_lat_t* const p_lat, const char* const host, const long baud)
+{
+    gm_cli_lat_stat_t* p_stat;
+    double sum;
+    unsigned long i;
+    int k;
+
+    printf("%s, baud %s", host, (baud > 0) ? "" : "unlimited");
+    if (baud > 0)
+    {
+        printf("%ld", baud);
+    }
+    printf("\n%-10s %8s %10s %10s %10s %10s %10s (us)\n",
+           "", "samples", "p50", "p90", "p99", "max", "mean");
+    for (k = 0; k < GM_CLI_LAT_NUM; k++)
+    {
+        p_stat = &p_lat->stat[k];
+        if (p_stat->num == 0)
+        {
+            continue;
+        }
+        qsort(p_stat->p_us, p_stat->num, sizeof(double), gm_cli_lat_cmp);
+        for (i = 0, sum = 0; i < p_stat->num; i++)
+        {
+            sum += p_stat->p_us[i];
+        }
+        printf("%-10s %8lu %10.1f %10.1f %10.1f %10.1f %10.1f\n", gm_cli_lat_name[k], p_stat->num,
+               p_stat->p_us[p_stat->num * 50 / 100], p_stat->p_us[p_stat->num * 90 / 100],
+               p_stat->p_us[p_stat->num * 99 / 100], p_stat->p_us[p_stat->num - 1],
+               sum / (double)p_stat->num);
+        free(p_stat->p_us);
+        p_stat->p_us = NULL;
+        p_stat->num = 0;
+        p_stat->size = 0;
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    static gm_cli_lat_t lat;
+    const char* cmd = "test 1 2";
+    const char* prompt = "[CLI] > ";
+    char word[64];
+    char* p_baud;
+    long baud[GM_CLI_LAT_BAUD_MAX] = { 0 };
+    unsigned long rounds = 100, i;
+    size_t tab_pos = 2;
+    int baud_num = 1, opt, code = 0, h, b;
+
+    while ((opt = getopt(argc, argv, "n:b:c:t:P:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            rounds = strtoul(optarg, NULL, 0);
+            break;
+        case 'b':
+            for (baud_num = 0, p_baud = strtok(optarg, ",");
+                 (p_baud != NULL) && (baud_num < GM_CLI_LAT_BAUD_MAX);
+                 p_baud = strtok(NULL, ","))
+            {
+                baud[baud_num++] = strtol(p_baud, NULL, 0);
+            }
+            break;
+        case 'c':
+            cmd = optarg;
+            break;
+        case 't':
+            tab_pos = strtoul(optarg, NULL, 0);
+            break;
+        case 'P':
+            prompt = optarg;
+            break;
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+    if ((optind >= argc) || (baud_num == 0) || (cmd[0] == '\0'))
+    {
+        fprintf(stderr, "usage: %s [-n rounds] [-b baud[,baud...]] [-c cmd] [-t tab-pos] "
+                "[-P prompt] host-cmd...\n", argv[0]);
+        return 2;
+    }
+
+    /* 命令名，按Tab前最多输入到命令名结束 */
+    snprintf(word, sizeof(word), "%.*s", (int)strcspn(cmd, " "), cmd);
+    tab_pos = (tab_pos > strlen(word)) ? strlen(word) : tab_pos;
+
+    for (h = optind; (h < argc) && (code == 0); h++)
+    {
+        for (b = 0; (b < baud_num) && (code == 0); b++)
+        {
+            memset(&lat, 0, sizeof(lat));
+            lat.byte_us = (baud[b] > 0) ? 10e6 / (double)baud[b] : 0;
+            if (gm_cli_lat_spawn(&lat, argv[h]) != 0)
+            {
+                return 2;
+            }
+            /* 等待启动后的第一个提示符 */
+            if (gm_cli_lat_wait(&lat, prompt) < 0)
+            {
+                fprintf(stderr, "%s: no prompt \"%s\"\n", argv[h], prompt);
+                code = 2;
+            }
+            for (i = 0; (i < rounds) && (code == 0); i++)
+            {
+                if (gm_cli_lat_round(&lat, cmd, tab_pos, word, prompt) != 0)
+                {
+                    code = 1;
+                }
+            }
+            gm_cli_lat_stop(&lat);
+            if (code == 0)
+            {
+                gm_cli_lat_report(&lat, argv[h], baud[b]);
+            }
+        }
+    }
+    return code;
+}
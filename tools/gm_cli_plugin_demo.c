@@ -0,0 +1,82 @@
+/*******************************************************************************
+** 文件名称：gm_cli_plugin_demo.c
+** 文件作用：CLI命令插件示例
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：编译为共享库后由GM_CLI_PLUGIN_EN为1的宿主程序用plugin命令加载，
+**           插件中调用的CLI接口由宿主程序导出，插件不链接gm_cli.c
+**
+**           命令表方式（在仓库根目录执行）：
+**           gcc -O2 -I. -shared -fPIC -o demo.so tools/gm_cli_plugin_demo.c
+**
+**           段方式，命令用GM_CLI_CMD_EXPORT导出：
+**           gcc -O2 -I. -shared -fPIC -DGM_CLI_CMD_REG_BY_CC_SECTION=1 \
+**               -o demo.so tools/gm_cli_plugin_demo.c
+**
+**           加载和卸载：
+**           plugin load ./demo.so
+**           plugin unload 1
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**           2026-10-19 -> 消除未使用参数的警告
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     ANSI C Language(C99)
+*******************************************************************************/
+
+#include "gm_cli.h"
+#include "stdlib.h"
+
+/* 命令-hello */
+static int plugin_cmd_hello(int argc, char* argv[])
+{
+    (void)argv;
+    gm_cli_printf("hello from plugin, %d args\r\n", argc - 1);
+    return 0;
+}
+
+/* 命令-sum */
+static int plugin_cmd_sum(int argc, char* argv[])
+{
+    long sum = 0;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        sum += strtol(argv[i], NULL, 0);
+    }
+    gm_cli_printf("%ld\r\n", sum);
+    return 0;
+}
+
+#if GM_CLI_CMD_REG_BY_CC_SECTION
+/* 段方式导出命令 */
+GM_CLI_CMD_EXPORT(hello, "hello -- print a greeting from the plugin", plugin_cmd_hello);
+GM_CLI_CMD_EXPORT(sum, "sum [num ...] -- print the sum of the numbers", plugin_cmd_sum);
+/* 导出段的起止位置 */
+GM_CLI_PLUGIN_SECTION_EXPORT();
+#else
+/* 插件导出的命令表，以name为NULL结束 */
+const gm_cli_cmd_t gm_cli_plugin_cmds[] =
+{
+    {
+        .name  = "hello",
+        .usage = "hello -- print a greeting from the plugin",
+        .cb    = plugin_cmd_hello,
+        .link  = NULL,
+    },
+    {
+        .name  = "sum",
+        .usage = "sum [num ...] -- print the sum of the numbers",
+        .cb    = plugin_cmd_sum,
+        .link  = NULL,
+    },
+    {
+        .name  = NULL,
+    },
+};
+#endif  /* GM_CLI_CMD_REG_BY_CC_SECTION */
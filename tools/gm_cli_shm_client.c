@@ -0,0 +1,180 @@
+/*******************************************************************************
+** 文件名称：gm_cli_shm_client.c
+** 文件作用：共享内存控制通道客户端
+** 编写作者：Tom Free 付瑞彪
+** 编写时间：2026-10-19
+** 文件备注：通过gm_cli_shm.h连接GM_CLI_SHM_EN为1的服务端，如gm_cli_host -s，
+**           不需要链接gm_cli.c
+**
+**           编译方法（在仓库根目录执行）：
+**           gcc -O2 -I. -o gm_cli_shm_client tools/gm_cli_shm_client.c
+**
+**           gm_cli_shm_client /gm_cli test 1 2          执行一条命令，输出结果
+**           gm_cli_shm_client /gm_cli < script.txt      连续提交每行命令，按顺序输出
+**           gm_cli_shm_client -n 100000 /gm_cli test    性能测试，输出每秒命令数，
+**                                                       -w为同时提交的最大命令数，
+**                                                       -w 1时输出往返延时
+**
+**           退出码：0 - 全部成功，1 - 有命令返回值不为0，2 - 有命令未执行或超时
+**
+** 更新记录：
+**           2026-10-19 -> 创建文件
+**                                                             <Tom Free 付瑞彪>
+**
+**              Copyright (c) 2018-2021 付瑞彪 All Rights Reserved
+**
+**       1 Tab == 4 Spaces     UTF-8     ANSI C Language(C99)
+*******************************************************************************/
+
+#include "gm_cli_shm.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+/* 等待应答的超时时间，单位ms */
+#define GM_CLI_SHM_CLIENT_TIMEOUT   5000u
+
+/* 取出一条应答，输出到标准输出，返回退出码 */
+static int gm_cli_shm_client_take(gm_cli_shm_client_t* const p_cli, const int print)
+{
+    const gm_cli_shm_rec_t* p_rec = gm_cli_shm_client_reply(p_cli, GM_CLI_SHM_CLIENT_TIMEOUT);
+    int code;
+
+    if (p_rec == NULL)
+    {
+        fprintf(stderr, "shm: reply timeout\n");
+        return 2;
+    }
+    if (print)
+    {
+        fwrite(p_rec + 1, 1, p_rec->len, stdout);
+        if (p_rec->flags & GM_CLI_SHM_FLAG_TRUNC)
+        {
+            fputs("... [output truncated]\r\n", stdout);
+        }
+    }
+    code = (p_rec->flags & GM_CLI_SHM_FLAG_FAIL) ? 2 : (p_rec->ret != 0);
+    gm_cli_shm_client_release(p_cli, p_rec);
+    return code;
+}
+
+/* 提交一条命令，请求缓存满时先取出应答，inflight为已提交未取出的命令数，返回退出码 */
+static int gm_cli_shm_client_put(gm_cli_shm_client_t* const p_cli, const char* const line,
+                                 const unsigned int window, unsigned int* const p_inflight,
+                                 const int print)
+{
+    uint32_t len = (uint32_t)strlen(line);
+    int code = 0, ret;
+
+    while ((*p_inflight >= window) || (gm_cli_shm_client_submit(p_cli, line, len) < 0))
+    {
+        if (*p_inflight == 0)
+        {
+            fprintf(stderr, "shm: line too long\n");
+            return 2;
+        }
+        ret = gm_cli_shm_client_take(p_cli, print);
+        (*p_inflight)--;
+        code = (ret > code) ? ret : code;
+    }
+    (*p_inflight)++;
+    return code;
+}
+
+int main(int argc, char* argv[])
+{
+    gm_cli_shm_client_t cli;
+    struct timespec t0, t1;
+    char line[4096];
+    unsigned long count = 0, i;
+    unsigned int window = 0xFFFFFFFFu, inflight = 0;
+    size_t len;
+    double ms;
+    int opt, code = 0, ret;
+
+    while ((opt = getopt(argc, argv, "n:w:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            count = strtoul(optarg, NULL, 0);
+            break;
+        case 'w':
+            window = (unsigned int)strtoul(optarg, NULL, 0);
+            window = (window == 0) ? 1 : window;
+            break;
+        default:
+            optind = argc;
+            break;
+        }
+    }
+    if ((optind >= argc) || ((count > 0) && (optind + 1 >= argc)))
+    {
+        fprintf(stderr, "usage: %s [-n count [-w window]] shm-name [cmd [args]]\n", argv[0]);
+        return 2;
+    }
+    if (gm_cli_shm_client_open(&cli, argv[optind]) != 0)
+    {
+        perror(argv[optind]);
+        return 2;
+    }
+
+    /* 命令行中的命令，以空格连接 */
+    line[0] = '\0';
+    for (i = (unsigned long)optind + 1; i < (unsigned long)argc; i++)
+    {
+        len = strlen(line);
+        snprintf(&line[len], sizeof(line) - len, "%s%s", (len > 0) ? " " : "", argv[i]);
+    }
+
+    if (count > 0)
+    {
+        /* 性能测试，丢弃输出 */
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (i = 0; (i < count) && (code < 2); i++)
+        {
+            ret = gm_cli_shm_client_put(&cli, line, window, &inflight, 0);
+            code = (ret > code) ? ret : code;
+        }
+        for (; inflight > 0; inflight--)
+        {
+            ret = gm_cli_shm_client_take(&cli, 0);
+            code = (ret > code) ? ret : code;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ms = (double)(t1.tv_sec - t0.tv_sec) * 1e3 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e6;
+        fprintf(stderr, "%lu commands in %.3f ms, %.0f commands/s", i, ms, (double)i * 1e3 / ms);
+        if (window == 1)
+        {
+            fprintf(stderr, ", round trip %.2f us", ms * 1e3 / (double)i);
+        }
+        fprintf(stderr, "\n");
+    }
+    else if (line[0] != '\0')
+    {
+        ret = gm_cli_shm_client_put(&cli, line, window, &inflight, 1);
+        code = gm_cli_shm_client_take(&cli, 1);
+        code = (ret > code) ? ret : code;
+    }
+    else
+    {
+        /* 标准输入的每行一条命令，连续提交，应答按顺序输出 */
+        while (fgets(line, sizeof(line), stdin) != NULL)
+        {
+            line[strcspn(line, "\r\n")] = '\0';
+            if (line[0] == '\0')
+            {
+                continue;
+            }
+            ret = gm_cli_shm_client_put(&cli, line, window, &inflight, 1);
+            code = (ret > code) ? ret : code;
+        }
+        for (; inflight > 0; inflight--)
+        {
+            ret = gm_cli_shm_client_take(&cli, 1);
+            code = (ret > code) ? ret : code;
+        }
+    }
+
+    gm_cli_shm_client_close(&cli);
+    return code;
+}
@@ -0,0 +1,88 @@
+#!/bin/sh
+# -*- coding: utf-8 -*-
+#
+# GM_CLI资源占用统计，以默认配置为基准，逐个打开可选功能，统计RAM和ROM的增量
+#
+# ROM = text + data，RAM = data + bss，按目标文件统计，不含栈和C库，
+# 打印缓存为0时不再链接C库的格式化函数，实际节省的ROM比表中更多
+#
+# 使用范例：
+#     # 本机GCC
+#     sh tools/gm_cli_size_report.sh
+#     # 交叉编译，额外的编译选项放在CFLAGS中
+#     CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size \
+#         CFLAGS="-mcpu=cortex-m0 -mthumb" sh tools/gm_cli_size_report.sh
+
+CC=${CC:-gcc}
+SIZE=${SIZE:-size}
+CFLAGS=${CFLAGS:-}
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# 编译一种配置，输出"ROM RAM"
+measure()
+{
+    # shellcheck disable=SC2086
+    if ! $CC -std=c99 -Os -ffunction-sections -fdata-sections $CFLAGS -I"$ROOT" \
+             "$@" -c "$ROOT/gm_cli.c" -o "$TMP/gm_cli.o" 2>"$TMP/err"; then
+        echo "- -"
+        return
+    fi
+    $SIZE "$TMP/gm_cli.o" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+}
+
+# 输出一行，参数：名称 ROM RAM
+row()
+{
+    if [ "$2" = "-" ]; then
+        printf "%-36s %8s %8s %8s %8s\n" "$1" "-" "-" "-" "-"
+    else
+        printf "%-36s %8d %8d %+8d %+8d\n" "$1" "$2" "$3" \
+               $(($2 - BASE_ROM)) $(($3 - BASE_RAM))
+    fi
+}
+
+set -- $(measure)
+BASE_ROM=$1
+BASE_RAM=$2
+
+printf "%-36s %8s %8s %8s %8s\n" "config" "ROM" "RAM" "+ROM" "+RAM"
+row "default" "$BASE_ROM" "$BASE_RAM"
+# shellcheck disable=SC2046
+row "GM_CLI_PROFILE_COMPACT" $(measure -DGM_CLI_PROFILE_COMPACT=1u)
+
+# 在默认配置上单独打开的功能
+for opt in \
+    GM_CLI_PRINTF_BUF_MAX=0u \
+    GM_CLI_PACKED_EN=1u \
+    GM_CLI_CMD_INDEX_SIZE=64u \
+    GM_CLI_PIPE_EN=1u \
+    GM_CLI_REDIRECT_EN=1u \
+    GM_CLI_BRACKETED_PASTE_EN=1u \
+    GM_CLI_BIN_EN=1u \
+    GM_CLI_EMIT_EN=1u \
+    GM_CLI_CACHE_EN=1u \
+    GM_CLI_WATCH_EN=1u \
+    GM_CLI_SUGGEST_EN=1u \
+    GM_CLI_LOG_EN=1u \
+    GM_CLI_OUT_SCHED_EN=1u \
+    GM_CLI_REC_EN=1u \
+    GM_CLI_BUDGET_EN=1u \
+    GM_CLI_BATCH_EN=1u \
+    GM_CLI_ALIAS_EN=1u \
+    GM_CLI_SESSION_EN=1u \
+    GM_CLI_VAR_EN=1u \
+    GM_CLI_LOOP_EN=1u \
+    GM_CLI_MEM_EN=1u \
+    GM_CLI_PLUGIN_EN=1u \
+    GM_CLI_SHM_EN=1u \
+    GM_CLI_CALL_EN=1u
+do
+    # shellcheck disable=SC2046
+    row "+$opt" $(measure -D$opt)
+done
+
+# shellcheck disable=SC2046
+row "GM_CLI_PROFILE_FULL" $(measure -DGM_CLI_PROFILE_FULL=1u)
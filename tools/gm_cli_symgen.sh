@@ -0,0 +1,83 @@
+#!/bin/sh
+# -*- coding: utf-8 -*-
+#
+# 生成call命令使用的函数符号表，从目标文件中取出全局函数，按名称排序后输出C文件，
+# gm_cli_开头的函数和main不放入符号表
+#
+# 函数原型文件每行一个原型，如"int add(int a, int b);"，括号前的最后一个单词为函数名，
+# 有原型的函数在call -l中显示原型，原型以"void "开头时call不显示返回值
+#
+# 使用范例：
+#     sh tools/gm_cli_symgen.sh app.o drv.o > gm_cli_syms.c
+#     sh tools/gm_cli_symgen.sh -p protos.txt app.o drv.o > gm_cli_syms.c
+#     # 交叉编译
+#     NM=arm-none-eabi-nm sh tools/gm_cli_symgen.sh app.o > gm_cli_syms.c
+#
+# 生成的文件和其他文件一起编译链接，gm_cli_mgr_init之后设置：
+#     gm_cli_set_sym_table(gm_cli_sym_table, gm_cli_sym_num);
+# 生成的文件只取函数地址，声明的类型和函数实际的原型无关，和C库函数同名时
+# 编译器可能提示类型冲突，可以加-fno-builtin编译
+
+NM=${NM:-nm}
+PROTO=/dev/null
+
+if [ "$1" = "-p" ]; then
+    PROTO=$2
+    shift 2
+fi
+if [ $# -eq 0 ]; then
+    echo "usage: $0 [-p protos.txt] obj..." >&2
+    exit 1
+fi
+
+# 全局函数名，按字节序排序去重，和gm_cli_set_sym_table要求的strcmp顺序一致
+SYMS=$($NM -g --defined-only "$@" | awk 'NF == 3 && $2 == "T" { print $3 }' |
+       grep -v -e '^gm_cli_' -e '^main$' | LC_ALL=C sort -u)
+if [ -z "$SYMS" ]; then
+    echo "$0: no global functions found" >&2
+    exit 1
+fi
+
+echo "$SYMS" | awk -v proto="$PROTO" '
+BEGIN {
+    # 原型按函数名保存，转义引号和反斜杠，去掉末尾的分号
+    while ((getline line < proto) > 0) {
+        p = index(line, "(")
+        if (p == 0) {
+            continue
+        }
+        name = substr(line, 1, p - 1)
+        sub(/[ \t]+$/, "", name)
+        n = split(name, word, /[ \t*]+/)
+        name = word[n]
+        sig = line
+        sub(/[ \t]*;[ \t]*$/, "", sig)
+        gsub(/\\/, "\\\\", sig)
+        gsub(/"/, "\\\"", sig)
+        sigs[name] = sig
+    }
+}
+{
+    syms[NR] = $1
+}
+END {
+    print "/* 由tools/gm_cli_symgen.sh生成，不要手动修改 */"
+    print "#include \"gm_cli.h\""
+    print "#include \"stddef.h\""
+    print ""
+    print "/* 只取函数地址，声明的类型和函数实际的原型无关 */"
+    for (i = 1; i <= NR; i++) {
+        print "extern void " syms[i] "(void);"
+    }
+    print ""
+    print "/* 按名称排序的函数符号表 */"
+    print "const gm_cli_sym_t gm_cli_sym_table[] ="
+    print "{"
+    for (i = 1; i <= NR; i++) {
+        sig = (syms[i] in sigs) ? "\"" sigs[syms[i]] "\"" : "NULL"
+        print "    { \"" syms[i] "\", " syms[i] ", " sig " },"
+    }
+    print "};"
+    print ""
+    print "const unsigned int gm_cli_sym_num = sizeof(gm_cli_sym_table) / sizeof(gm_cli_sym_table[0]);"
+}'
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+GM_CLI内部跟踪转换工具，把trace dump命令的输出转换为时间线
+
+输入每行为：时间戳 类型(B/E/I) 事件名 参数，'#'开头的行为说明，其中带有计数器名称，
+时间戳为计数器的低32位，按回绕处理
+
+输出格式：
+    chrome  - Chrome Trace Event JSON，可用chrome://tracing、Perfetto或speedscope打开
+    folded  - 折叠调用栈格式，每行"char;enter;cmd 自身耗时(ns)"，可用flamegraph.pl生成火焰图
+    summary - 按事件统计次数、总耗时、自身耗时和最大耗时
+
+使用范例：
+    # Linux宿主程序，trace dump的输出重定向到文件后转换，rdtsc按3000MHz换算
+    python3 tools/gm_cli_trace.py --mhz 3000 trace.txt -o trace.json
+    # 串口抓取的日志，输出统计
+    python3 tools/gm_cli_trace.py --mhz 72 --format summary uart.log
+"""
+
+import argparse
+import json
+import sys
+
+
+def parse(lines):
+    """解析dump输出，返回(计数器名称, [(计数, 类型, 事件名, 参数)])，计数已展开回绕"""
+    clock = None
+    events = []
+    base = 0
+    last = None
+    for line in lines:
+        line = line.strip()
+        if not line:
+            continue
+        if line.startswith('#'):
+            words = line.split()
+            if 'clock' in words and words.index('clock') + 1 < len(words):
+                clock = words[words.index('clock') + 1]
+            continue
+        words = line.split()
+        if len(words) != 4 or words[1] not in ('B', 'E', 'I'):
+            # 提示符、命令回显等其他输出
+            continue
+        try:
+            ts = int(words[0])
+            arg = int(words[3])
+        except ValueError:
+            continue
+        if last is not None and ts < last:
+            base += 1 << 32
+        last = ts
+        events.append((base + ts, words[1], words[2], arg))
+    return clock, events
+
+
+def build_spans(events):
+    """把开始和结束事件配对，返回(区间列表, 瞬时事件列表)
+
+    区间为(开始, 结束, 调用栈, 开始参数, 结束参数)，环形缓存覆盖掉开始事件的结束事件
+    直接丢弃，没有结束的区间在最后一个事件处结束
+    """
+    spans = []
+    instants = []
+    stack = []
+    for ts, kind, name, arg in events:
+        if kind == 'B':
+            stack.append((ts, name, arg))
+        elif kind == 'E':
+            if not stack or stack[-1][1] != name:
+                continue
+            begin, _, begin_arg = stack.pop()
+            path = tuple(s[1] for s in stack) + (name,)
+            spans.append((begin, ts, path, begin_arg, arg))
+        else:
+            instants.append((ts, tuple(s[1] for s in stack) + (name,), arg))
+    end = events[-1][0] if events else 0
+    while stack:
+        begin, name, begin_arg = stack.pop()
+        path = tuple(s[1] for s in stack) + (name,)
+        spans.append((begin, end, path, begin_arg, None))
+    spans.sort(key=lambda s: (s[0], -s[1]))
+    return spans, instants
+
+
+def self_times(spans):
+    """计算每个区间扣除子区间后的自身耗时"""
+    result = []
+    for i, (begin, end, path, _, _) in enumerate(spans):
+        child = 0
+        for b, e, p, _, _ in spans[i + 1:]:
+            if b >= end:
+                break
+            if len(p) == len(path) + 1 and p[:-1] == path:
+                child += e - b
+        result.append(end - begin - child)
+    return result
+
+
+def to_chrome(spans, instants, scale, origin):
+    """输出Chrome Trace Event JSON"""
+    out = []
+    for begin, end, path, begin_arg, end_arg in spans:
+        args = {'arg': begin_arg}
+        if end_arg is not None:
+            args['ret'] = end_arg
+        out.append({'name': path[-1], 'ph': 'X', 'pid': 1, 'tid': 1,
+                    'ts': (begin - origin) * scale, 'dur': (end - begin) * scale,
+                    'args': args})
+    for ts, path, arg in instants:
+        out.append({'name': path[-1], 'ph': 'i', 's': 't', 'pid': 1, 'tid': 1,
+                    'ts': (ts - origin) * scale, 'args': {'arg': arg}})
+    return json.dumps({'traceEvents': out, 'displayTimeUnit': 'ns'}, indent=1)
+
+
+def to_folded(spans, scale):
+    """输出折叠调用栈，耗时为自身耗时，单位ns"""
+    total = {}
+    for span, own in zip(spans, self_times(spans)):
+        key = ';'.join(span[2])
+        total[key] = total.get(key, 0) + own
+    return '\n'.join('%s %d' % (k, round(v * scale * 1000)) for k, v in sorted(total.items()))
+
+
+def to_summary(spans, instants, scale):
+    """输出按事件的统计"""
+    stat = {}
+    for span, own in zip(spans, self_times(spans)):
+        name = span[2][-1]
+        dur = span[1] - span[0]
+        s = stat.setdefault(name, [0, 0, 0, 0])
+        s[0] += 1
+        s[1] += dur
+        s[2] += own
+        s[3] = max(s[3], dur)
+    for _, path, _ in instants:
+        stat.setdefault(path[-1], [0, 0, 0, 0])[0] += 1
+    lines = ['%-10s %8s %12s %12s %12s' % ('event', 'count', 'total(us)', 'self(us)', 'max(us)')]
+    for name, s in sorted(stat.items(), key=lambda x: -x[1][1]):
+        lines.append('%-10s %8d %12.2f %12.2f %12.2f' %
+                     (name, s[0], s[1] * scale, s[2] * scale, s[3] * scale))
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='GM_CLI trace dump converter')
+    parser.add_argument('input', nargs='?', help='trace dump输出，默认从标准输入读取')
+    parser.add_argument('-o', '--output', help='输出文件，默认输出到标准输出')
+    parser.add_argument('--format', choices=('chrome', 'folded', 'summary'), default='chrome')
+    parser.add_argument('--mhz', type=float,
+                        help='计数器频率(MHz)，计数器为ms时不需要，未指定时按1MHz换算')
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, encoding='utf-8', errors='replace') as f:
+            clock, events = parse(f)
+    else:
+        clock, events = parse(sys.stdin)
+    if not events:
+        sys.exit('no trace events found')
+
+    # 换算为us
+    if clock == 'ms' and args.mhz is None:
+        scale = 1000.0
+    else:
+        if args.mhz is None:
+            sys.stderr.write('counter "%s" frequency unknown, assuming 1 MHz, use --mhz\n' % clock)
+        scale = 1.0 / (args.mhz or 1.0)
+
+    spans, instants = build_spans(events)
+    if args.format == 'chrome':
+        text = to_chrome(spans, instants, scale, events[0][0])
+    elif args.format == 'folded':
+        text = to_folded(spans, scale)
+    else:
+        text = to_summary(spans, instants, scale)
+
+    if args.output:
+        with open(args.output, 'w', encoding='utf-8') as f:
+            f.write(text + '\n')
+    else:
+        print(text)
+
+
+if __name__ == '__main__':
+    main()